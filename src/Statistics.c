@@ -124,6 +124,31 @@ void add_data( Statistics s, double data_point )
 #endif
 }
 
+void merge_statistics( Statistics target, Statistics source )
+{
+  int n = target->number_of_data_points;
+  int m = source->number_of_data_points;
+  if ( n + m > target->array_size )
+    {
+      target->data = (double *) realloc( target->data,
+                                         (n + m) * sizeof( double ) );
+      target->array_size = n + m;
+    }
+  // merge from the back so that target data can be merged in place
+  int i = n - 1;
+  int j = m - 1;
+  int k = n + m - 1;
+  while ( j >= 0 )
+    {
+      if ( i >= 0 && target->data[i] > source->data[j] )
+        target->data[k--] = target->data[i--];
+      else
+        target->data[k--] = source->data[j--];
+    }
+  target->number_of_data_points = n + m;
+  target->sum += source->sum;
+}
+
 void print_statistics( Statistics s, FILE * output_stream, const char * format )
 {
   fprintf( output_stream, format, get_min(s) );
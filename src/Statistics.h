@@ -37,6 +37,12 @@ double get_standard_deviation( Statistics s );
 int get_number_of_data_points( Statistics s );
 void add_data( Statistics s, double data_point );
 
+/**
+ * Adds all data points of source to target, enlarging target if necessary;
+ * takes time linear in the total number of data points
+ */
+void merge_statistics( Statistics target, Statistics source );
+
 /**
  * Prints statistics in the form (tab separated items)
  *  min median mean max stdev N
@@ -78,7 +78,7 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
   Edgeptr new_edge = (Edgeptr) calloc( 1, sizeof(struct edge_struct) );
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
+  new_edge->fixed_epoch = 0;
 
   // add new edge to master edge list, making room if necessary
   if ( number_of_edges % CAPACITY_INCREMENT == 0 )
@@ -0,0 +1,75 @@
+/**
+ * @file apply_delta.c
+ * @brief Program that applies a delta file, as written by minimization with
+ * the -D option (see delta.h), to the graph it was computed from and prints
+ * the resulting sgf file on standard output.
+ *
+ * The graph file may be in any single-file format that minimization reads:
+ * lff or mlcm if the extension says so, sgf otherwise.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include"defs.h"
+#include"graph_io.h"
+#include"graph.h"
+#include"delta.h"
+
+/**
+ * prints usage message
+ */
+static void printUsage( void ) {
+  printf( "Usage: apply_delta GRAPH_FILE DELTA_FILE\n" );
+  printf( " applies the delta in DELTA_FILE (- for standard input) to the\n" );
+  printf( " graph in GRAPH_FILE and prints the result in sgf format\n" );
+  printf( " on standard output\n");
+}
+
+static FILE * open_or_die( const char * file_name ) {
+  FILE * stream = fopen( file_name, "r" );
+  if ( stream == NULL ) {
+    fprintf(stderr, "*** FATAL ERROR: file %s could not be opened\n", file_name);
+    exit(EXIT_FAILURE);
+  }
+  return stream;
+}
+
+int main( int argc, char * argv[] )
+{
+  if( argc != 3 ) {
+      printUsage();
+      return EXIT_FAILURE;
+  }
+  const char * graph_file_name = argv[1];
+  const char * delta_file_name = argv[2];
+
+  const char * extension = strrchr( graph_file_name, '.' );
+  if ( extension != NULL && strcmp( extension, ".lff" ) == 0 )
+    readLff( graph_file_name );
+  else if ( extension != NULL && strcmp( extension, ".mlcm" ) == 0 )
+    readMlcm( graph_file_name );
+  else {
+    FILE * graph_stream = open_or_die( graph_file_name );
+    readSgf( graph_stream );
+    fclose( graph_stream );
+  }
+
+  if ( strcmp( delta_file_name, "-" ) == 0 )
+    applyDelta( stdin );
+  else {
+    FILE * delta_stream = open_or_die( delta_file_name );
+    applyDelta( delta_stream );
+    fclose( delta_stream );
+  }
+
+  writeSgf( stdout );
+  deallocateGraph();
+  return EXIT_SUCCESS;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,439 @@
+/**
+ * @file bands.c
+ * @brief Implementation of the decomposition of the layers into bands, each
+ * minimized by a separate worker process.
+ *
+ * Messages on the pipes are plain sequences of ints: the node ids of each
+ * layer being sent, in order, layer by layer from the bottom. Both ends know
+ * which layers are sent and how many nodes each has, so no header is needed.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include"graph.h"
+#include"defs.h"
+#include"crossings.h"
+#include"channel.h"
+#include"order.h"
+#include"stats.h"
+#include"heuristics.h"
+#include"tasks.h"
+#include"timing.h"
+#include"bands.h"
+#include"verticality.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<errno.h>
+#include<unistd.h>
+#include<sys/types.h>
+#include<sys/wait.h>
+#include<sys/resource.h>
+
+typedef struct band_struct {
+  /**
+   * layers shared with the band below and the band above in even rounds; in
+   * odd rounds the layer above each is shared instead, except at the bottom
+   * and top of the graph
+   */
+  int lower_boundary;
+  int upper_boundary;
+  /** first and last layer of the graph the band's worker sees */
+  int first_layer;
+  int last_layer;
+  pid_t pid;
+  /** coordinator's ends of the pipes to and from the worker */
+  int to_worker;
+  int from_worker;
+} * Bandptr;
+
+static struct band_struct * bands = NULL;
+
+/**
+ * for each (global) layer, its nodes sorted by id; built before the workers
+ * are created, so that every process has a copy
+ */
+static Nodeptr * * nodes_by_id = NULL;
+
+/**
+ * buffer for the node ids of one layer
+ */
+static int * id_buffer = NULL;
+
+static int compare_node_ids( const void * ptr_i, const void * ptr_j )
+{
+  int id_i = (* (Nodeptr *) ptr_i)->id;
+  int id_j = (* (Nodeptr *) ptr_j)->id;
+  return ( id_i > id_j ) - ( id_i < id_j );
+}
+
+static int compare_id_to_node( const void * key, const void * element )
+{
+  int id = * (const int *) key;
+  int node_id = (* (Nodeptr *) element)->id;
+  return ( id > node_id ) - ( id < node_id );
+}
+
+static void build_id_tables( void )
+{
+  int max_layer_size = 1;
+  nodes_by_id = (Nodeptr * *) calloc( number_of_layers, sizeof(Nodeptr *) );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    int layer_size = layers[layer]->number_of_nodes;
+    if ( layer_size > max_layer_size ) max_layer_size = layer_size;
+    nodes_by_id[layer] = (Nodeptr *) calloc( layer_size + 1, sizeof(Nodeptr) );
+    for ( int position = 0; position < layer_size; position++ )
+      nodes_by_id[layer][position] = layers[layer]->nodes[position];
+    qsort( nodes_by_id[layer], layer_size, sizeof(Nodeptr), compare_node_ids );
+  }
+  id_buffer = (int *) calloc( max_layer_size, sizeof(int) );
+}
+
+static void free_id_tables( int global_layers )
+{
+  for ( int layer = 0; layer < global_layers; layer++ )
+    free( nodes_by_id[layer] );
+  free( nodes_by_id );
+  free( id_buffer );
+  nodes_by_id = NULL;
+  id_buffer = NULL;
+}
+
+static void write_all( int fd, const void * data, size_t size )
+{
+  const char * next = (const char *) data;
+  while ( size > 0 ) {
+    ssize_t written = write( fd, next, size );
+    if ( written < 0 && errno == EINTR ) continue;
+    if ( written <= 0 ) {
+      fprintf( stderr, "*** FATAL ERROR: unable to send layer order"
+               " between bands\n" );
+      exit( EXIT_FAILURE );
+    }
+    next += written;
+    size -= written;
+  }
+}
+
+static void read_all( int fd, void * data, size_t size )
+{
+  char * next = (char *) data;
+  while ( size > 0 ) {
+    ssize_t bytes_read = read( fd, next, size );
+    if ( bytes_read < 0 && errno == EINTR ) continue;
+    if ( bytes_read <= 0 ) {
+      fprintf( stderr, "*** FATAL ERROR: unable to receive layer order"
+               " between bands (did a worker fail?)\n" );
+      exit( EXIT_FAILURE );
+    }
+    next += bytes_read;
+    size -= bytes_read;
+  }
+}
+
+/**
+ * sends the order of a layer of the current graph
+ */
+static void send_layer( int fd, int layer )
+{
+  Layerptr layer_ptr = layers[layer];
+  for ( int position = 0; position < layer_ptr->number_of_nodes; position++ )
+    id_buffer[position] = layer_ptr->nodes[position]->id;
+  write_all( fd, id_buffer, layer_ptr->number_of_nodes * sizeof(int) );
+}
+
+/**
+ * receives the order of a layer of the current graph; global_layer is its
+ * number in the whole graph
+ */
+static void receive_layer( int fd, int layer, int global_layer )
+{
+  Layerptr layer_ptr = layers[layer];
+  int layer_size = layer_ptr->number_of_nodes;
+  read_all( fd, id_buffer, layer_size * sizeof(int) );
+  for ( int position = 0; position < layer_size; position++ ) {
+    Nodeptr * found = (Nodeptr *) bsearch( id_buffer + position,
+                                           nodes_by_id[global_layer],
+                                           layer_size, sizeof(Nodeptr),
+                                           compare_id_to_node );
+    if ( found == NULL ) {
+      fprintf( stderr, "*** FATAL ERROR: node %d is not on layer %d\n",
+               id_buffer[position], global_layer );
+      exit( EXIT_FAILURE );
+    }
+    layer_ptr->nodes[position] = * found;
+    (* found)->position = position;
+  }
+  LAYER_CHANGED( layer );
+}
+
+/**
+ * @return true if the band's worker may move the given layer in the given
+ * round, i.e., the layer lies strictly between the layers the band shares
+ * with its neighbors in that round, or is the bottom or top of the graph
+ */
+static bool band_moves_layer( Bandptr band, int global_layer, int round,
+                              int global_layers )
+{
+  int shift = round % 2;
+  if ( global_layer == 0 && band->lower_boundary == 0 ) return true;
+  if ( global_layer == global_layers - 1
+       && band->upper_boundary == global_layers - 1 )
+    return true;
+  int lowest = band->lower_boundary > 0
+    ? band->lower_boundary + shift : band->lower_boundary;
+  int highest = band->upper_boundary < global_layers - 1
+    ? band->upper_boundary + shift : band->upper_boundary;
+  return lowest < global_layer && global_layer < highest;
+}
+
+static void reinitialize_order( Orderptr order )
+{
+  cleanup_order( order );
+  init_order( order );
+}
+
+/**
+ * Restricts the graph of a worker to the layers first ... last. Edges to
+ * layers outside the range are dropped from the adjacency lists and layers
+ * are renumbered from 0. The data structures of the original graph are
+ * simply abandoned (the worker exits without deallocating them).
+ */
+static void restrict_to_band( int first, int last )
+{
+  deallocateCrossings();
+  deallocateChannels();
+  deallocateNonverticality();
+
+  int band_nodes = 0;
+  int band_edges = 0;
+  for ( int layer = first; layer <= last; layer++ ) {
+    band_nodes += layers[layer]->number_of_nodes;
+    if ( layer > first )
+      for ( int position = 0; position < layers[layer]->number_of_nodes;
+            position++ )
+        band_edges += layers[layer]->nodes[position]->down_degree;
+  }
+
+  Nodeptr * band_node_list = (Nodeptr *) calloc( band_nodes, sizeof(Nodeptr) );
+  Edgeptr * band_edge_list = (Edgeptr *) calloc( band_edges, sizeof(Edgeptr) );
+  int node_index = 0;
+  int edge_index = 0;
+  for ( int layer = first; layer <= last; layer++ ) {
+    for ( int position = 0; position < layers[layer]->number_of_nodes;
+          position++ ) {
+      Nodeptr node = layers[layer]->nodes[position];
+      band_node_list[node_index++] = node;
+      if ( layer == first ) node->down_degree = 0;
+      if ( layer == last ) node->up_degree = 0;
+      for ( int j = 0; j < node->down_degree; j++ )
+        band_edge_list[edge_index++] = node->down_edges[j];
+      node->layer -= first;
+    }
+  }
+
+  master_node_list = band_node_list;
+  master_edge_list = band_edge_list;
+  number_of_nodes = band_nodes;
+  number_of_edges = band_edges;
+  layers += first;
+  number_of_layers = last - first + 1;
+
+  initCrossings();
+  initChannels();
+  reinitialize_order( best_crossings_order );
+  reinitialize_order( best_edge_crossings_order );
+  reinitialize_order( best_total_stretch_order );
+  reinitialize_order( best_bottleneck_stretch_order );
+  reinitialize_order( best_nonverticality_order );
+  reinitialize_order( best_favored_crossings_order );
+}
+
+/**
+ * What a worker process does: rounds of minimizing its band, sending the
+ * layers it moved, and, if the coordinator asks for another round, receiving
+ * the layers its neighbors moved
+ */
+static void run_worker( Bandptr band, int global_layers, int from_coordinator,
+                        int to_coordinator,
+                        void (* heuristic_function)( void ) )
+{
+  int first = band->first_layer;
+  int last = band->last_layer;
+  restrict_to_band( first, last );
+
+  // the coordinator reports progress, writes files and keeps the Pareto
+  // list; workers stay quiet
+  trace_freq = -1;
+  write_files = false;
+  pareto_objective = NO_PARETO;
+
+  for ( int round = 0; round < BAND_EXCHANGE_ROUNDS; round++ ) {
+    for ( int layer = first; layer <= last; layer++ )
+      layers[ layer - first ]->pinned
+        = ! band_moves_layer( band, layer, round, global_layers );
+    init_crossing_stats();
+    updateAllCrossings();
+    iteration = 0;
+    pass = 0;
+    end_of_iteration();
+    heuristic_function();
+    restore_order( best_crossings_order );
+    for ( int layer = first; layer <= last; layer++ )
+      if ( band_moves_layer( band, layer, round, global_layers ) )
+        send_layer( to_coordinator, layer - first );
+    int another_round;
+    read_all( from_coordinator, & another_round, sizeof(int) );
+    if ( ! another_round ) break;
+    for ( int layer = first; layer <= last; layer++ )
+      if ( ! band_moves_layer( band, layer, round, global_layers ) )
+        receive_layer( from_coordinator, layer - first, layer );
+  }
+}
+
+/**
+ * Creates the pipes and worker process for a band
+ */
+static void start_worker( int band_number, int global_layers,
+                          void (* heuristic_function)( void ) )
+{
+  Bandptr band = bands + band_number;
+  int down_pipe[2];             /* coordinator -> worker */
+  int up_pipe[2];               /* worker -> coordinator */
+  if ( pipe( down_pipe ) != 0 || pipe( up_pipe ) != 0 ) {
+    fprintf( stderr, "*** FATAL ERROR: unable to create pipes for band %d\n",
+             band_number );
+    exit( EXIT_FAILURE );
+  }
+  // the child inherits the parent's consumption so far, but its own
+  // user time starts from 0
+  double elapsed = RUNTIME;
+  pid_t pid = fork();
+  if ( pid < 0 ) {
+    fprintf( stderr, "*** FATAL ERROR: unable to create worker for band %d\n",
+             band_number );
+    exit( EXIT_FAILURE );
+  }
+  if ( pid == 0 ) {
+    start_time = getUserSeconds() - elapsed;
+    close( down_pipe[1] );
+    close( up_pipe[0] );
+    for ( int other = 0; other < band_number; other++ ) {
+      close( bands[other].to_worker );
+      close( bands[other].from_worker );
+    }
+    initializeTasks( number_of_threads );
+    run_worker( band, global_layers, down_pipe[0], up_pipe[1],
+                heuristic_function );
+    fflush( NULL );
+    _exit( EXIT_SUCCESS );
+  }
+  close( down_pipe[0] );
+  close( up_pipe[1] );
+  band->pid = pid;
+  band->to_worker = down_pipe[1];
+  band->from_worker = up_pipe[0];
+}
+
+void runBands( int number_of_bands, void (* heuristic_function)( void ) )
+{
+  // every band needs a layer of its own between its boundaries in both
+  // even and odd rounds
+  if ( number_of_bands > ( number_of_layers - 1 ) / 2 )
+    number_of_bands = ( number_of_layers - 1 ) / 2;
+  if ( number_of_bands < 2 ) {
+    heuristic_function();
+    return;
+  }
+
+  int global_layers = number_of_layers;
+  bands = (Bandptr) calloc( number_of_bands, sizeof(struct band_struct) );
+  for ( int band = 0; band < number_of_bands; band++ ) {
+    Bandptr band_ptr = bands + band;
+    band_ptr->lower_boundary = ( global_layers - 1 ) * band / number_of_bands;
+    band_ptr->upper_boundary
+      = ( global_layers - 1 ) * (band + 1) / number_of_bands;
+    band_ptr->first_layer = band_ptr->lower_boundary;
+    band_ptr->last_layer = band_ptr->upper_boundary < global_layers - 1
+      ? band_ptr->upper_boundary + 1 : band_ptr->upper_boundary;
+  }
+  build_id_tables();
+
+  fprintf( stderr, "--- Minimizing %d bands of about %d layers each,"
+           " at most %d rounds\n", number_of_bands,
+           ( global_layers - 1 ) / number_of_bands + 1,
+           BAND_EXCHANGE_ROUNDS );
+
+  // worker threads do not survive fork(); buffered output must not be
+  // written twice
+  fflush( NULL );
+  deallocateTasks();
+  for ( int band = 0; band < number_of_bands; band++ )
+    start_worker( band, global_layers, heuristic_function );
+  initializeTasks( number_of_threads );
+
+  int best_crossings = numberOfCrossings();
+  int rounds_without_improvement = 0;
+  for ( int round = 0; round < BAND_EXCHANGE_ROUNDS; round++ ) {
+    // each layer is moved by at most one band in every round
+    for ( int band = 0; band < number_of_bands; band++ )
+      for ( int layer = bands[band].first_layer;
+            layer <= bands[band].last_layer; layer++ )
+        if ( band_moves_layer( bands + band, layer, round, global_layers ) )
+          receive_layer( bands[band].from_worker, layer, layer );
+    updateAllCrossings();
+    end_of_iteration();
+    fprintf( stderr, "--- band round %d: crossings %d, bottleneck %d\n",
+             round, numberOfCrossings(), maxEdgeCrossings() );
+    tracePrint( -1, "end of band round" );
+    if ( numberOfCrossings() < best_crossings ) {
+      best_crossings = numberOfCrossings();
+      rounds_without_improvement = 0;
+    }
+    else
+      rounds_without_improvement++;
+    // an even and an odd round in a row without improvement means that
+    // neither set of boundaries helps any more
+    int another_round = round < BAND_EXCHANGE_ROUNDS - 1
+      && rounds_without_improvement < 2;
+    for ( int band = 0; band < number_of_bands; band++ )
+      write_all( bands[band].to_worker, & another_round, sizeof(int) );
+    if ( ! another_round ) break;
+    for ( int band = 0; band < number_of_bands; band++ )
+      for ( int layer = bands[band].first_layer;
+            layer <= bands[band].last_layer; layer++ )
+        if ( ! band_moves_layer( bands + band, layer, round, global_layers ) )
+          send_layer( bands[band].to_worker, layer );
+  }
+
+  for ( int band = 0; band < number_of_bands; band++ ) {
+    int status;
+    if ( waitpid( bands[band].pid, & status, 0 ) < 0
+         || ! WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS ) {
+      fprintf( stderr, "*** FATAL ERROR: worker for band %d failed\n", band );
+      exit( EXIT_FAILURE );
+    }
+    close( bands[band].to_worker );
+    close( bands[band].from_worker );
+  }
+
+  // leave the graph with the best assembly, which end_of_iteration() kept;
+  // this may be the order before the first round
+  restore_order( best_crossings_order );
+  updateAllCrossings();
+
+  // the work was done by the workers; count their time as well
+  struct rusage children_usage;
+  getrusage( RUSAGE_CHILDREN, & children_usage );
+  start_time -= children_usage.ru_utime.tv_sec
+    + (double) children_usage.ru_utime.tv_usec / 1000000.0;
+
+  free_id_tables( global_layers );
+  free( bands );
+  bands = NULL;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
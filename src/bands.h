@@ -0,0 +1,48 @@
+/**
+ * @file bands.h
+ * @brief Decomposition of the layers into bands that are minimized by
+ * separate worker processes (-B option).
+ *
+ * The layers are split into contiguous bands of about equal size, each
+ * sharing one layer with the next. Each band is handed to a worker process
+ * (created with fork(), so it starts with a copy of the graph and its
+ * current order), which restricts the graph to the layers of its band. A
+ * shared layer is pinned in both bands: the heuristics count the crossings
+ * of its edges but never change its order. So each channel belongs to
+ * exactly one band and no layer is moved by two workers at once.
+ *
+ * The minimization proceeds in rounds. In each round every worker runs the
+ * heuristic on its band, with the usual termination criteria, and sends the
+ * layers it moved, in their best order, to the coordinator (the original
+ * process) through a pipe; the coordinator assembles the global order and
+ * sends each worker the current orders of the other layers it sees. Since
+ * the workers' changes are independent, the assembled order never has more
+ * crossings than the one before. The shared layers would never move if they
+ * stayed the same, so in odd rounds each one is replaced by the layer above
+ * it; a worker therefore sees one extra layer above its band, pinned in even
+ * rounds. The rounds end after two in a row without fewer crossings, or
+ * after BAND_EXCHANGE_ROUNDS. Orders are sent as sequences of node ids, so
+ * that nothing depends on the memory layout of the processes.
+ *
+ * At the end the coordinator restores the best assembled order, computes its
+ * exact crossings and stretch and updates the best values and orders.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef BANDS_H
+#define BANDS_H
+
+/**
+ * Minimizes with the given heuristic by decomposing the layers into the
+ * given number of bands (reduced to (number_of_layers - 1) / 2 if larger,
+ * so that every band has a layer of its own).
+ * Must be called with the crossings, channels and best orders initialized,
+ * in place of running the heuristic directly.
+ */
+void runBands( int number_of_bands, void (* heuristic_function)( void ) );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -17,6 +17,9 @@
 #include"crossings.h"
 #include"graph_io.h"
 #include"heuristics.h"
+#include"freeze.h"
+#include"tasks.h"
+#include"weights.h"
 
 /**
  * Computes the weight of a node based on the average position of its
@@ -108,81 +111,57 @@ static void balanced_node_weight( Nodeptr node ) {
 
 /**
  * Some nodes may have weight -1 because they have no edges in the
- * desired direction.  This function gives them a weight identical to that of
- * their left neighbor on the layer, or 0 if all nodes to the left have
- * weight -1.
- * Note: If the node to the left has weight -1 originally, its weight will
- * have been changed by the time the node is processed.
+ * desired direction. This function gives them a weight based on their
+ * neighbors on the layer, as specified by adjust_weights: see adjustWeights()
+ * in weights.c.
  *
- * @todo adjust_weights_left() and adjust_weights_avg() have identical
- * counterparts in median.c
+ * @todo median.c has its own versions of the adjustments
  */
-static void adjust_weights_left( int layer )
+static void adjust_layer_weights( int layer )
 {
   Layerptr layerptr = layers[ layer ];
-  int i = 0;
-  for( ; i < layerptr->number_of_nodes; i++ )
+  int num_nodes = layerptr->number_of_nodes;
+  double * weights = (double *) malloc( num_nodes * sizeof(double) );
+  for ( int i = 0; i < num_nodes; i++ )
+    weights[i] = layerptr->nodes[i]->weight;
+  adjustWeights( weights, num_nodes, adjust_weights );
+  for ( int i = 0; i < num_nodes; i++ )
     {
-      Nodeptr node = layerptr->nodes[i];
-      if( node->weight == -1 )
-        {
-          if( i == 0 ) node->weight = 0;
-          else node->weight = layerptr->nodes[i-1]->weight;
+      layerptr->nodes[i]->weight = weights[i];
 #ifdef DEBUG
-          printf("  adjust_weight (left), node = %s, weight = %f\n",
-                 node->name, node->weight );
+      printf("  adjust_weight, node = %s, weight = %f\n",
+             layerptr->nodes[i]->name, weights[i] );
 #endif  
-        }
     }
+  free( weights );
 }
 
 /**
- * Some nodes may have weight -1 because they have no edges in the
- * desired direction.  This function gives them a weight that is the average
- * of that of the two neighbors on the layer - or just the weight of one of
- * the neighbors if the other is absent or also has weight -1.
+ * Layer and orientation for a (possibly parallel) weight computation
  */
-static void adjust_weights_avg( int layer ) {
-  Layerptr layerptr = layers[ layer ];
-  int num_nodes = layerptr->number_of_nodes;
-  for ( int i = 0; i < num_nodes; i++ ) {
-    Nodeptr node = layerptr->nodes[i];
-    double weight = layerptr->nodes[i]->weight; 
-    // Do nothing if node already has a weight
-    if ( weight != -1 ) continue;
+struct weight_context {
+  Layerptr layerptr;
+  Orientation orientation;
+};
 
-    double left_weight = -1;
-    double right_weight = -1;
-    if ( i > 0 ) {
-      left_weight = layerptr->nodes[i-1]->weight;
-    }
-    if ( i < num_nodes - 1 ) {
-      right_weight = layerptr->nodes[i+1]->weight;
-    }
-
-    // if both neighbors are present and have weights, take the
-    // average of their weights
-    if ( left_weight != -1 && right_weight != -1 ) {
-      node->weight = (left_weight + right_weight) / 2;
-    }
-    else if ( left_weight != -1 ) {
-      // only the left neighbor has a weight
-      node->weight = left_weight;
-    }
-    else if ( right_weight != -1 ) {
-      // only the right neighbor has a weight
-      node->weight = right_weight;
-    }
-    else {
-      // neither neighbor has a weight: can propagate from left
-      node->weight = left_weight;
+/**
+ * Computes weights of the nodes in positions first, ..., last - 1; nodes
+ * write only their own weights, so disjoint ranges can be done in parallel
+ */
+static void node_weights( int first, int last, void * context )
+{
+  struct weight_context * weight_context = (struct weight_context *) context;
+  Layerptr layerptr = weight_context->layerptr;
+  Orientation orientation = weight_context->orientation;
+  int i = first;
+  for( ; i < last; i++ )
+    {
+      if ( orientation == BOTH && balanced_weight )
+        balanced_node_weight( layerptr->nodes[i] );
+      else
+        node_weight( layerptr->nodes[i], orientation );
     }
-#ifdef DEBUG
-    printf("  adjust_weight (avg), node = %s, weight = %f\n",
-           node->name, node->weight );
-#endif  
-  } // for nodes on this layer
-} // end, adjust_weights_avg
+}
 
 /**
  * Assigns weights to nodes on the given layer based on positions of their
@@ -196,19 +175,11 @@ void barycenterWeights( int layer, Orientation orientation )
          layer, orientation, balanced_weight );
 #endif  
   Layerptr layerptr = layers[ layer ];
-  int i = 0;
   int num_nodes = layerptr->number_of_nodes;
-  for(i = 0 ; i < num_nodes; i++ )
-    {
-      if ( orientation == BOTH && balanced_weight )
-        balanced_node_weight( layerptr->nodes[i] );
-      else
-        node_weight( layerptr->nodes[i], orientation );
-    }
-  if( adjust_weights == LEFT )
-    adjust_weights_left( layer );
-  else if( adjust_weights == AVG )
-    adjust_weights_avg( layer );
+  struct weight_context context = { layerptr, orientation };
+  parallelFor( 0, num_nodes, NODES_PER_TASK, node_weights, &context );
+  if( adjust_weights != NONE )
+    adjust_layer_weights( layer );
 #ifdef DEBUG
   printf( "<- barycenterWeights\n" );
 #endif  
@@ -219,6 +190,7 @@ bool barycenterUpSweep( int starting_layer )
   int layer = starting_layer;
   for( ; layer < number_of_layers; layer++ )
     {
+      if ( isFrozenLayer( layer ) ) continue;
       barycenterWeights( layer, DOWNWARD );
       layerSort( layer );
       //      layerQuicksort( layer );
@@ -240,6 +212,7 @@ bool barycenterDownSweep( int starting_layer )
   int layer = starting_layer;
   for( ; layer >= 0; layer-- )
     {
+      if ( isFrozenLayer( layer ) ) continue;
       barycenterWeights( layer, UPWARD );
       layerSort( layer );
       //      layerQuicksort( layer );
@@ -252,4 +225,4 @@ bool barycenterDownSweep( int starting_layer )
   return false;
 }
 
-/*  [Last modified: 2019 09 27 at 17:59:03 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
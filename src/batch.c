@@ -0,0 +1,496 @@
+/**
+ * @file batch.c
+ * @brief Implementation of crossing minimization for many tiny graphs at
+ * once.
+ *
+ * All per-node and per-edge information is kept in fixed-size rows of
+ * short integers, so a batch of graphs occupies a single contiguous block
+ * and the heuristics touch nothing else. Crossings between two layers are
+ * counted by comparing all pairs of edges of the channel, which for the
+ * small channels involved is faster than sorting and has no branches in the
+ * inner loop.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include"constants.h"
+#include"batch.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdbool.h>
+
+struct batch_struct {
+  int number_of_graphs;
+
+  // per graph
+  char name[BATCH_CAPACITY][MAX_NAME_LENGTH];
+  int number_of_nodes[BATCH_CAPACITY];
+  int number_of_edges[BATCH_CAPACITY];
+  int number_of_layers[BATCH_CAPACITY];
+  /** NULL if the graph can be solved, otherwise the reason why not */
+  const char * problem[BATCH_CAPACITY];
+  int start_crossings[BATCH_CAPACITY];
+  int crossings[BATCH_CAPACITY];
+
+  // per node, indexed by the order in which the nodes were added
+  int node_id[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short node_layer[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short node_position[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short down_degree[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short up_degree[BATCH_CAPACITY][BATCH_MAX_NODES];
+  /**
+   * index into adjacency of the neighbors of each node: the down_degree
+   * lower neighbors come first, then the up_degree upper neighbors
+   */
+  short adjacency_start[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short adjacency[BATCH_CAPACITY][2 * BATCH_MAX_EDGES];
+
+  /**
+   * the nodes of layer i are order[layer_start[i]], ...,
+   * order[layer_start[i+1] - 1], from left to right
+   */
+  short layer_start[BATCH_CAPACITY][BATCH_MAX_LAYERS + 1];
+  short order[BATCH_CAPACITY][BATCH_MAX_NODES];
+  short best_order[BATCH_CAPACITY][BATCH_MAX_NODES];
+
+  // per edge, as added
+  short edge_lower[BATCH_CAPACITY][BATCH_MAX_EDGES];
+  short edge_upper[BATCH_CAPACITY][BATCH_MAX_EDGES];
+};
+
+static const char * TOO_LARGE = "too large for a batch";
+static const char * BAD_NODE = "a node has a negative layer";
+static const char * BAD_EDGE
+  = "an edge has an unknown endpoint or is not between adjacent layers";
+
+Batchptr newBatch( void )
+{
+  Batchptr batch = (Batchptr) malloc( sizeof(struct batch_struct) );
+  if ( batch == NULL ) {
+    fprintf( stderr, "*** FATAL ERROR: unable to allocate a batch\n" );
+    exit( EXIT_FAILURE );
+  }
+  batch->number_of_graphs = 0;
+  return batch;
+}
+
+void clearBatch( Batchptr batch )
+{
+  batch->number_of_graphs = 0;
+}
+
+void freeBatch( Batchptr batch )
+{
+  free( batch );
+}
+
+int batchSize( Batchptr batch )
+{
+  return batch->number_of_graphs;
+}
+
+bool batchIsFull( Batchptr batch )
+{
+  return batch->number_of_graphs == BATCH_CAPACITY;
+}
+
+int batchAddGraph( Batchptr batch, const char * name )
+{
+  if ( batchIsFull( batch ) ) return -1;
+  int graph = batch->number_of_graphs++;
+  strncpy( batch->name[graph], name, MAX_NAME_LENGTH - 1 );
+  batch->name[graph][MAX_NAME_LENGTH - 1] = '\0';
+  batch->number_of_nodes[graph] = 0;
+  batch->number_of_edges[graph] = 0;
+  batch->number_of_layers[graph] = 0;
+  batch->problem[graph] = NULL;
+  batch->start_crossings[graph] = 0;
+  batch->crossings[graph] = 0;
+  return graph;
+}
+
+void batchAddNode( Batchptr batch, int graph, int id, int layer,
+                   int position )
+{
+  if ( batch->problem[graph] != NULL ) return;
+  int node = batch->number_of_nodes[graph];
+  if ( node == BATCH_MAX_NODES || layer >= BATCH_MAX_LAYERS ) {
+    batch->problem[graph] = TOO_LARGE;
+    return;
+  }
+  if ( layer < 0 ) {
+    batch->problem[graph] = BAD_NODE;
+    return;
+  }
+  batch->node_id[graph][node] = id;
+  batch->node_layer[graph][node] = layer;
+  batch->node_position[graph][node] = position;
+  if ( layer >= batch->number_of_layers[graph] )
+    batch->number_of_layers[graph] = layer + 1;
+  batch->number_of_nodes[graph]++;
+}
+
+/**
+ * @return the index of the node with the given id, or -1 if there is none;
+ * ids are usually consecutive, which is tried first
+ */
+static int find_node( Batchptr batch, int graph, int id )
+{
+  int * ids = batch->node_id[graph];
+  int node_count = batch->number_of_nodes[graph];
+  if ( node_count == 0 ) return -1;
+  int guess = id - ids[0];
+  if ( guess >= 0 && guess < node_count && ids[guess] == id ) return guess;
+  for ( int node = 0; node < node_count; node++ )
+    if ( ids[node] == id ) return node;
+  return -1;
+}
+
+void batchAddEdge( Batchptr batch, int graph, int source_id, int target_id )
+{
+  if ( batch->problem[graph] != NULL ) return;
+  int edge = batch->number_of_edges[graph];
+  if ( edge == BATCH_MAX_EDGES ) {
+    batch->problem[graph] = TOO_LARGE;
+    return;
+  }
+  int source = find_node( batch, graph, source_id );
+  int target = find_node( batch, graph, target_id );
+  if ( source < 0 || target < 0 ) {
+    batch->problem[graph] = BAD_EDGE;
+    return;
+  }
+  int source_layer = batch->node_layer[graph][source];
+  int target_layer = batch->node_layer[graph][target];
+  if ( target_layer == source_layer + 1 ) {
+    batch->edge_lower[graph][edge] = source;
+    batch->edge_upper[graph][edge] = target;
+  }
+  else if ( source_layer == target_layer + 1 ) {
+    batch->edge_lower[graph][edge] = target;
+    batch->edge_upper[graph][edge] = source;
+  }
+  else {
+    batch->problem[graph] = BAD_EDGE;
+    return;
+  }
+  batch->number_of_edges[graph]++;
+}
+
+/**
+ * Sorts the nodes of the layer by their current position field (stable)
+ * and then makes the positions 0, 1, ...
+ */
+static void sort_layer_by_position( Batchptr batch, int graph, int layer )
+{
+  short * order = batch->order[graph];
+  short * position = batch->node_position[graph];
+  int first = batch->layer_start[graph][layer];
+  int last = batch->layer_start[graph][layer + 1];
+  for ( int i = first + 1; i < last; i++ ) {
+    short node = order[i];
+    int j = i - 1;
+    while ( j >= first && position[ order[j] ] > position[node] ) {
+      order[j + 1] = order[j];
+      j--;
+    }
+    order[j + 1] = node;
+  }
+  for ( int i = first; i < last; i++ ) position[ order[i] ] = i - first;
+}
+
+const char * batchFinishGraph( Batchptr batch, int graph )
+{
+  if ( batch->problem[graph] != NULL ) return batch->problem[graph];
+  int node_count = batch->number_of_nodes[graph];
+  int edge_count = batch->number_of_edges[graph];
+  int layer_count = batch->number_of_layers[graph];
+  short * layer_start = batch->layer_start[graph];
+
+  // group the nodes by layer, then put each layer in order of position
+  for ( int layer = 0; layer <= layer_count; layer++ ) layer_start[layer] = 0;
+  for ( int node = 0; node < node_count; node++ )
+    layer_start[ batch->node_layer[graph][node] + 1 ]++;
+  for ( int layer = 0; layer < layer_count; layer++ )
+    layer_start[layer + 1] += layer_start[layer];
+  short next[BATCH_MAX_LAYERS];
+  for ( int layer = 0; layer < layer_count; layer++ )
+    next[layer] = layer_start[layer];
+  for ( int node = 0; node < node_count; node++ )
+    batch->order[graph][ next[ batch->node_layer[graph][node] ]++ ] = node;
+  for ( int layer = 0; layer < layer_count; layer++ )
+    sort_layer_by_position( batch, graph, layer );
+
+  // adjacency lists, lower neighbors first
+  short * down_degree = batch->down_degree[graph];
+  short * up_degree = batch->up_degree[graph];
+  short * start = batch->adjacency_start[graph];
+  for ( int node = 0; node < node_count; node++ )
+    down_degree[node] = up_degree[node] = 0;
+  for ( int edge = 0; edge < edge_count; edge++ ) {
+    up_degree[ batch->edge_lower[graph][edge] ]++;
+    down_degree[ batch->edge_upper[graph][edge] ]++;
+  }
+  short fill[2 * BATCH_MAX_NODES];
+  int total = 0;
+  for ( int node = 0; node < node_count; node++ ) {
+    start[node] = total;
+    fill[2 * node] = total;
+    fill[2 * node + 1] = total + down_degree[node];
+    total += down_degree[node] + up_degree[node];
+  }
+  short * adjacency = batch->adjacency[graph];
+  for ( int edge = 0; edge < edge_count; edge++ ) {
+    short lower = batch->edge_lower[graph][edge];
+    short upper = batch->edge_upper[graph][edge];
+    adjacency[ fill[2 * upper]++ ] = lower;
+    adjacency[ fill[2 * lower + 1]++ ] = upper;
+  }
+  return NULL;
+}
+
+/**
+ * @return the number of crossings between layers upper_layer - 1 and
+ * upper_layer; the edges are listed in order of their upper endpoints, so
+ * two of them cross iff the first has the smaller upper position and the
+ * larger lower position
+ */
+static int channel_crossings( Batchptr batch, int graph, int upper_layer )
+{
+  short upper_position[BATCH_MAX_EDGES];
+  short lower_position[BATCH_MAX_EDGES];
+  short * position = batch->node_position[graph];
+  short * adjacency = batch->adjacency[graph];
+  int first = batch->layer_start[graph][upper_layer];
+  int last = batch->layer_start[graph][upper_layer + 1];
+  int count = 0;
+  for ( int i = first; i < last; i++ ) {
+    short node = batch->order[graph][i];
+    int start = batch->adjacency_start[graph][node];
+    int end = start + batch->down_degree[graph][node];
+    for ( int j = start; j < end; j++ ) {
+      upper_position[count] = i - first;
+      lower_position[count] = position[ adjacency[j] ];
+      count++;
+    }
+  }
+  int crossings = 0;
+  for ( int j = 1; j < count; j++ )
+    for ( int i = 0; i < j; i++ )
+      crossings += ( upper_position[i] < upper_position[j] )
+        & ( lower_position[i] > lower_position[j] );
+  return crossings;
+}
+
+static int graph_crossings( Batchptr batch, int graph )
+{
+  int crossings = 0;
+  for ( int layer = 1; layer < batch->number_of_layers[graph]; layer++ )
+    crossings += channel_crossings( batch, graph, layer );
+  return crossings;
+}
+
+/**
+ * Sorts the layer by barycenter weights with respect to the layer below
+ * (orientation DOWNWARD) or above (UPWARD); as in barycenter.c with the
+ * default weight adjustment, a node with no neighbors on that side keeps
+ * the weight of the node to its left and an isolated node goes to the left
+ * @return true if the order of the layer changed
+ */
+static bool barycenter_sort( Batchptr batch, int graph, int layer,
+                             Orientation orientation )
+{
+  double weight[BATCH_MAX_NODES];
+  short * order = batch->order[graph];
+  short * position = batch->node_position[graph];
+  short * adjacency = batch->adjacency[graph];
+  int first = batch->layer_start[graph][layer];
+  int last = batch->layer_start[graph][layer + 1];
+  for ( int i = first; i < last; i++ ) {
+    short node = order[i];
+    int start = batch->adjacency_start[graph][node];
+    int down = batch->down_degree[graph][node];
+    int up = batch->up_degree[graph][node];
+    if ( orientation == UPWARD ) start += down;
+    int degree = orientation == UPWARD ? up : down;
+    int total_of_positions = 0;
+    for ( int j = start; j < start + degree; j++ )
+      total_of_positions += position[ adjacency[j] ];
+    if ( degree > 0 )
+      weight[node] = (double) total_of_positions / degree;
+    else if ( down + up == 0 || i == first )
+      weight[node] = 0;
+    else
+      weight[node] = weight[ order[i - 1] ];
+  }
+  bool changed = false;
+  for ( int i = first + 1; i < last; i++ ) {
+    short node = order[i];
+    int j = i - 1;
+    while ( j >= first && weight[ order[j] ] > weight[node] ) {
+      order[j + 1] = order[j];
+      j--;
+    }
+    if ( j + 1 != i ) changed = true;
+    order[j + 1] = node;
+  }
+  if ( changed )
+    for ( int i = first; i < last; i++ ) position[ order[i] ] = i - first;
+  return changed;
+}
+
+static void save_best_order( Batchptr batch, int graph )
+{
+  memcpy( batch->best_order[graph], batch->order[graph],
+          batch->number_of_nodes[graph] * sizeof(short) );
+}
+
+static void restore_best_order( Batchptr batch, int graph )
+{
+  memcpy( batch->order[graph], batch->best_order[graph],
+          batch->number_of_nodes[graph] * sizeof(short) );
+  for ( int layer = 0; layer < batch->number_of_layers[graph]; layer++ ) {
+    int first = batch->layer_start[graph][layer];
+    int last = batch->layer_start[graph][layer + 1];
+    for ( int i = first; i < last; i++ )
+      batch->node_position[graph][ batch->order[graph][i] ] = i - first;
+  }
+}
+
+/**
+ * Compares the crossings among the edges of left and right, two adjacent
+ * nodes, in their current order and swapped
+ * @return the reduction in crossings if the two are swapped
+ */
+static int swap_gain( Batchptr batch, int graph, short left, short right )
+{
+  short * position = batch->node_position[graph];
+  short * adjacency = batch->adjacency[graph];
+  int left_start = batch->adjacency_start[graph][left];
+  int right_start = batch->adjacency_start[graph][right];
+  int gain = 0;
+  // lower neighbors, then upper ones
+  int left_end = left_start + batch->down_degree[graph][left];
+  int right_end = right_start + batch->down_degree[graph][right];
+  for ( int side = 0; side < 2; side++ ) {
+    for ( int i = left_start; i < left_end; i++ )
+      for ( int j = right_start; j < right_end; j++ ) {
+        int left_position = position[ adjacency[i] ];
+        int right_position = position[ adjacency[j] ];
+        gain += ( left_position > right_position )
+          - ( left_position < right_position );
+      }
+    left_start = left_end;
+    right_start = right_end;
+    left_end = left_start + batch->up_degree[graph][left];
+    right_end = right_start + batch->up_degree[graph][right];
+  }
+  return gain;
+}
+
+/**
+ * Swaps adjacent nodes on all layers as long as that reduces the crossings
+ * @return the number of crossings afterwards
+ */
+static int swap_until_no_gain( Batchptr batch, int graph, int crossings )
+{
+  short * order = batch->order[graph];
+  short * position = batch->node_position[graph];
+  bool improved = true;
+  while ( improved && crossings > 0 ) {
+    improved = false;
+    for ( int layer = 0; layer < batch->number_of_layers[graph]; layer++ ) {
+      int first = batch->layer_start[graph][layer];
+      int last = batch->layer_start[graph][layer + 1];
+      for ( int i = first; i < last - 1; i++ ) {
+        int gain = swap_gain( batch, graph, order[i], order[i + 1] );
+        if ( gain > 0 ) {
+          short temp = order[i];
+          order[i] = order[i + 1];
+          order[i + 1] = temp;
+          position[ order[i] ] = i - first;
+          position[ order[i + 1] ] = i + 1 - first;
+          crossings -= gain;
+          improved = true;
+        }
+      }
+    }
+  }
+  return crossings;
+}
+
+static void solve_graph( Batchptr batch, int graph, int iterations,
+                         bool post_processing )
+{
+  int layer_count = batch->number_of_layers[graph];
+  int best_crossings = graph_crossings( batch, graph );
+  batch->start_crossings[graph] = best_crossings;
+  save_best_order( batch, graph );
+  for ( int iteration = 0;
+        iteration < iterations && best_crossings > 0;
+        iteration++ ) {
+    bool changed = false;
+    for ( int layer = 1; layer < layer_count; layer++ )
+      changed |= barycenter_sort( batch, graph, layer, DOWNWARD );
+    for ( int layer = layer_count - 2; layer >= 0; layer-- )
+      changed |= barycenter_sort( batch, graph, layer, UPWARD );
+    if ( ! changed ) break;
+    int crossings = graph_crossings( batch, graph );
+    if ( crossings < best_crossings ) {
+      best_crossings = crossings;
+      save_best_order( batch, graph );
+    }
+  }
+  restore_best_order( batch, graph );
+  if ( post_processing )
+    best_crossings = swap_until_no_gain( batch, graph, best_crossings );
+  batch->crossings[graph] = best_crossings;
+}
+
+void solveBatch( Batchptr batch, int iterations, bool post_processing )
+{
+  for ( int graph = 0; graph < batch->number_of_graphs; graph++ )
+    if ( batch->problem[graph] == NULL )
+      solve_graph( batch, graph, iterations, post_processing );
+}
+
+const char * batchGraphName( Batchptr batch, int graph )
+{
+  return batch->name[graph];
+}
+
+bool batchIsSolvable( Batchptr batch, int graph )
+{
+  return batch->problem[graph] == NULL;
+}
+
+int batchStartCrossings( Batchptr batch, int graph )
+{
+  return batch->start_crossings[graph];
+}
+
+int batchCrossings( Batchptr batch, int graph )
+{
+  return batch->crossings[graph];
+}
+
+void writeBatchGraph( FILE * out, Batchptr batch, int graph )
+{
+  int node_count = batch->number_of_nodes[graph];
+  int edge_count = batch->number_of_edges[graph];
+  int * id = batch->node_id[graph];
+  fprintf( out, "t %s %d %d %d\n", batch->name[graph],
+           node_count, edge_count, batch->number_of_layers[graph] );
+  for ( int node = 0; node < node_count; node++ )
+    fprintf( out, "n %d %d %d\n", id[node],
+             batch->node_layer[graph][node],
+             batch->node_position[graph][node] );
+  for ( int edge = 0; edge < edge_count; edge++ )
+    fprintf( out, "e %d %d\n", id[ batch->edge_lower[graph][edge] ],
+             id[ batch->edge_upper[graph][edge] ] );
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,130 @@
+/**
+ * @file batch.h
+ * @brief Crossing minimization for many tiny graphs at once.
+ *
+ * For graphs with a few dozen nodes the per-graph overhead of minimization
+ * (allocation of the graph structures, global setup, statistics and order
+ * snapshots) costs much more than the heuristic itself. A batch instead
+ * holds up to BATCH_CAPACITY graphs in fixed-size arrays, one array per
+ * field with a row of BATCH_MAX_NODES (or BATCH_MAX_EDGES) entries per
+ * graph, allocated once and reused. Nodes are referred to by their index
+ * within their graph, not by pointers.
+ *
+ * solveBatch() runs barycenter sweeps followed, optionally, by swaps of
+ * adjacent nodes (as in the -z post-processing of minimization) on every
+ * graph of the batch, one graph after the other in a tight loop with no
+ * allocation.
+ *
+ * Usage:
+ * <pre>
+ *    Batchptr batch = newBatch();
+ *    int graph = batchAddGraph( batch, name );
+ *    batchAddNode( batch, graph, id, layer, position ); ...
+ *    batchAddEdge( batch, graph, source_id, target_id ); ...
+ *    batchFinishGraph( batch, graph );
+ *    ... more graphs, until batchIsFull( batch )
+ *    solveBatch( batch, iterations, post_processing );
+ *    ... batchCrossings(), writeBatchGraph() for each graph
+ *    clearBatch( batch );
+ * </pre>
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include<stdio.h>
+#include<stdbool.h>
+
+typedef struct batch_struct * Batchptr;
+
+/**
+ * @return a new, empty batch
+ */
+Batchptr newBatch( void );
+
+/**
+ * Removes all graphs from the batch so that it can be filled again
+ */
+void clearBatch( Batchptr batch );
+
+void freeBatch( Batchptr batch );
+
+/**
+ * @return the number of graphs in the batch
+ */
+int batchSize( Batchptr batch );
+
+/**
+ * @return true if no more graphs can be added
+ */
+bool batchIsFull( Batchptr batch );
+
+/**
+ * Starts a new graph with the given name
+ * @return the index of the graph in the batch, or -1 if the batch is full
+ */
+int batchAddGraph( Batchptr batch, const char * name );
+
+/**
+ * Adds a node to the graph; a graph with more than BATCH_MAX_NODES nodes or
+ * more than BATCH_MAX_LAYERS layers is marked as too large
+ */
+void batchAddNode( Batchptr batch, int graph, int id, int layer,
+                   int position );
+
+/**
+ * Adds an edge between the nodes with the given ids; the graph is marked
+ * as invalid if a node does not exist or the nodes are not on adjacent
+ * layers, and as too large if it has more than BATCH_MAX_EDGES edges
+ */
+void batchAddEdge( Batchptr batch, int graph, int source_id, int target_id );
+
+/**
+ * Puts the nodes of each layer in the order given by their positions and
+ * builds the adjacency lists; must be called once all nodes and edges of
+ * the graph have been added
+ * @return NULL if the graph can be solved, otherwise the reason why not
+ */
+const char * batchFinishGraph( Batchptr batch, int graph );
+
+/**
+ * Minimizes the crossings of every graph of the batch that can be solved:
+ * alternating upward and downward barycenter sweeps, at most iterations
+ * of each or until an iteration changes nothing, keeping the best order
+ * seen, then, if post_processing is true, swaps of adjacent nodes until
+ * no swap reduces the crossings
+ */
+void solveBatch( Batchptr batch, int iterations, bool post_processing );
+
+/**
+ * @return the name of the graph
+ */
+const char * batchGraphName( Batchptr batch, int graph );
+
+/**
+ * @return true if the graph is solved by solveBatch(), i.e.,
+ * batchFinishGraph() returned NULL for it
+ */
+bool batchIsSolvable( Batchptr batch, int graph );
+
+/**
+ * @return the number of crossings of the graph in its input order
+ */
+int batchStartCrossings( Batchptr batch, int graph );
+
+/**
+ * @return the number of crossings of the graph after solveBatch()
+ */
+int batchCrossings( Batchptr batch, int graph );
+
+/**
+ * Writes the graph, with its current order, in sgf format
+ */
+void writeBatchGraph( FILE * out, Batchptr batch, int graph );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,175 @@
+/**
+ * @file batch_minimization.c
+ * @brief Program that minimizes the crossings of many small graphs, given
+ * one after the other in sgf format, using the batch engine of batch.h.
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ *
+ * Usage: batch_minimization [-i ITERATIONS] [-z] [-o] [SGF_FILE ...]
+ *  -i  maximum number of barycenter iterations for each graph (default 10)
+ *  -z  swap adjacent nodes after the barycenter iterations until no swap
+ *      reduces the crossings
+ *  -o  write each graph, with its new order, in sgf format instead of the
+ *      table of crossings
+ *
+ * The graphs are read from the files, or from standard input if there are
+ * none; each file may contain any number of graphs, each beginning with its
+ * 't' line. Comments are ignored. Without -o the output is a table with a
+ * line GraphName,StartCrossings,Crossings for each graph. Graphs that are
+ * too large for a batch (see constants.h) or are not proper layered graphs
+ * are skipped with a warning.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<unistd.h>              /* getopt() */
+#include<getopt.h>              /* for Linux */
+
+#include"constants.h"
+#include"batch.h"
+#include"timing.h"
+
+static int iterations = 10;
+static bool post_processing = false;
+static bool write_sgf = false;
+
+static int number_of_graphs = 0;
+static int number_skipped = 0;
+
+static void printUsage( void ) {
+  fprintf( stderr, "Usage: batch_minimization [-i ITERATIONS] [-z] [-o]"
+           " [SGF_FILE ...]\n" );
+  fprintf( stderr, " minimizes the crossings of each of the graphs in the"
+           " files (or standard input)\n" );
+  fprintf( stderr, "  -i at most ITERATIONS barycenter iterations per graph"
+           " (default %d)\n", iterations );
+  fprintf( stderr, "  -z swap adjacent nodes until there is no improvement\n" );
+  fprintf( stderr, "  -o write the graphs with their new orders (sgf)"
+           " instead of their crossings\n" );
+}
+
+/**
+ * Solves the graphs in the batch, writes the results and empties the batch
+ */
+static void flush_batch( Batchptr batch ) {
+  solveBatch( batch, iterations, post_processing );
+  for ( int graph = 0; graph < batchSize( batch ); graph++ ) {
+    if ( ! batchIsSolvable( batch, graph ) ) continue;
+    if ( write_sgf ) {
+      fprintf( stdout, "c batch_minimization: crossings %d, input %d\n",
+               batchCrossings( batch, graph ),
+               batchStartCrossings( batch, graph ) );
+      writeBatchGraph( stdout, batch, graph );
+    }
+    else
+      printf( "%s,%d,%d\n", batchGraphName( batch, graph ),
+              batchStartCrossings( batch, graph ),
+              batchCrossings( batch, graph ) );
+  }
+  clearBatch( batch );
+}
+
+/**
+ * Completes the graph most recently added, if any
+ */
+static void finish_graph( Batchptr batch, int graph ) {
+  if ( graph < 0 ) return;
+  const char * problem = batchFinishGraph( batch, graph );
+  number_of_graphs++;
+  if ( problem != NULL ) {
+    fprintf( stderr, "*** Warning: graph %s skipped, %s\n",
+             batchGraphName( batch, graph ), problem );
+    number_skipped++;
+  }
+}
+
+static void read_graphs( Batchptr batch, FILE * stream,
+                         const char * stream_name ) {
+  char line[MAX_NAME_LENGTH];
+  char name[MAX_NAME_LENGTH];
+  int graph = -1;
+  int line_number = 0;
+  while ( fgets( line, MAX_NAME_LENGTH, stream ) != NULL ) {
+    line_number++;
+    int first, second, third;
+    if ( line[0] == 't' ) {
+      finish_graph( batch, graph );
+      if ( batchIsFull( batch ) ) flush_batch( batch );
+      if ( sscanf( line, "t %511s", name ) != 1 ) {
+        fprintf( stderr, "*** FATAL ERROR, %s line %d: graph name missing\n",
+                 stream_name, line_number );
+        exit( EXIT_FAILURE );
+      }
+      graph = batchAddGraph( batch, name );
+    }
+    else if ( line[0] == 'n' || line[0] == 'e' ) {
+      if ( graph < 0 ) {
+        fprintf( stderr, "*** FATAL ERROR, %s line %d: no 't' line before"
+                 " the first node or edge\n", stream_name, line_number );
+        exit( EXIT_FAILURE );
+      }
+      if ( line[0] == 'n'
+           && sscanf( line, "n %d %d %d", &first, &second, &third ) == 3 )
+        batchAddNode( batch, graph, first, second, third );
+      else if ( line[0] == 'e'
+                && sscanf( line, "e %d %d", &first, &second ) == 2 )
+        batchAddEdge( batch, graph, first, second );
+      else {
+        fprintf( stderr, "*** FATAL ERROR, %s line %d: bad line '%s'\n",
+                 stream_name, line_number, line );
+        exit( EXIT_FAILURE );
+      }
+    }
+    // comments and blank lines are ignored
+  }
+  finish_graph( batch, graph );
+}
+
+int main( int argc, char * argv[] ) {
+  int option;
+  while ( ( option = getopt( argc, argv, "i:oz" ) ) != -1 ) {
+    switch ( option ) {
+    case 'i':
+      iterations = atoi( optarg );
+      break;
+    case 'o':
+      write_sgf = true;
+      break;
+    case 'z':
+      post_processing = true;
+      break;
+    default:
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  double start_time = getUserSeconds();
+  Batchptr batch = newBatch();
+  if ( ! write_sgf ) printf( "GraphName,StartCrossings,Crossings\n" );
+  if ( optind == argc )
+    read_graphs( batch, stdin, "stdin" );
+  for ( int i = optind; i < argc; i++ ) {
+    FILE * stream = fopen( argv[i], "r" );
+    if ( stream == NULL ) {
+      fprintf( stderr, "*** FATAL ERROR: file %s could not be opened\n",
+               argv[i] );
+      exit( EXIT_FAILURE );
+    }
+    read_graphs( batch, stream, argv[i] );
+    fclose( stream );
+  }
+  flush_batch( batch );
+  freeBatch( batch );
+
+  double seconds = getUserSeconds() - start_time;
+  fprintf( stderr, "--- %d graphs (%d skipped) in %.3f seconds",
+           number_of_graphs, number_skipped, seconds );
+  if ( seconds > 0 )
+    fprintf( stderr, ", %.0f graphs per second", number_of_graphs / seconds );
+  fprintf( stderr, "\n" );
+  return EXIT_SUCCESS;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
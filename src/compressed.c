@@ -0,0 +1,816 @@
+/**
+ * @file compressed.c
+ * @brief Implementation of the compact graph storage and its kernels.
+ *
+ * Crossings between two layers are counted by decoding the edges of the
+ * channel into the positions of their endpoints and passing these to
+ * count_inversions_by_position() in crossing_utilities.c, which uses a
+ * Fenwick tree over the positions of the lower layer. The barycenter weights
+ * of nodes with no neighbors on one side are adjusted by adjustWeights() in
+ * weights.c, as in barycenter.c.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include"constants.h"
+#include"compressed.h"
+#include"crossing_utilities.h"
+#include"weights.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdbool.h>
+#include<stdint.h>
+
+/** size of the buffer used when reading the input file */
+#define READ_BUFFER_SIZE (1 << 16)
+
+struct compressed_graph_struct {
+  char name[MAX_NAME_LENGTH];
+  /** comment lines of the input, each followed by a newline */
+  char * comments;
+  int number_of_nodes;
+  long long number_of_edges;
+  int number_of_layers;
+  /**
+   * the nodes of layer i are numbered layer_start[i], ...,
+   * layer_start[i+1] - 1
+   */
+  int * layer_start;
+  int max_layer_size;
+  /** largest number of neighbors of a node on one side */
+  int max_degree;
+
+  // per node
+  int * id;
+  int * position;
+  int * best_position;
+  /**
+   * the down list of node v is in down_stream[down_offset[v]], ...,
+   * down_stream[down_offset[v+1] - 1], similarly for the up list
+   */
+  size_t * down_offset;
+  size_t * up_offset;
+  unsigned char * down_stream;
+  unsigned char * up_stream;
+
+  /** order[layer_start[i] + p] is the node at position p of layer i */
+  int * order;
+};
+
+// ******** varints ************
+
+static size_t varint_length( unsigned int value )
+{
+  size_t length = 1;
+  while ( value >= 0x80 ) {
+    value >>= 7;
+    length++;
+  }
+  return length;
+}
+
+static unsigned char * put_varint( unsigned char * out, unsigned int value )
+{
+  while ( value >= 0x80 ) {
+    *out++ = (unsigned char) ( value | 0x80 );
+    value >>= 7;
+  }
+  *out++ = (unsigned char) value;
+  return out;
+}
+
+static const unsigned char * get_varint( const unsigned char * in,
+                                         unsigned int * value )
+{
+  unsigned int result = 0;
+  int shift = 0;
+  while ( *in & 0x80 ) {
+    result |= (unsigned int) ( *in++ & 0x7f ) << shift;
+    shift += 7;
+  }
+  result |= (unsigned int) *in++ << shift;
+  *value = result;
+  return in;
+}
+
+/**
+ * Decodes a list of neighbors on the layer that starts with node
+ * layer_first into the neighbors array
+ * @return the number of neighbors
+ */
+static int decode_list( const unsigned char * in, const unsigned char * end,
+                        int layer_first, int * neighbors )
+{
+  int count = 0;
+  int previous = layer_first;
+  while ( in < end ) {
+    unsigned int delta;
+    in = get_varint( in, &delta );
+    previous += (int) delta;
+    neighbors[count++] = previous;
+  }
+  return count;
+}
+
+// ******** reading ************
+
+typedef struct reader_struct {
+  FILE * stream;
+  const char * file_name;
+  char buffer[READ_BUFFER_SIZE];
+  size_t length;
+  size_t next;
+  long line_number;
+} * Readerptr;
+
+/**
+ * Reads the next line into the line buffer, without the newline
+ * @return false at end of file
+ */
+static bool read_line( Readerptr reader, char * line )
+{
+  int length = 0;
+  bool any = false;
+  for ( ; ; ) {
+    if ( reader->next == reader->length ) {
+      reader->length = fread( reader->buffer, 1, READ_BUFFER_SIZE,
+                              reader->stream );
+      reader->next = 0;
+      if ( reader->length == 0 ) break;
+    }
+    char c = reader->buffer[ reader->next++ ];
+    any = true;
+    if ( c == '\n' ) break;
+    if ( length < MAX_NAME_LENGTH - 1 ) line[length++] = c;
+  }
+  line[length] = '\0';
+  if ( any ) reader->line_number++;
+  return any;
+}
+
+static void rewind_reader( Readerptr reader )
+{
+  rewind( reader->stream );
+  reader->length = reader->next = 0;
+  reader->line_number = 0;
+}
+
+static void bad_line( Readerptr reader, const char * line )
+{
+  fprintf( stderr, "*** FATAL ERROR, %s line %ld: bad line '%s'\n",
+           reader->file_name, reader->line_number, line );
+  exit( EXIT_FAILURE );
+}
+
+/**
+ * Reads the given number of integers following the tag of the line
+ */
+static void parse_numbers( Readerptr reader, const char * line,
+                           int count, long * numbers )
+{
+  const char * next = line + 1;
+  for ( int i = 0; i < count; i++ ) {
+    char * end;
+    numbers[i] = strtol( next, &end, 10 );
+    if ( end == next ) bad_line( reader, line );
+    next = end;
+  }
+}
+
+static void * allocate( size_t count, size_t size )
+{
+  void * memory = calloc( count > 0 ? count : 1, size );
+  if ( memory == NULL ) {
+    fprintf( stderr, "*** FATAL ERROR: unable to allocate %zu bytes\n",
+             count * size );
+    exit( EXIT_FAILURE );
+  }
+  return memory;
+}
+
+static void add_comment( CompressedGraphptr graph, const char * comment )
+{
+  size_t old_length = graph->comments == NULL ? 0 : strlen( graph->comments );
+  graph->comments = realloc( graph->comments,
+                             old_length + strlen( comment ) + 2 );
+  strcpy( graph->comments + old_length, comment );
+  strcat( graph->comments + old_length, "\n" );
+}
+
+/** node input in the order read, used only while the graph is built */
+static int * input_id = NULL;
+static int * input_layer = NULL;
+static int * input_position = NULL;
+
+/**
+ * the nodes sorted by id, for looking up the ends of edges; if the ids are
+ * consecutive, node_of_id[id - min_id] is used instead
+ */
+static int * nodes_by_id = NULL;
+static int * node_of_id = NULL;
+static int min_id;
+static const int * sort_ids;
+
+static int compare_by_id( const void * ptr_i, const void * ptr_j )
+{
+  int id_i = sort_ids[ *(const int *) ptr_i ];
+  int id_j = sort_ids[ *(const int *) ptr_j ];
+  return ( id_i > id_j ) - ( id_i < id_j );
+}
+
+static void build_id_lookup( CompressedGraphptr graph )
+{
+  int n = graph->number_of_nodes;
+  nodes_by_id = (int *) allocate( n, sizeof(int) );
+  for ( int node = 0; node < n; node++ ) nodes_by_id[node] = node;
+  sort_ids = graph->id;
+  qsort( nodes_by_id, n, sizeof(int), compare_by_id );
+  if ( n > 0 ) {
+    min_id = graph->id[ nodes_by_id[0] ];
+    long span = (long) graph->id[ nodes_by_id[n - 1] ] - min_id + 1;
+    if ( span == n ) {
+      node_of_id = nodes_by_id;
+      for ( int node = 0; node < n; node++ )
+        node_of_id[ graph->id[node] - min_id ] = node;
+      nodes_by_id = NULL;
+    }
+  }
+}
+
+static int find_node( CompressedGraphptr graph, Readerptr reader, long id )
+{
+  int n = graph->number_of_nodes;
+  if ( node_of_id != NULL ) {
+    if ( id >= min_id && id - min_id < n ) return node_of_id[ id - min_id ];
+  }
+  else {
+    int low = 0;
+    int high = n - 1;
+    while ( low <= high ) {
+      int middle = low + ( high - low ) / 2;
+      int middle_id = graph->id[ nodes_by_id[middle] ];
+      if ( middle_id == id ) return nodes_by_id[middle];
+      if ( middle_id < id ) low = middle + 1;
+      else high = middle - 1;
+    }
+  }
+  fprintf( stderr, "*** FATAL ERROR, %s line %ld: no node with id %ld\n",
+           reader->file_name, reader->line_number, id );
+  exit( EXIT_FAILURE );
+}
+
+/**
+ * @return the layer of the node, by binary search on layer_start
+ */
+static int layer_of( CompressedGraphptr graph, int node )
+{
+  int low = 0;
+  int high = graph->number_of_layers - 1;
+  while ( low < high ) {
+    int middle = ( low + high + 1 ) / 2;
+    if ( graph->layer_start[middle] <= node ) low = middle;
+    else high = middle - 1;
+  }
+  return low;
+}
+
+/**
+ * First pass: header, comments and nodes; numbers the nodes
+ */
+static void read_nodes( CompressedGraphptr graph, Readerptr reader )
+{
+  char line[MAX_NAME_LENGTH];
+  int capacity = CAPACITY_INCREMENT;
+  int count = 0;
+  int layers = 0;
+  input_id = (int *) allocate( capacity, sizeof(int) );
+  input_layer = (int *) allocate( capacity, sizeof(int) );
+  input_position = (int *) allocate( capacity, sizeof(int) );
+  while ( read_line( reader, line ) ) {
+    if ( line[0] == 'c' ) add_comment( graph, line[1] == '\0' ? "" : line + 2 );
+    else if ( line[0] == 't' ) {
+      if ( sscanf( line, "t %511s", graph->name ) != 1 )
+        bad_line( reader, line );
+    }
+    else if ( line[0] == 'n' ) {
+      long numbers[3];
+      parse_numbers( reader, line, 3, numbers );
+      if ( numbers[1] < 0 || numbers[2] < 0 ) bad_line( reader, line );
+      if ( count == capacity ) {
+        capacity *= 2;
+        input_id = realloc( input_id, capacity * sizeof(int) );
+        input_layer = realloc( input_layer, capacity * sizeof(int) );
+        input_position = realloc( input_position, capacity * sizeof(int) );
+        if ( input_id == NULL || input_layer == NULL
+             || input_position == NULL ) {
+          fprintf( stderr, "*** FATAL ERROR: unable to allocate nodes\n" );
+          exit( EXIT_FAILURE );
+        }
+      }
+      input_id[count] = numbers[0];
+      input_layer[count] = numbers[1];
+      input_position[count] = numbers[2];
+      if ( numbers[1] >= layers ) layers = numbers[1] + 1;
+      count++;
+    }
+    else if ( line[0] == 'e' ) {
+      graph->number_of_edges++;
+    }
+    else if ( line[ strspn( line, " \t\r" ) ] != '\0' )
+      bad_line( reader, line );
+  }
+  graph->number_of_nodes = count;
+  graph->number_of_layers = layers;
+
+  // number the nodes by layer and position
+  graph->layer_start = (int *) allocate( layers + 1, sizeof(int) );
+  for ( int i = 0; i < count; i++ ) graph->layer_start[ input_layer[i] + 1 ]++;
+  graph->max_layer_size = 0;
+  for ( int layer = 0; layer < layers; layer++ ) {
+    int size = graph->layer_start[layer + 1];
+    if ( size > graph->max_layer_size ) graph->max_layer_size = size;
+    graph->layer_start[layer + 1] += graph->layer_start[layer];
+  }
+  graph->id = (int *) allocate( count, sizeof(int) );
+  bool * used = (bool *) allocate( count, sizeof(bool) );
+  for ( int i = 0; i < count; i++ ) {
+    int layer = input_layer[i];
+    int size = graph->layer_start[layer + 1] - graph->layer_start[layer];
+    int node = graph->layer_start[layer] + input_position[i];
+    if ( input_position[i] >= size || used[node] ) {
+      fprintf( stderr, "*** FATAL ERROR: node %d has position %d, which is"
+               " out of range or used by another node on layer %d\n",
+               input_id[i], input_position[i], layer );
+      exit( EXIT_FAILURE );
+    }
+    used[node] = true;
+    graph->id[node] = input_id[i];
+  }
+  free( used );
+  free( input_id );
+  free( input_layer );
+  free( input_position );
+  input_id = input_layer = input_position = NULL;
+
+  graph->position = (int *) allocate( count, sizeof(int) );
+  graph->best_position = (int *) allocate( count, sizeof(int) );
+  graph->order = (int *) allocate( count, sizeof(int) );
+  for ( int layer = 0; layer < layers; layer++ )
+    for ( int node = graph->layer_start[layer];
+          node < graph->layer_start[layer + 1]; node++ ) {
+      graph->position[node] = node - graph->layer_start[layer];
+      graph->order[node] = node;
+    }
+}
+
+/**
+ * Second pass: the edges, into temporary uncompressed lists of all
+ * neighbors of each node; the offsets of the lists are in list_start
+ */
+static int * read_edges( CompressedGraphptr graph, Readerptr reader,
+                         size_t * list_start )
+{
+  char line[MAX_NAME_LENGTH];
+  int n = graph->number_of_nodes;
+  int * neighbors = (int *) allocate( 2 * graph->number_of_edges,
+                                      sizeof(int) );
+  size_t * fill = (size_t *) allocate( n, sizeof(size_t) );
+  for ( int node = 0; node < n; node++ ) fill[node] = list_start[node];
+  while ( read_line( reader, line ) ) {
+    if ( line[0] != 'e' ) continue;
+    long numbers[2];
+    parse_numbers( reader, line, 2, numbers );
+    int source = find_node( graph, reader, numbers[0] );
+    int target = find_node( graph, reader, numbers[1] );
+    neighbors[ fill[source]++ ] = target;
+    neighbors[ fill[target]++ ] = source;
+  }
+  free( fill );
+  return neighbors;
+}
+
+/**
+ * Counts the neighbors of each node (first half of the second pass) and
+ * checks that edges are between adjacent layers
+ */
+static void count_degrees( CompressedGraphptr graph, Readerptr reader,
+                           size_t * list_start )
+{
+  char line[MAX_NAME_LENGTH];
+  while ( read_line( reader, line ) ) {
+    if ( line[0] != 'e' ) continue;
+    long numbers[2];
+    parse_numbers( reader, line, 2, numbers );
+    int source = find_node( graph, reader, numbers[0] );
+    int target = find_node( graph, reader, numbers[1] );
+    int source_layer = layer_of( graph, source );
+    int target_layer = layer_of( graph, target );
+    if ( source_layer - target_layer != 1 && target_layer - source_layer != 1 ) {
+      fprintf( stderr, "*** FATAL ERROR, %s line %ld: nodes %ld and %ld are"
+               " not on adjacent layers\n", reader->file_name,
+               reader->line_number, numbers[0], numbers[1] );
+      exit( EXIT_FAILURE );
+    }
+    list_start[source + 1]++;
+    list_start[target + 1]++;
+  }
+  for ( int node = 0; node < graph->number_of_nodes; node++ )
+    list_start[node + 1] += list_start[node];
+}
+
+static int compare_ints( const void * ptr_i, const void * ptr_j )
+{
+  int i = *(const int *) ptr_i;
+  int j = *(const int *) ptr_j;
+  return ( i > j ) - ( i < j );
+}
+
+/**
+ * Encodes the neighbors of each node: those before layer_first (the first
+ * node of the node's own layer) go to the down stream, the others to the
+ * up stream; when write is false only the offsets are computed
+ */
+static void encode_lists( CompressedGraphptr graph, const int * neighbors,
+                          const size_t * list_start, bool write )
+{
+  size_t down_size = 0;
+  size_t up_size = 0;
+  for ( int layer = 0; layer < graph->number_of_layers; layer++ ) {
+    int layer_first = graph->layer_start[layer];
+    int down_first = layer > 0 ? graph->layer_start[layer - 1] : 0;
+    int up_first = graph->layer_start[layer + 1];
+    for ( int node = layer_first; node < graph->layer_start[layer + 1];
+          node++ ) {
+      graph->down_offset[node] = down_size;
+      graph->up_offset[node] = up_size;
+      int down_previous = down_first;
+      int up_previous = up_first;
+      for ( size_t i = list_start[node]; i < list_start[node + 1]; i++ ) {
+        int neighbor = neighbors[i];
+        if ( neighbor < layer_first ) {
+          unsigned int delta = neighbor - down_previous;
+          if ( write ) put_varint( graph->down_stream + down_size, delta );
+          down_size += varint_length( delta );
+          down_previous = neighbor;
+        }
+        else {
+          unsigned int delta = neighbor - up_previous;
+          if ( write ) put_varint( graph->up_stream + up_size, delta );
+          up_size += varint_length( delta );
+          up_previous = neighbor;
+        }
+      }
+    }
+  }
+  graph->down_offset[ graph->number_of_nodes ] = down_size;
+  graph->up_offset[ graph->number_of_nodes ] = up_size;
+}
+
+CompressedGraphptr readCompressedSgf( const char * file_name )
+{
+  Readerptr reader = (Readerptr) allocate( 1, sizeof(struct reader_struct) );
+  reader->stream = fopen( file_name, "r" );
+  if ( reader->stream == NULL ) {
+    fprintf( stderr, "*** FATAL ERROR: file %s could not be opened\n",
+             file_name );
+    exit( EXIT_FAILURE );
+  }
+  reader->file_name = file_name;
+  CompressedGraphptr graph
+    = (CompressedGraphptr) allocate( 1,
+                                     sizeof(struct compressed_graph_struct) );
+  read_nodes( graph, reader );
+  build_id_lookup( graph );
+
+  int n = graph->number_of_nodes;
+  size_t * list_start = (size_t *) allocate( n + 1, sizeof(size_t) );
+  rewind_reader( reader );
+  count_degrees( graph, reader, list_start );
+  rewind_reader( reader );
+  int * neighbors = read_edges( graph, reader, list_start );
+  fclose( reader->stream );
+  free( reader );
+  free( nodes_by_id );
+  free( node_of_id );
+  nodes_by_id = node_of_id = NULL;
+
+  // sorted lists have small gaps; lower neighbors have smaller numbers
+  for ( int node = 0; node < n; node++ )
+    qsort( neighbors + list_start[node],
+           list_start[node + 1] - list_start[node], sizeof(int),
+           compare_ints );
+  graph->down_offset = (size_t *) allocate( n + 1, sizeof(size_t) );
+  graph->up_offset = (size_t *) allocate( n + 1, sizeof(size_t) );
+  encode_lists( graph, neighbors, list_start, false );
+  graph->down_stream
+    = (unsigned char *) allocate( graph->down_offset[n], 1 );
+  graph->up_stream = (unsigned char *) allocate( graph->up_offset[n], 1 );
+  encode_lists( graph, neighbors, list_start, true );
+  free( neighbors );
+  free( list_start );
+  saveCompressedOrder( graph );
+  graph->max_degree = 0;
+  for ( int node = 0; node < n; node++ ) {
+    size_t down_bytes = graph->down_offset[node + 1] - graph->down_offset[node];
+    size_t up_bytes = graph->up_offset[node + 1] - graph->up_offset[node];
+    // each neighbor takes at least one byte
+    if ( down_bytes > (size_t) graph->max_degree )
+      graph->max_degree = down_bytes;
+    if ( up_bytes > (size_t) graph->max_degree )
+      graph->max_degree = up_bytes;
+  }
+  return graph;
+}
+
+void freeCompressedGraph( CompressedGraphptr graph )
+{
+  free( graph->comments );
+  free( graph->layer_start );
+  free( graph->id );
+  free( graph->position );
+  free( graph->best_position );
+  free( graph->down_offset );
+  free( graph->up_offset );
+  free( graph->down_stream );
+  free( graph->up_stream );
+  free( graph->order );
+  free( graph );
+}
+
+const char * compressedGraphName( CompressedGraphptr graph )
+{
+  return graph->name;
+}
+
+int compressedNumberOfNodes( CompressedGraphptr graph )
+{
+  return graph->number_of_nodes;
+}
+
+long long compressedNumberOfEdges( CompressedGraphptr graph )
+{
+  return graph->number_of_edges;
+}
+
+int compressedNumberOfLayers( CompressedGraphptr graph )
+{
+  return graph->number_of_layers;
+}
+
+size_t compressedAdjacencyBytes( CompressedGraphptr graph )
+{
+  return graph->down_offset[ graph->number_of_nodes ]
+    + graph->up_offset[ graph->number_of_nodes ];
+}
+
+// ******** crossings ************
+
+/**
+ * Decodes the down list of the node into lower positions
+ * @return the degree
+ */
+static int lower_positions( CompressedGraphptr graph, int node, int layer,
+                            int * positions )
+{
+  int degree
+    = decode_list( graph->down_stream + graph->down_offset[node],
+                   graph->down_stream + graph->down_offset[node + 1],
+                   graph->layer_start[layer - 1], positions );
+  for ( int i = 0; i < degree; i++ )
+    positions[i] = graph->position[ positions[i] ];
+  return degree;
+}
+
+/**
+ * Edges of one channel, numbered left to right by upper end, as needed by
+ * count_inversions_by_position(); the arrays grow as needed and exist only
+ * while the crossings are counted
+ */
+typedef struct channel_edges {
+  int * upper_position;
+  int * lower_position;
+  int * edge_crossings;
+  int capacity;
+  int * positions;
+  int * tree;
+} ChannelEdges;
+
+static void start_channel_edges( CompressedGraphptr graph,
+                                 ChannelEdges * edges )
+{
+  edges->upper_position = NULL;
+  edges->lower_position = NULL;
+  edges->edge_crossings = NULL;
+  edges->capacity = 0;
+  edges->positions = (int *) allocate( graph->max_degree, sizeof(int) );
+  edges->tree = (int *) allocate( graph->max_layer_size + 1, sizeof(int) );
+}
+
+static void free_channel_edges( ChannelEdges * edges )
+{
+  free( edges->upper_position );
+  free( edges->lower_position );
+  free( edges->edge_crossings );
+  free( edges->positions );
+  free( edges->tree );
+}
+
+/**
+ * Decodes the edges between the layer and the one below it
+ * @return the number of edges
+ */
+static int decode_channel( CompressedGraphptr graph, int layer,
+                           ChannelEdges * edges )
+{
+  int first = graph->layer_start[layer];
+  int upper_size = graph->layer_start[layer + 1] - first;
+  int edge_count = 0;
+  for ( int i = 0; i < upper_size; i++ ) {
+    int degree = lower_positions( graph, graph->order[ first + i ], layer,
+                                  edges->positions );
+    if ( edge_count + degree > edges->capacity ) {
+      edges->capacity = 2 * ( edge_count + degree );
+      free( edges->edge_crossings );
+      edges->upper_position
+        = (int *) realloc( edges->upper_position,
+                           edges->capacity * sizeof(int) );
+      edges->lower_position
+        = (int *) realloc( edges->lower_position,
+                           edges->capacity * sizeof(int) );
+      edges->edge_crossings
+        = (int *) allocate( edges->capacity, sizeof(int) );
+      if ( edges->upper_position == NULL || edges->lower_position == NULL ) {
+        fprintf( stderr, "*** FATAL ERROR: out of memory for the edges"
+                 " of a channel\n" );
+        exit( EXIT_FAILURE );
+      }
+    }
+    for ( int j = 0; j < degree; j++ ) {
+      edges->upper_position[edge_count] = i;
+      edges->lower_position[edge_count] = edges->positions[j];
+      edge_count++;
+    }
+  }
+  return edge_count;
+}
+
+long long compressedCrossings( CompressedGraphptr graph )
+{
+  ChannelEdges edges;
+  start_channel_edges( graph, & edges );
+  long long crossings = 0;
+  for ( int layer = 1; layer < graph->number_of_layers; layer++ ) {
+    int lower_size
+      = graph->layer_start[layer] - graph->layer_start[layer - 1];
+    int edge_count = decode_channel( graph, layer, & edges );
+    crossings += count_inversions_by_position( edges.upper_position,
+                                               edges.lower_position,
+                                               edge_count, lower_size,
+                                               NULL, edges.tree );
+  }
+  free_channel_edges( & edges );
+  return crossings;
+}
+
+int compressedBottleneckCrossings( CompressedGraphptr graph )
+{
+  ChannelEdges edges;
+  start_channel_edges( graph, & edges );
+  int bottleneck = 0;
+  for ( int layer = 1; layer < graph->number_of_layers; layer++ ) {
+    int lower_size
+      = graph->layer_start[layer] - graph->layer_start[layer - 1];
+    int edge_count = decode_channel( graph, layer, & edges );
+    count_inversions_by_position( edges.upper_position, edges.lower_position,
+                                  edge_count, lower_size,
+                                  edges.edge_crossings, edges.tree );
+    for ( int e = 0; e < edge_count; e++ )
+      if ( edges.edge_crossings[e] > bottleneck )
+        bottleneck = edges.edge_crossings[e];
+  }
+  free_channel_edges( & edges );
+  return bottleneck;
+}
+
+// ******** barycenter ************
+
+typedef struct weighted_node {
+  double weight;
+  int position;
+  int node;
+} WeightedNode;
+
+static int compare_weights( const void * ptr_i, const void * ptr_j )
+{
+  const WeightedNode * node_i = (const WeightedNode *) ptr_i;
+  const WeightedNode * node_j = (const WeightedNode *) ptr_j;
+  if ( node_i->weight < node_j->weight ) return -1;
+  if ( node_i->weight > node_j->weight ) return 1;
+  return node_i->position - node_j->position;
+}
+
+bool compressedBarycenterSort( CompressedGraphptr graph, int layer,
+                               Orientation orientation )
+{
+  int first = graph->layer_start[layer];
+  int size = graph->layer_start[layer + 1] - first;
+  if ( size < 2 ) return false;
+  WeightedNode * weighted
+    = (WeightedNode *) allocate( size, sizeof(WeightedNode) );
+  double * weights = (double *) allocate( size, sizeof(double) );
+  int * neighbors = (int *) allocate( graph->max_degree, sizeof(int) );
+  for ( int i = 0; i < size; i++ ) {
+    int node = graph->order[ first + i ];
+    int degree = 0;
+    if ( orientation == UPWARD && layer < graph->number_of_layers - 1 )
+      degree = decode_list( graph->up_stream + graph->up_offset[node],
+                            graph->up_stream + graph->up_offset[node + 1],
+                            graph->layer_start[layer + 1], neighbors );
+    else if ( orientation == DOWNWARD && layer > 0 )
+      degree = decode_list( graph->down_stream + graph->down_offset[node],
+                            graph->down_stream + graph->down_offset[node + 1],
+                            graph->layer_start[layer - 1], neighbors );
+    long long total = 0;
+    for ( int j = 0; j < degree; j++ )
+      total += graph->position[ neighbors[j] ];
+    bool isolated = graph->down_offset[node] == graph->down_offset[node + 1]
+      && graph->up_offset[node] == graph->up_offset[node + 1];
+    weighted[i].node = node;
+    weighted[i].position = i;
+    // -1 marks a node with no neighbors on that side, as in barycenter.c
+    if ( degree > 0 )
+      weights[i] = (double) total / degree;
+    else if ( isolated )
+      weights[i] = 0;
+    else
+      weights[i] = -1;
+  }
+  adjustWeights( weights, size, LEFT );
+  for ( int i = 0; i < size; i++ )
+    weighted[i].weight = weights[i];
+  qsort( weighted, size, sizeof(WeightedNode), compare_weights );
+  bool changed = false;
+  for ( int i = 0; i < size; i++ ) {
+    if ( weighted[i].position != i ) changed = true;
+    graph->order[ first + i ] = weighted[i].node;
+    graph->position[ weighted[i].node ] = i;
+  }
+  free( neighbors );
+  free( weights );
+  free( weighted );
+  return changed;
+}
+
+void saveCompressedOrder( CompressedGraphptr graph )
+{
+  memcpy( graph->best_position, graph->position,
+          graph->number_of_nodes * sizeof(int) );
+}
+
+void restoreCompressedOrder( CompressedGraphptr graph )
+{
+  memcpy( graph->position, graph->best_position,
+          graph->number_of_nodes * sizeof(int) );
+  for ( int layer = 0; layer < graph->number_of_layers; layer++ ) {
+    int first = graph->layer_start[layer];
+    for ( int node = first; node < graph->layer_start[layer + 1]; node++ )
+      graph->order[ first + graph->position[node] ] = node;
+  }
+}
+
+void writeCompressedSgf( FILE * out, CompressedGraphptr graph )
+{
+  if ( graph->comments != NULL ) {
+    const char * comment = graph->comments;
+    while ( *comment != '\0' ) {
+      const char * end = strchr( comment, '\n' );
+      fprintf( out, "c %.*s\n", (int) ( end - comment ), comment );
+      comment = end + 1;
+    }
+  }
+  fprintf( out, "t %s %d %lld %d\n", graph->name, graph->number_of_nodes,
+           graph->number_of_edges, graph->number_of_layers );
+  for ( int layer = 0; layer < graph->number_of_layers; layer++ )
+    for ( int node = graph->layer_start[layer];
+          node < graph->layer_start[layer + 1]; node++ )
+      fprintf( out, "n %d %d %d\n", graph->id[node], layer,
+               graph->position[node] );
+  int * neighbors = (int *) allocate( graph->max_degree, sizeof(int) );
+  for ( int layer = 1; layer < graph->number_of_layers; layer++ )
+    for ( int node = graph->layer_start[layer];
+          node < graph->layer_start[layer + 1]; node++ ) {
+      int degree
+        = decode_list( graph->down_stream + graph->down_offset[node],
+                       graph->down_stream + graph->down_offset[node + 1],
+                       graph->layer_start[layer - 1], neighbors );
+      for ( int j = 0; j < degree; j++ )
+        fprintf( out, "e %d %d\n", graph->id[ neighbors[j] ],
+                 graph->id[node] );
+    }
+  free( neighbors );
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,96 @@
+/**
+ * @file compressed.h
+ * @brief Compact storage of a layered graph for instances too large for
+ * the node and edge structs of graph.h, and the kernels that work on it.
+ *
+ * The nodes are numbered layer by layer, in order of their input position
+ * within each layer. The neighbors of a node on the layer below (down
+ * list) and on the layer above (up list) are stored as sorted lists of
+ * node numbers, each encoded as a sequence of varints (7 bits per byte,
+ * high bit set on all but the last byte of a number): the first number is
+ * the difference from the first node of the neighboring layer and each of
+ * the others is the difference from its predecessor. All down lists are in
+ * one byte stream, all up lists in another, in order of node number, so an
+ * edge takes about two to four bytes instead of an edge struct and two
+ * pointers. Edges have no record of their own; the positions of their
+ * endpoints and their crossing counts exist only while the crossings of a
+ * channel are counted.
+ *
+ * The kernels decode the lists sequentially as they go.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include<stdio.h>
+#include<stdbool.h>
+#include<stddef.h>
+
+#include"constants.h"
+
+typedef struct compressed_graph_struct * CompressedGraphptr;
+
+/**
+ * Reads a graph in sgf format from the named file, which is read twice
+ * and must therefore not be a pipe. While the lists are built, four bytes
+ * per edge endpoint are used temporarily. A fatal error occurs if a node
+ * position is out of range or repeated, or an edge is not between nodes
+ * on adjacent layers.
+ */
+CompressedGraphptr readCompressedSgf( const char * file_name );
+
+void freeCompressedGraph( CompressedGraphptr graph );
+
+const char * compressedGraphName( CompressedGraphptr graph );
+int compressedNumberOfNodes( CompressedGraphptr graph );
+long long compressedNumberOfEdges( CompressedGraphptr graph );
+int compressedNumberOfLayers( CompressedGraphptr graph );
+
+/**
+ * @return the number of bytes taken by the two adjacency streams
+ */
+size_t compressedAdjacencyBytes( CompressedGraphptr graph );
+
+/**
+ * @return the total number of crossings for the current order; each
+ * channel is counted in time proportional to its number of edges times the
+ * logarithm of the size of its lower layer
+ */
+long long compressedCrossings( CompressedGraphptr graph );
+
+/**
+ * @return the largest number of crossings of any edge for the current
+ * order; the crossings of the edges of one channel at a time are kept
+ */
+int compressedBottleneckCrossings( CompressedGraphptr graph );
+
+/**
+ * Sorts the layer by barycenter weights based on the neighbors below
+ * (DOWNWARD) or above (UPWARD), with the default weight adjustment of
+ * barycenter.c: a node with no neighbors on that side keeps the weight of
+ * the node to its left and an isolated node goes to the far left. Ties
+ * keep their current order.
+ * @return true if the order of the layer changed
+ */
+bool compressedBarycenterSort( CompressedGraphptr graph, int layer,
+                               Orientation orientation );
+
+/**
+ * Records the current order as the best one / puts the nodes back in the
+ * order last recorded
+ */
+void saveCompressedOrder( CompressedGraphptr graph );
+void restoreCompressedOrder( CompressedGraphptr graph );
+
+/**
+ * Writes the graph with its current order in sgf format; the comments of
+ * the input come first
+ */
+void writeCompressedSgf( FILE * out, CompressedGraphptr graph );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
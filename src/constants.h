@@ -22,6 +22,57 @@
  */
 #define CAPACITY_INCREMENT 32
 
+/**
+ * minimum number of nodes on a layer for the candidate positions of a
+ * sifted node to be evaluated in parallel (when more than one thread is
+ * requested with -T); can be overridden at compile time via DFLAGS
+ */
+#ifndef PARALLEL_SIFT_THRESHOLD
+#define PARALLEL_SIFT_THRESHOLD 4096
+#endif
+
+/**
+ * maximum number of nodes handled by a single task when a loop over the
+ * nodes of a layer is split among threads
+ */
+#define NODES_PER_TASK 2048
+
+/**
+ * maximum number of snapshots waiting for the helper thread with
+ * asynchronous evaluation (-A); the heuristic waits when there are more
+ */
+#define MAX_PENDING_SNAPSHOTS 16
+
+/**
+ * number of candidate orderings read before they are scored in parallel
+ * (-S option)
+ */
+#define SCORING_BATCH_SIZE 256
+
+/**
+ * maximum number of times the band workers (-B) minimize their bands and
+ * exchange the orders of the layers they moved; they stop earlier after two
+ * rounds in a row without fewer crossings
+ */
+#define BAND_EXCHANGE_ROUNDS 10
+
+/**
+ * maximum number of graphs in a batch and maximum size of each graph
+ * handled by the batch engine (batch.h); larger graphs are skipped
+ */
+#define BATCH_CAPACITY 256
+#define BATCH_MAX_NODES 64
+#define BATCH_MAX_EDGES 256
+#define BATCH_MAX_LAYERS BATCH_MAX_NODES
+
+/**
+ * maximum number of nodes on a layer for which the crossings of its
+ * channels are compared with the pairwise lower bound when solved layers
+ * are frozen (-L); the comparison takes time quadratic in the number of
+ * nodes when the bound is attained
+ */
+#define MAX_BOUND_LAYER_SIZE 256
+
 /**
  * Used with sorting heuristics to indicate whether weights are computed
  * based on edges above, below, or on both sides of a layer to be
@@ -31,4 +82,4 @@ typedef enum { UPWARD, DOWNWARD, BOTH } Orientation;
 
 #endif
 
-/*  [Last modified: 2020 12 18 at 16:12:01 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
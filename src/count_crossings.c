@@ -0,0 +1,521 @@
+/**
+ * @file count_crossings.c
+ * @brief Program that computes the crossings and stretch of a layered graph
+ * given as an sgf file while holding only two layers and the edges of one
+ * channel in memory.
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ *
+ * Usage: count_crossings [-c] SGF_FILE
+ *  -c  also print the number of crossings of each channel; these are kept,
+ *      one number per channel, until the whole graph has been counted
+ *
+ * Output (one value per line, same style as the statistics of
+ * minimization): graph name, number of layers, total crossings, bottleneck
+ * crossings, total stretch and bottleneck stretch.
+ *
+ * The channels are processed one at a time with the inversion counters of
+ * crossing_utilities.c and the stretch function of stretch.c; these see a
+ * "graph" consisting of just the two layers of the current channel. The
+ * file is read through two streams: one that moves through the nodes layer
+ * by layer and one that moves through the edges channel by channel.
+ *
+ * This works in a single pass if the nodes are grouped by layer and the
+ * edges by channel, both in increasing order, as is the case for files
+ * produced by our generators. If the file turns out not to be grouped the
+ * program starts over and reads the nodes and edges once for each channel,
+ * which needs no more memory but takes longer. The input must therefore be
+ * a file, not a pipe.
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<ctype.h>
+#include<unistd.h>              /* getopt() */
+#include<getopt.h>              /* for Linux */
+
+#include"defs.h"
+#include"graph.h"
+#include"crossing_utilities.h"
+#include"stretch.h"
+
+/**
+ * the two layers of the current channel; the stretch computation refers to
+ * layers[0] and layers[1] through the layer field of the nodes. The nodes
+ * of each layer are sorted by id, not by position.
+ */
+Layerptr * layers = NULL;
+
+static struct layer_struct lower_layer_struct;
+static struct layer_struct upper_layer_struct;
+static Layerptr window[2] = { & lower_layer_struct, & upper_layer_struct };
+
+/** node storage for the two layers (the layers point into these) */
+static struct node_struct * node_storage[2] = { NULL, NULL };
+static int node_capacity[2] = { 0, 0 };
+
+/** the edges of the current channel */
+static struct edge_struct * channel_edges = NULL;
+static Edgeptr * channel_edge_pointers = NULL;
+static int channel_edge_count = 0;
+static int channel_edge_capacity = 0;
+
+/** results */
+static char graph_name_buffer[MAX_NAME_LENGTH];
+static int layer_count = 0;
+static long long total_crossings = 0;
+static int bottleneck_crossings = 0;
+static double total_stretch = 0.0;
+static double bottleneck_stretch = 0.0;
+static int edges_counted = 0;
+static bool print_channels = false;
+
+/**
+ * crossings of each channel, indexed by its upper layer (-c); printed only
+ * after the pass that counts the whole graph
+ */
+static int * channel_crossings = NULL;
+static int channel_crossings_capacity = 0;
+
+/**
+ * A stream positioned somewhere in the node or edge section, with one line
+ * of lookahead
+ */
+typedef struct cursor_struct {
+  FILE * stream;
+  char line[MAX_NAME_LENGTH];
+  bool has_line;
+  /** position of the current line in the file */
+  long line_start;
+} * Cursorptr;
+
+static void printUsage( void ) {
+  fprintf( stderr, "Usage: count_crossings [-c] SGF_FILE\n" );
+  fprintf( stderr, " computes total and bottleneck crossings and stretch"
+           " of the graph in SGF_FILE\n" );
+  fprintf( stderr, " holding only one channel in memory at a time\n" );
+  fprintf( stderr, "  -c also print the crossings of each channel\n" );
+}
+
+static bool is_blank( const char * line ) {
+  while ( * line != '\0' ) {
+    if ( ! isspace( * line ) ) return false;
+    line++;
+  }
+  return true;
+}
+
+/**
+ * Reads the next nonblank line into the cursor
+ * @return true if there is one
+ */
+static bool advance( Cursorptr cursor ) {
+  cursor->has_line = false;
+  cursor->line_start = ftell( cursor->stream );
+  while ( fgets( cursor->line, MAX_NAME_LENGTH, cursor->stream ) != NULL ) {
+    if ( ! is_blank( cursor->line ) ) {
+      cursor->has_line = true;
+      break;
+    }
+    cursor->line_start = ftell( cursor->stream );
+  }
+  return cursor->has_line;
+}
+
+static void open_cursor( Cursorptr cursor, const char * file_name ) {
+  cursor->stream = fopen( file_name, "r" );
+  if ( cursor->stream == NULL ) {
+    fprintf( stderr, "*** FATAL: unable to open file %s\n", file_name );
+    exit( EXIT_FAILURE );
+  }
+  cursor->has_line = false;
+}
+
+/**
+ * Reads past the comments and the 't' line
+ * @return the position of the first node line
+ */
+static long read_header( Cursorptr cursor ) {
+  while ( advance( cursor ) && cursor->line[0] == 'c' )
+    ;
+  int nodes, edges;
+  if ( ! cursor->has_line
+       || sscanf( cursor->line, "t %s %d %d %d",
+                  graph_name_buffer, & nodes, & edges, & layer_count ) != 4 ) {
+    fprintf( stderr, "*** FATAL: bad or missing header information\n" );
+    exit( EXIT_FAILURE );
+  }
+  advance( cursor );
+  return cursor->line_start;
+}
+
+/**
+ * Moves a cursor to the given position and reads the line there
+ */
+static void seek_cursor( Cursorptr cursor, long position ) {
+  fseek( cursor->stream, position, SEEK_SET );
+  cursor->has_line = false;
+  advance( cursor );
+}
+
+/**
+ * Moves a cursor positioned in the node section to the first edge line
+ * @return the position of the first edge line
+ */
+static long skip_nodes( Cursorptr cursor ) {
+  while ( cursor->has_line && cursor->line[0] == 'n' )
+    advance( cursor );
+  if ( cursor->has_line && cursor->line[0] != 'e' ) {
+    fprintf( stderr, "*** FATAL: expected a line starting with 'e'"
+             " but got '%s'\n", cursor->line );
+    exit( EXIT_FAILURE );
+  }
+  return cursor->line_start;
+}
+
+static bool parse_node( Cursorptr cursor, int * id, int * layer,
+                        int * position ) {
+  if ( ! cursor->has_line || cursor->line[0] != 'n' ) return false;
+  if ( sscanf( cursor->line, "n %d %d %d", id, layer, position ) != 3 ) {
+    fprintf( stderr, "*** FATAL: incomplete node information '%s'\n",
+             cursor->line );
+    exit( EXIT_FAILURE );
+  }
+  return true;
+}
+
+static bool parse_edge( Cursorptr cursor, int * source, int * target ) {
+  if ( ! cursor->has_line ) return false;
+  if ( sscanf( cursor->line, "e %d %d", source, target ) != 2 ) {
+    fprintf( stderr, "*** FATAL: bad edge information '%s'\n",
+             cursor->line );
+    exit( EXIT_FAILURE );
+  }
+  return true;
+}
+
+static int compare_node_ids( const void * ptr_i, const void * ptr_j ) {
+  int id_i = (* (Nodeptr *) ptr_i)->id;
+  int id_j = (* (Nodeptr *) ptr_j)->id;
+  return ( id_i > id_j ) - ( id_i < id_j );
+}
+
+static int compare_id_to_node( const void * key, const void * element ) {
+  int id = * (const int *) key;
+  int node_id = (* (Nodeptr *) element)->id;
+  return ( id > node_id ) - ( id < node_id );
+}
+
+static void add_node_to_window( int slot, int id, int position ) {
+  Layerptr layer = window[slot];
+  if ( layer->number_of_nodes == node_capacity[slot] ) {
+    node_capacity[slot] = 2 * node_capacity[slot] + 16;
+    node_storage[slot]
+      = (struct node_struct *) realloc( node_storage[slot],
+                                        node_capacity[slot]
+                                        * sizeof(struct node_struct) );
+    layer->nodes = (Nodeptr *) realloc( layer->nodes,
+                                        node_capacity[slot]
+                                        * sizeof(Nodeptr) );
+  }
+  struct node_struct * node = node_storage[slot] + layer->number_of_nodes;
+  memset( node, 0, sizeof(struct node_struct) );
+  node->id = id;
+  node->layer = slot;
+  node->position = position;
+  layer->number_of_nodes++;
+}
+
+/**
+ * Makes the node pointers of a window layer valid (storage may have moved)
+ * and sorts them by id
+ */
+static void finish_window_layer( int slot ) {
+  Layerptr layer = window[slot];
+  for ( int i = 0; i < layer->number_of_nodes; i++ )
+    layer->nodes[i] = node_storage[slot] + i;
+  qsort( layer->nodes, layer->number_of_nodes, sizeof(Nodeptr),
+         compare_node_ids );
+  for ( int i = 1; i < layer->number_of_nodes; i++ )
+    if ( layer->nodes[i]->id == layer->nodes[i - 1]->id ) {
+      fprintf( stderr, "*** FATAL: duplicate node %d\n", layer->nodes[i]->id );
+      exit( EXIT_FAILURE );
+    }
+}
+
+static Nodeptr find_in_window( int slot, int id ) {
+  Layerptr layer = window[slot];
+  Nodeptr * found = (Nodeptr *) bsearch( & id, layer->nodes,
+                                         layer->number_of_nodes,
+                                         sizeof(Nodeptr), compare_id_to_node );
+  return found == NULL ? NULL : * found;
+}
+
+/**
+ * Moves the upper layer of the window to the lower one; the nodes are
+ * exchanged with the storage of the old lower layer, which is reused
+ */
+static void shift_window( void ) {
+  struct layer_struct old_lower = lower_layer_struct;
+  lower_layer_struct = upper_layer_struct;
+  upper_layer_struct = old_lower;
+  upper_layer_struct.number_of_nodes = 0;
+
+  struct node_struct * old_storage = node_storage[0];
+  node_storage[0] = node_storage[1];
+  node_storage[1] = old_storage;
+  int old_capacity = node_capacity[0];
+  node_capacity[0] = node_capacity[1];
+  node_capacity[1] = old_capacity;
+
+  for ( int i = 0; i < lower_layer_struct.number_of_nodes; i++ )
+    node_storage[0][i].layer = 0;
+}
+
+/**
+ * Adds an edge to the current channel if both endpoints are in the window,
+ * on different layers
+ * @return true if the edge was added
+ */
+static bool add_edge_if_in_channel( int source, int target ) {
+  Nodeptr source_lower = find_in_window( 0, source );
+  Nodeptr source_upper = source_lower == NULL
+    ? find_in_window( 1, source ) : NULL;
+  Nodeptr target_lower = find_in_window( 0, target );
+  Nodeptr target_upper = target_lower == NULL
+    ? find_in_window( 1, target ) : NULL;
+  Nodeptr down_node = NULL;
+  Nodeptr up_node = NULL;
+  if ( source_lower != NULL && target_upper != NULL ) {
+    down_node = source_lower;
+    up_node = target_upper;
+  }
+  else if ( target_lower != NULL && source_upper != NULL ) {
+    down_node = target_lower;
+    up_node = source_upper;
+  }
+  else return false;
+
+  if ( channel_edge_count == channel_edge_capacity ) {
+    channel_edge_capacity = 2 * channel_edge_capacity + 16;
+    channel_edges
+      = (struct edge_struct *) realloc( channel_edges,
+                                        channel_edge_capacity
+                                        * sizeof(struct edge_struct) );
+    channel_edge_pointers
+      = (Edgeptr *) realloc( channel_edge_pointers,
+                             channel_edge_capacity * sizeof(Edgeptr) );
+  }
+  Edgeptr edge = channel_edges + channel_edge_count++;
+  memset( edge, 0, sizeof(struct edge_struct) );
+  edge->down_node = down_node;
+  edge->up_node = up_node;
+  return true;
+}
+
+/**
+ * sorts edges lexicographically by the positions of their up and down
+ * nodes, as updateCrossingsBetweenLayers() does before counting
+ */
+static int compare_edge_positions( const void * ptr_i, const void * ptr_j ) {
+  Edgeptr edge_i = * (Edgeptr *) ptr_i;
+  Edgeptr edge_j = * (Edgeptr *) ptr_j;
+  int key_i = edge_i->up_node->position;
+  int key_j = edge_j->up_node->position;
+  if ( key_i == key_j ) {
+    key_i = edge_i->down_node->position;
+    key_j = edge_j->down_node->position;
+  }
+  return ( key_i > key_j ) - ( key_i < key_j );
+}
+
+/**
+ * Counts the crossings and stretch of the edges of the current channel and
+ * adds them to the totals; upper_layer is its number in the whole graph
+ */
+static void count_channel( int upper_layer ) {
+  for ( int i = 0; i < channel_edge_count; i++ )
+    channel_edge_pointers[i] = channel_edges + i;
+  qsort( channel_edge_pointers, channel_edge_count, sizeof(Edgeptr),
+         compare_edge_positions );
+  int crossings = count_inversions_down( channel_edge_pointers,
+                                         channel_edge_count, 1 );
+  total_crossings += crossings;
+  for ( int i = 0; i < channel_edge_count; i++ ) {
+    Edgeptr edge = channel_edge_pointers[i];
+    if ( edge->crossings > bottleneck_crossings )
+      bottleneck_crossings = edge->crossings;
+    double edge_stretch = stretch( edge );
+    total_stretch += edge_stretch;
+    if ( edge_stretch > bottleneck_stretch )
+      bottleneck_stretch = edge_stretch;
+  }
+  edges_counted += channel_edge_count;
+  if ( print_channels ) {
+    if ( upper_layer >= channel_crossings_capacity ) {
+      channel_crossings_capacity = 2 * upper_layer + 1;
+      channel_crossings
+        = (int *) realloc( channel_crossings,
+                           channel_crossings_capacity * sizeof(int) );
+    }
+    channel_crossings[ upper_layer ] = crossings;
+  }
+  channel_edge_count = 0;
+}
+
+static void reset_totals( void ) {
+  total_crossings = 0;
+  bottleneck_crossings = 0;
+  total_stretch = 0.0;
+  bottleneck_stretch = 0.0;
+  edges_counted = 0;
+  channel_edge_count = 0;
+  lower_layer_struct.number_of_nodes = 0;
+  upper_layer_struct.number_of_nodes = 0;
+}
+
+/**
+ * Reads the nodes of the given layer from a cursor whose nodes are grouped
+ * by layer into a slot of the window
+ * @return false if a node of an earlier layer appears, i.e., the nodes are
+ * not grouped
+ */
+static bool read_grouped_layer( Cursorptr node_cursor, int layer, int slot ) {
+  int id, node_layer, position;
+  while ( parse_node( node_cursor, & id, & node_layer, & position ) ) {
+    if ( node_layer < layer ) return false;
+    if ( node_layer > layer ) break;
+    add_node_to_window( slot, id, position );
+    advance( node_cursor );
+  }
+  finish_window_layer( slot );
+  return true;
+}
+
+/**
+ * Single pass for files with nodes grouped by layer and edges by channel
+ * @return false if the file turns out not to be grouped; the totals are
+ * then incomplete
+ */
+static bool count_grouped( Cursorptr node_cursor, Cursorptr edge_cursor,
+                           int edge_lines ) {
+  int id, node_layer, position;
+  if ( ! read_grouped_layer( node_cursor, 0, 0 ) ) return false;
+  int layer = 1;
+  while ( parse_node( node_cursor, & id, & node_layer, & position ) ) {
+    // layers without nodes still form channels
+    for ( ; layer < node_layer; layer++ ) {
+      read_grouped_layer( node_cursor, layer, 1 );
+      count_channel( layer );
+      shift_window();
+    }
+    if ( ! read_grouped_layer( node_cursor, layer, 1 ) ) return false;
+    int source, target;
+    while ( parse_edge( edge_cursor, & source, & target )
+            && add_edge_if_in_channel( source, target ) )
+      advance( edge_cursor );
+    count_channel( layer );
+    shift_window();
+    layer++;
+  }
+  layer_count = layer;
+  return edges_counted == edge_lines;
+}
+
+/**
+ * Reads the nodes and edges once for each channel; works for any order of
+ * the lines
+ */
+static void count_by_rescanning( Cursorptr node_cursor, long node_start,
+                                 Cursorptr edge_cursor, long edge_start ) {
+  int id, node_layer, position;
+  int max_layer = 0;
+  seek_cursor( node_cursor, node_start );
+  while ( parse_node( node_cursor, & id, & node_layer, & position ) ) {
+    if ( node_layer > max_layer ) max_layer = node_layer;
+    advance( node_cursor );
+  }
+  layer_count = max_layer + 1;
+
+  for ( int layer = 0; layer < layer_count; layer++ ) {
+    int slot = layer == 0 ? 0 : 1;
+    seek_cursor( node_cursor, node_start );
+    while ( parse_node( node_cursor, & id, & node_layer, & position ) ) {
+      if ( node_layer == layer ) add_node_to_window( slot, id, position );
+      advance( node_cursor );
+    }
+    finish_window_layer( slot );
+    if ( layer == 0 ) continue;
+    int source, target;
+    seek_cursor( edge_cursor, edge_start );
+    while ( parse_edge( edge_cursor, & source, & target ) ) {
+      add_edge_if_in_channel( source, target );
+      advance( edge_cursor );
+    }
+    count_channel( layer );
+    shift_window();
+  }
+}
+
+int main( int argc, char * argv[] ) {
+  int option;
+  while ( ( option = getopt( argc, argv, "c" ) ) != -1 ) {
+    if ( option == 'c' ) print_channels = true;
+    else {
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+  if ( optind != argc - 1 ) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+  const char * file_name = argv[optind];
+  layers = window;
+
+  struct cursor_struct node_cursor;
+  struct cursor_struct edge_cursor;
+  open_cursor( & node_cursor, file_name );
+  open_cursor( & edge_cursor, file_name );
+  long node_start = read_header( & node_cursor );
+  seek_cursor( & edge_cursor, node_start );
+  long edge_start = skip_nodes( & edge_cursor );
+
+  // pre-pass: the number of edges tells whether the single pass saw them all
+  int edge_lines = 0;
+  while ( edge_cursor.has_line ) {
+    edge_lines++;
+    advance( & edge_cursor );
+  }
+  seek_cursor( & edge_cursor, edge_start );
+
+  if ( ! count_grouped( & node_cursor, & edge_cursor, edge_lines ) ) {
+    fprintf( stderr, "--- nodes not grouped by layer or edges not grouped"
+             " by channel; reading the file once per channel\n" );
+    reset_totals();
+    count_by_rescanning( & node_cursor, node_start,
+                         & edge_cursor, edge_start );
+  }
+
+  if ( edges_counted != edge_lines )
+    fprintf( stderr, "*** Warning: %d of %d edges are not between nodes"
+             " on adjacent layers\n", edge_lines - edges_counted, edge_lines );
+
+  if ( print_channels )
+    for ( int layer = 1; layer < layer_count; layer++ )
+      printf( "ChannelCrossings,%d,%d\n", layer, channel_crossings[ layer ] );
+  printf( "GraphName,%s\n", graph_name_buffer );
+  printf( "NumberOfLayers,%d\n", layer_count );
+  printf( "Crossings,%lld\n", total_crossings );
+  printf( "BottleneckCrossings,%d\n", bottleneck_crossings );
+  printf( "Stretch,%f\n", total_stretch );
+  printf( "BottleneckStretch,%f\n", bottleneck_stretch );
+
+  fclose( node_cursor.stream );
+  fclose( edge_cursor.stream );
+  free( channel_crossings );
+  return EXIT_SUCCESS;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -1,5 +1,5 @@
 /**
- * @file crossings.c
+ * @file crossing_utilities.c
  * @brief Implementation of functions that are used to count and update
  * crossings locally.
  *
@@ -12,9 +12,11 @@
 #include"defs.h"
 #include"crossing_utilities.h"
 #include"sorting.h"
+#include"transaction.h"
 
 #include<stdio.h>
 #include<stdlib.h>
+#include<string.h>
 #include<assert.h>
 
 #ifdef DEBUG
@@ -39,6 +41,11 @@ static void print_edge_array( Edgeptr * edge_array, int number_of_edges )
       printf("\n");
     }
 }
+
+#define TRACE_EDGE_ARRAY( message, edge_array, number_of_edges ) \
+  { printf( message ); print_edge_array( edge_array, number_of_edges ); }
+#else
+#define TRACE_EDGE_ARRAY( message, edge_array, number_of_edges )
 #endif
 
 /**
@@ -60,89 +67,161 @@ static void update_crossings( Edgeptr edge_one, Edgeptr edge_two, int diff )
   up_node_two->down_crossings += diff;
   down_node_one->up_crossings += diff;
   down_node_two->up_crossings += diff;
+  if ( transaction_depth > 0 )
+    logCrossingsChange( edge_one, edge_two, diff );
 }
 
-int insert_and_count_inversions_down( Edgeptr * edge_array,
-                                      int starting_index,
-                                      int diff )
+/**
+ * Same as update_crossings() except that only the counts of the endpoints
+ * are updated; used when per-edge counts are not needed, so the change is
+ * not logged.
+ */
+static void update_node_crossings( Edgeptr edge_one, Edgeptr edge_two,
+                                   int diff )
 {
-  int number_of_crossings = 0;
-  int index = starting_index - 1;
-  Edgeptr edge_to_insert = edge_array[starting_index];
-  while( index >= 0
-         && edge_array[index]->down_node->position
-         > edge_to_insert->down_node->position )
-    {
-      number_of_crossings++;
-      update_crossings( edge_array[index], edge_to_insert, diff );
-      edge_array[index + 1] = edge_array[index];
-      index--;
-    }
-  edge_array[index + 1] = edge_to_insert;
-  return number_of_crossings;
+  edge_one->up_node->down_crossings += diff;
+  edge_two->up_node->down_crossings += diff;
+  edge_one->down_node->up_crossings += diff;
+  edge_two->down_node->up_crossings += diff;
 }
 
-int count_inversions_down( Edgeptr * edge_array, int number_of_edges, int diff )
+/**
+ * The inversion counters for the two directions differ only in which
+ * endpoint of an edge supplies the sort key, and the counters that maintain
+ * per-edge crossings (needed for bottleneck crossings and the mce family)
+ * differ from those that maintain node crossings only (mcn) and those that
+ * only count (total crossings) only in the update done for each inversion.
+ * All variants are generated from the single definition below so that the
+ * key and the update are resolved at compile time: no function pointers and
+ * no per-element tests of the direction.
+ *
+ * @param direction up or down; names the endpoint used as the key
+ * @param suffix appended to the generated function names
+ * @param UPDATE the action taken for each inversion (one of the three
+ * macros that follow)
+ */
+#define DEFINE_INVERSION_COUNTERS( direction, suffix, UPDATE )          \
+  int insert_and_count_inversions_ ## direction ## suffix               \
+  ( Edgeptr * edge_array, int starting_index, int diff )                \
+  {                                                                     \
+    int number_of_crossings = 0;                                        \
+    int index = starting_index - 1;                                     \
+    Edgeptr edge_to_insert = edge_array[starting_index];                \
+    int key = edge_to_insert->direction ## _node->position;             \
+    while( index >= 0                                                   \
+           && edge_array[index]->direction ## _node->position > key )   \
+      {                                                                 \
+        number_of_crossings++;                                          \
+        UPDATE( edge_array[index], edge_to_insert, diff );              \
+        edge_array[index + 1] = edge_array[index];                      \
+        index--;                                                        \
+      }                                                                 \
+    edge_array[index + 1] = edge_to_insert;                             \
+    return number_of_crossings;                                         \
+  }                                                                     \
+                                                                        \
+  int count_inversions_ ## direction ## suffix                          \
+  ( Edgeptr * edge_array, int number_of_edges, int diff )               \
+  {                                                                     \
+    TRACE_EDGE_ARRAY( "-> count_inversions_" #direction #suffix "\n",   \
+                      edge_array, number_of_edges );                    \
+    int number_of_inversions = 0;                                       \
+    for( int i = 1; i < number_of_edges; i++ )                          \
+      {                                                                 \
+        number_of_inversions                                            \
+          += insert_and_count_inversions_ ## direction ## suffix        \
+          ( edge_array, i, diff );                                      \
+      }                                                                 \
+    TRACE_EDGE_ARRAY( "<- count_inversions_" #direction #suffix "\n",   \
+                      edge_array, number_of_edges );                    \
+    return number_of_inversions;                                        \
+  }
+
+/** per-inversion action of the counters that maintain per-edge crossings */
+#define UPDATE_EDGE_CROSSINGS( edge_one, edge_two, diff ) \
+  update_crossings( edge_one, edge_two, diff )
+
+/** per-inversion action of the counters that maintain node crossings only */
+#define UPDATE_NODE_CROSSINGS( edge_one, edge_two, diff ) \
+  update_node_crossings( edge_one, edge_two, diff )
+
+/** per-inversion action of the counters that compute totals only */
+#define COUNT_ONLY( edge_one, edge_two, diff )
+
+DEFINE_INVERSION_COUNTERS( up, , UPDATE_EDGE_CROSSINGS )
+DEFINE_INVERSION_COUNTERS( down, , UPDATE_EDGE_CROSSINGS )
+DEFINE_INVERSION_COUNTERS( up, _total, COUNT_ONLY )
+DEFINE_INVERSION_COUNTERS( down, _total, COUNT_ONLY )
+DEFINE_INVERSION_COUNTERS( up, _nodes, UPDATE_NODE_CROSSINGS )
+DEFINE_INVERSION_COUNTERS( down, _nodes, UPDATE_NODE_CROSSINGS )
+
+/**
+ * Adds an entry at the given position, 0, ..., size - 1, of a Fenwick tree
+ * stored from index 1
+ */
+static void fenwick_add( int * tree, int size, int position )
 {
-#ifdef DEBUG
-  printf("-> count_inversions_down\n");
-  printf( " edge array for upper layer %d:\n",
-          edge_array[0]->up_node->layer );
-  print_edge_array( edge_array, number_of_edges );
-#endif
-  int number_of_inversions = 0;
-  int i = 1;
-  for( ; i < number_of_edges; i++ )
-    {
-      number_of_inversions
-        += insert_and_count_inversions_down( edge_array, i, diff );
-    }
-#ifdef DEBUG
-  printf("<- count_inversions_down, number = %d\n", number_of_inversions);
-  printf( " edge array for upper layer %d:\n", 
-          edge_array[0]->up_node->layer );
-  print_edge_array( edge_array, number_of_edges );
-#endif
-  return number_of_inversions;
+  for ( int i = position + 1; i <= size; i += i & -i )
+    tree[i]++;
 }
 
-int insert_and_count_inversions_up( Edgeptr * edge_array,
-                                    int starting_index, int diff )
+/**
+ * @return the number of entries at positions 0, ..., position
+ */
+static int fenwick_prefix( const int * tree, int position )
 {
-  int number_of_crossings = 0;
-  int index = starting_index - 1;
-  Edgeptr edge_to_insert = edge_array[starting_index];
-  while( index >= 0
-         && edge_array[index]->up_node->position
-         > edge_to_insert->up_node->position )
-    {
-      number_of_crossings++;
-      update_crossings( edge_array[index], edge_to_insert, diff );
-      edge_array[index + 1] = edge_array[index];
-      index--;
-    }
-  edge_array[index + 1] = edge_to_insert;
-  return number_of_crossings;
+  int count = 0;
+  for ( int i = position + 1; i > 0; i -= i & -i )
+    count += tree[i];
+  return count;
 }
 
-int count_inversions_up( Edgeptr * edge_array, int number_of_edges, int diff  )
+long long count_inversions_by_position( const int * upper_positions,
+                                        const int * lower_positions,
+                                        int number_of_edges, int lower_size,
+                                        int * edge_crossings, int * tree )
 {
-#ifdef DEBUG
-  printf("-> count_inversions_up\n");
-  print_edge_array( edge_array, number_of_edges );
-#endif
-  int number_of_inversions = 0;
-  int i = 1;
-  for( ; i < number_of_edges; i++ )
+  // crossings with edges whose upper endpoint is to the left; edges with
+  // the same upper endpoint are all counted before any is added
+  long long number_of_crossings = 0;
+  memset( tree, 0, ( lower_size + 1 ) * sizeof(int) );
+  int group_start = 0;
+  while ( group_start < number_of_edges )
     {
-      number_of_inversions
-        += insert_and_count_inversions_up( edge_array, i, diff );
+      int group_end = group_start;
+      while ( group_end < number_of_edges
+              && upper_positions[group_end] == upper_positions[group_start] )
+        group_end++;
+      for ( int i = group_start; i < group_end; i++ )
+        {
+          int crossings
+            = group_start - fenwick_prefix( tree, lower_positions[i] );
+          number_of_crossings += crossings;
+          if ( edge_crossings != NULL ) edge_crossings[i] = crossings;
+        }
+      for ( int i = group_start; i < group_end; i++ )
+        fenwick_add( tree, lower_size, lower_positions[i] );
+      group_start = group_end;
     }
-#ifdef DEBUG
-  printf("<- count_inversions_up, number = %d\n", number_of_inversions);
-  print_edge_array( edge_array, number_of_edges );
-#endif
-  return number_of_inversions;
+  if ( edge_crossings == NULL ) return number_of_crossings;
+
+  // crossings with edges whose upper endpoint is to the right
+  memset( tree, 0, ( lower_size + 1 ) * sizeof(int) );
+  int group_end = number_of_edges;
+  while ( group_end > 0 )
+    {
+      group_start = group_end - 1;
+      while ( group_start > 0
+              && upper_positions[group_start - 1]
+              == upper_positions[group_end - 1] )
+        group_start--;
+      for ( int i = group_start; i < group_end; i++ )
+        edge_crossings[i] += fenwick_prefix( tree, lower_positions[i] - 1 );
+      for ( int i = group_start; i < group_end; i++ )
+        fenwick_add( tree, lower_size, lower_positions[i] );
+      group_end = group_start;
+    }
+  return number_of_crossings;
 }
 
 void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
@@ -155,4 +234,4 @@ void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
     }
 }
 
-/*  [Last modified: 2014 03 10 at 16:39:24 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
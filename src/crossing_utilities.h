@@ -68,6 +68,83 @@ int insert_and_count_inversions_down( Edgeptr * edge_array,
                                       int starting_index,
                                       int diff );
 
+/**
+ * Same as count_inversions_up() except that only the total is computed;
+ * crossing counts of edges and nodes are left unchanged and diff is ignored.
+ */
+int count_inversions_up_total( Edgeptr * edge_array, int number_of_edges,
+                               int diff );
+
+/**
+ * Same as insert_and_count_inversions_up(), but only counts
+ */
+int insert_and_count_inversions_up_total( Edgeptr * edge_array,
+                                          int starting_index,
+                                          int diff );
+
+/**
+ * Same as count_inversions_down() except that only the total is computed;
+ * crossing counts of edges and nodes are left unchanged and diff is ignored.
+ */
+int count_inversions_down_total( Edgeptr * edge_array, int number_of_edges,
+                                 int diff );
+
+/**
+ * Same as insert_and_count_inversions_down(), but only counts
+ */
+int insert_and_count_inversions_down_total( Edgeptr * edge_array,
+                                            int starting_index,
+                                            int diff );
+
+/**
+ * Same as count_inversions_up() except that only the crossing counts of the
+ * nodes are updated; those of the edges are left unchanged.
+ */
+int count_inversions_up_nodes( Edgeptr * edge_array, int number_of_edges,
+                               int diff );
+
+/**
+ * Same as insert_and_count_inversions_up(), but updates only node counts
+ */
+int insert_and_count_inversions_up_nodes( Edgeptr * edge_array,
+                                          int starting_index,
+                                          int diff );
+
+/**
+ * Same as count_inversions_down() except that only the crossing counts of
+ * the nodes are updated; those of the edges are left unchanged.
+ */
+int count_inversions_down_nodes( Edgeptr * edge_array, int number_of_edges,
+                                 int diff );
+
+/**
+ * Same as insert_and_count_inversions_down(), but updates only node counts
+ */
+int insert_and_count_inversions_down_nodes( Edgeptr * edge_array,
+                                            int starting_index,
+                                            int diff );
+
+/**
+ * Counts the crossings among the edges of a channel given only by the
+ * positions of their endpoints, using a Fenwick tree over the positions of
+ * the lower layer instead of an insertion sort: the time is proportional to
+ * the number of edges times the logarithm of lower_size. Edges with a
+ * common endpoint do not cross.
+ *
+ * @param upper_positions, lower_positions the positions of the upper and
+ * lower endpoint of each edge; the edges must be sorted by upper position
+ * @param lower_size the number of nodes on the lower layer
+ * @param edge_crossings if not NULL, receives the number of crossings of
+ * each edge, which takes a second scan of the edges
+ * @param tree scratch space for lower_size + 1 ints
+ *
+ * @return the total number of crossings
+ */
+long long count_inversions_by_position( const int * upper_positions,
+                                        const int * lower_positions,
+                                        int number_of_edges, int lower_size,
+                                        int * edge_crossings, int * tree );
+
 /**
  * Adds edges to an array of edges. Assumes that there is enough space in the
  * array. Similar to strcat()
@@ -82,4 +159,4 @@ void add_edges_to_array( Edgeptr * edge_array, Edgeptr * edges_to_add,
 
 #endif
 
-/*  [Last modified: 2014 03 10 at 16:37:54 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -19,6 +19,9 @@
 #include"heuristics.h"
 #include"sorting.h"
 #include"random.h"
+#include"tasks.h"
+#include"transaction.h"
+#include"freeze.h"
 
 #include<stdio.h>
 #include<stdlib.h>
@@ -38,6 +41,15 @@ typedef struct inter_layer_struct {
    */
   Edgeptr * edges;
   int number_of_crossings;
+  /**
+   * versions of the upper and lower layer when the crossings were last
+   * counted; only meaningful if counted is true
+   */
+  unsigned int upper_version;
+  unsigned int lower_version;
+  bool counted;
+  /** the counts maintained when the crossings were last counted */
+  CrossingCounts counts;
 } * InterLayerptr;
 
 /**
@@ -46,6 +58,22 @@ typedef struct inter_layer_struct {
  */
 static InterLayerptr * between_layers;
 
+/** counts maintained by updateCrossingsBetweenLayers() */
+static CrossingCounts crossing_counts = EDGE_COUNTS;
+
+/** counts wanted by the tasks of ensureCrossingCounts() */
+static CrossingCounts counts_to_ensure;
+
+void setCrossingCounts( CrossingCounts counts )
+{
+  crossing_counts = counts;
+}
+
+CrossingCounts crossingCounts( void )
+{
+  return crossing_counts;
+}
+
 // ******** Allocation functions for initCrossings() ************
 
 static int count_down_edges( int layer_number )
@@ -112,9 +140,15 @@ int numberOfCrossings( void )
 
 int maxEdgeCrossings( void )
 {
+  // maxCrossingsEdgeStatic() ensures the edge counts
   return maxCrossingsEdgeStatic()->crossings;
 }
 
+int numberOfCrossingsChannel( int upper_layer )
+{
+  return between_layers[ upper_layer ]->number_of_crossings;
+}
+
 /**
  * @return the number of crossings for the given layer
  */
@@ -144,13 +178,43 @@ int numberOfCrossingsEdge( Edgeptr edge )
   return edge->crossings;
 }
 
+/**
+ * Task for updateAllCrossings(): channels can be counted independently
+ * since each one touches only its own edges, the down crossings of nodes on
+ * its upper layer and the up crossings of nodes on its lower layer
+ */
+static void update_channel_task( void * upper_layer )
+{
+  updateCrossingsBetweenLayers( (int) (long) upper_layer );
+}
+
+bool isCurrentChannel( int upper_layer )
+{
+  InterLayerptr channel = between_layers[ upper_layer ];
+  return channel->counted
+    && channel->upper_version == layers[ upper_layer ]->version
+    && channel->lower_version == layers[ upper_layer - 1 ]->version;
+}
+
 void updateAllCrossings( void )
 {
     //  updateAllPositions();
+  // changes logged in a transaction must stay in sequence
+  if ( transaction_depth > 0 ) {
+    for( int i = 1; i < number_of_layers; i++ )
+      {
+        if ( ! isCurrentChannel( i ) ) updateCrossingsBetweenLayers( i );
+      }
+    return;
+  }
+  struct task_group channels;
+  beginTasks( &channels );
   for( int i = 1; i < number_of_layers; i++ )
     {
-      updateCrossingsBetweenLayers( i );
+      if ( isCurrentChannel( i ) ) continue;
+      forkTask( &channels, update_channel_task, (void *) (long) i );
     }
+  joinTasks( &channels );
 }
 
 void updateCrossingsForLayer( int layer )
@@ -163,10 +227,12 @@ void updateCrossingsForLayer( int layer )
 
 /**
  * Sets all node crossings relevant to the edges between layers upper_layer
- * and upper_layer - 1 to 0
+ * and upper_layer - 1 to 0, and the crossings of the edges as well if
+ * counts is EDGE_COUNTS; nothing is done for TOTAL_COUNTS
  */
-static void initialize_crossings( int upper_layer )
+static void initialize_crossings( int upper_layer, CrossingCounts counts )
 {
+  if ( counts == TOTAL_COUNTS ) return;
   Layerptr up_layer = layers[ upper_layer ];
   Layerptr down_layer = layers[ upper_layer - 1 ];
   Nodeptr * upper_nodes = up_layer->nodes;
@@ -177,25 +243,26 @@ static void initialize_crossings( int upper_layer )
   for( ; i < upper_node_count; i++ )
     {
       upper_nodes[i]->down_crossings = 0;
+      if ( counts != EDGE_COUNTS ) continue;
       int j = 0;
       for( ; j < upper_nodes[i]->down_degree; j++ )
         {
           upper_nodes[i]->down_edges[j]->crossings = 0;
         }
     }
-  for( ; i < lower_node_count; i++ )
+  for( i = 0; i < lower_node_count; i++ )
     {
       lower_nodes[i]->up_crossings = 0;
     } 
 }
 
 /**
- * Updates crossings between two adjacent layers. Also updates the relevant
- * crossing fields of the two layers.
+ * Counts crossings between two adjacent layers, maintaining the given
+ * counts of their nodes and edges.
  * @param upper_layer the higher of the two layers; crossings between layers
  * upper_layer - 1 and upper_layer are counted
  */
-void updateCrossingsBetweenLayers( int upper_layer )
+static void count_channel( int upper_layer, CrossingCounts counts )
 {
   // sort edges lexicographically based primarily on upper layer endpoints
   Layerptr layer = layers[ upper_layer ];
@@ -209,11 +276,67 @@ void updateCrossingsBetweenLayers( int upper_layer )
                           node->down_edges, node->down_degree, edge_index );
       edge_index += node->down_degree;
     }
-  initialize_crossings( upper_layer );
-  between_layers[ upper_layer ]->number_of_crossings
-    = count_inversions_down( between_layers[ upper_layer ]->edges,
-                             between_layers[ upper_layer ]->number_of_edges,
-                             1 );
+  initialize_crossings( upper_layer, counts );
+  InterLayerptr channel = between_layers[ upper_layer ];
+  if ( counts == TOTAL_COUNTS )
+    channel->number_of_crossings
+      = count_inversions_down_total( channel->edges,
+                                     channel->number_of_edges, 1 );
+  else if ( counts == NODE_COUNTS )
+    channel->number_of_crossings
+      = count_inversions_down_nodes( channel->edges,
+                                     channel->number_of_edges, 1 );
+  else
+    channel->number_of_crossings
+      = count_inversions_down( channel->edges, channel->number_of_edges, 1 );
+  channel->upper_version = layers[ upper_layer ]->version;
+  channel->lower_version = layers[ upper_layer - 1 ]->version;
+  channel->counted = true;
+  channel->counts = counts;
+}
+
+/**
+ * Updates crossings between two adjacent layers. Also updates the relevant
+ * crossing fields of the two layers, as far as crossing_counts asks.
+ * @param upper_layer the higher of the two layers; crossings between layers
+ * upper_layer - 1 and upper_layer are counted
+ */
+void updateCrossingsBetweenLayers( int upper_layer )
+{
+  count_channel( upper_layer, crossing_counts );
+}
+
+/**
+ * Task for ensureCrossingCounts()
+ */
+static void ensure_channel_task( void * upper_layer )
+{
+  count_channel( (int) (long) upper_layer, counts_to_ensure );
+}
+
+void ensureCrossingCounts( CrossingCounts counts )
+{
+  if ( crossing_counts >= counts ) return;
+  counts_to_ensure = counts;
+  // changes logged in a transaction must stay in sequence
+  if ( transaction_depth > 0 ) {
+    for ( int i = 1; i < number_of_layers; i++ )
+      {
+        InterLayerptr channel = between_layers[ i ];
+        if ( channel->counted && channel->counts >= counts ) continue;
+        count_channel( i, counts );
+      }
+    return;
+  }
+  struct task_group channels;
+  beginTasks( &channels );
+  for ( int i = 1; i < number_of_layers; i++ )
+    {
+      InterLayerptr channel = between_layers[ i ];
+      if ( channel->counted && channel->counts >= counts ) continue;
+      forkTask( &channels, ensure_channel_task, (void *) (long) i );
+    }
+  joinTasks( &channels );
 }
 
 int maxCrossingsLayer( void ) {
@@ -229,7 +352,7 @@ int maxCrossingsLayer( void ) {
   for( int i = 0; i < number_of_layers; i++ ) {
     int layer = layer_sequence[i];
     if( numberOfCrossingsLayer( layer ) > max_crossings 
-        && ! isFixedLayer( layer ) ) {
+        && ! isFixedLayer( layer ) && ! isFrozenLayer( layer ) ) {
           max_crossings = numberOfCrossingsLayer( layer );
           max_crossings_layer = layer;
     }
@@ -239,6 +362,7 @@ int maxCrossingsLayer( void ) {
 }
 
 Nodeptr maxCrossingsNode( void ) {
+  ensureCrossingCounts( NODE_COUNTS );
   if ( randomize_order ) {
     genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
   }
@@ -259,6 +383,7 @@ Nodeptr maxCrossingsNode( void ) {
 }
 
 Edgeptr maxCrossingsEdge( void ) {
+  ensureCrossingCounts( EDGE_COUNTS );
   Edgeptr max_crossings_edge = NULL;
   int max_crossings = -1;
   if ( randomize_order ) {
@@ -284,6 +409,7 @@ Edgeptr maxCrossingsEdge( void ) {
  * maintained on a per channel basis
  */
 Edgeptr maxCrossingsEdgeStatic( void ) {
+  ensureCrossingCounts( EDGE_COUNTS );
   Edgeptr max_crossings_edge = NULL;
   int max_crossings = -1;
   for ( int i = 0; i < number_of_edges; i++ ) {
@@ -365,6 +491,7 @@ void print_crossings_between_layers( int i )
  */
 void printCrossings( void )
 {
+  ensureCrossingCounts( EDGE_COUNTS );
   printf( "xxx total_crossings = %d\n", numberOfCrossings() );
   int i = 1;
   for( ; i < number_of_layers; i++ )
@@ -432,4 +559,4 @@ int main( int argc, char * argv[] )
 
 #endif
 
-/*  [Last modified: 2021 02 15 at 17:18:40 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -15,6 +15,29 @@
 #include"defs.h"
 #include"graph.h"
 
+/**
+ * Which counts updateCrossingsBetweenLayers() maintains besides the total
+ * for each channel: none (TOTAL_COUNTS), the up and down crossings of each
+ * node (NODE_COUNTS) or those and the crossings of each edge (EDGE_COUNTS).
+ * The lower levels use tighter kernels; counts they leave out are computed
+ * when first asked for, see ensureCrossingCounts().
+ */
+typedef enum { TOTAL_COUNTS, NODE_COUNTS, EDGE_COUNTS } CrossingCounts;
+
+/**
+ * Sets the counts maintained from now on; the default is EDGE_COUNTS
+ */
+void setCrossingCounts( CrossingCounts counts );
+CrossingCounts crossingCounts( void );
+
+/**
+ * Brings the counts of every channel up to the given level, recounting
+ * those channels whose last count left them out. The maximum and printing
+ * functions below do this themselves; other readers of the crossings field
+ * of an edge or the up/down crossings of a node call it first.
+ */
+void ensureCrossingCounts( CrossingCounts counts );
+
 /**
  * Initializes all crossing counts and allocates data structures used for
  * counting crossings.
@@ -36,20 +59,34 @@ int numberOfCrossings( void );
  */
 int maxEdgeCrossings( void );
 
+/**
+ * @return the number of crossings between layers upper_layer - 1 and
+ * upper_layer
+ */
+int numberOfCrossingsChannel( int upper_layer );
+
 /**
  * @return the number of crossings for the given layer
  */
 int numberOfCrossingsLayer( int layer );
 
 /**
- * @return the number of crossings for the given node
+ * @return the number of crossings for the given node; with TOTAL_COUNTS,
+ * only valid after ensureCrossingCounts( NODE_COUNTS )
  */
 int numberOfCrossingsNode( Nodeptr node );
 
+/**
+ * @return true if neither layer of the channel between upper_layer - 1 and
+ * upper_layer has changed since its crossings were last counted
+ */
+bool isCurrentChannel( int upper_layer );
+
 /**
  * Updates all crossings based on current ordering of nodes on each layer.
  * The position pointers for all nodes are made consistent as well, using
- * updateAllPositions() in the sorting module
+ * updateAllPositions() in the sorting module. Only channels with a layer
+ * whose version (see graph.h) changed since the last count are recounted.
  */
 void updateAllCrossings( void );
 
@@ -70,7 +107,8 @@ void updateCrossingsBetweenLayers( int upper_layer );
 
 /**
  * @return The number of an unfixed layer whose incident edges have the
- * largest number of total crossings, or -1 if all layers are fixed.
+ * largest number of total crossings, or -1 if all layers are fixed; frozen
+ * layers (see freeze.h) count as fixed.
  */
 int maxCrossingsLayer( void );
 
@@ -103,4 +141,4 @@ void printCrossings( void );
 
 #endif
 
-/*  [Last modified: 2021 02 15 at 17:16:28 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -54,6 +54,34 @@ extern double max_runtime;
  */
 extern bool standard_termination;
 
+/**
+ * Standard termination stops the heuristic after this many consecutive
+ * passes without improvement in any of the termination_objectives (-k);
+ * the default is 1
+ */
+extern int patience;
+
+/**
+ * A pass improves an objective only if it reduces the best value by more
+ * than this fraction of the best value at the last improvement (-e); the
+ * default, 0, means any reduction counts
+ */
+extern double improvement_threshold;
+
+/**
+ * Objectives considered by standard termination (and by the messages about
+ * it), a combination of the following; the objective given with -o and
+ * the two given with -P, or, if neither option is given, the four in
+ * TERMINATE_ON_ALL and, for the mnv heuristic, non-verticality
+ */
+#define TERMINATE_ON_TOTAL 0x1
+#define TERMINATE_ON_BOTTLENECK 0x2
+#define TERMINATE_ON_STRETCH 0x4
+#define TERMINATE_ON_BOTTLENECK_STRETCH 0x8
+#define TERMINATE_ON_NONVERTICALITY 0x10
+#define TERMINATE_ON_ALL 0xf
+extern unsigned int termination_objectives;
+
 /**
  * True if there is a list of favored edges based on predecessors and
  * successors of a central node
@@ -71,11 +99,12 @@ extern char * heuristic;
 extern char * preprocessor;
 
 /**
- * minimization objective, currently used to determine sgf output, if any;
+ * minimization objective, used to determine sgf output, if any, and the
+ * objectives standard termination looks at (termination_objectives);
  * @todo use this to determine what information to track while the
  * heuristic is running
  *  "t" = total, "b" = bottleneck, "s" and "bs" for stretch and
- *  bottleneck stretch
+ *  bottleneck stretch, "v" for non-verticality (see verticality.h)
  */
 extern char * objective;
 
@@ -95,6 +124,10 @@ extern Orderptr best_total_stretch_order;
  * structure to save layer orderings for minimum bottleneck edge stretch so far
  */
 extern Orderptr best_bottleneck_stretch_order;
+/**
+ * structure to save layer orderings for minimum total non-verticality so far
+ */
+extern Orderptr best_nonverticality_order;
 /**
  * structure to save layer orderings for minimum crossings involving favored
  * edges so far
@@ -109,10 +142,9 @@ extern bool randomize_order;
 
 /**
  * For barycenter heuristic: how to deal with nodes that have no
- *  edges in the direction on which weights are based: see
- *  adjust_weights_left() and adjust_weights_avg() in barycenter.c. LEFT is
- *  the default (the nodes follow their left neighbor; this keeps the nodes
- *  together and makes the heuristic more stable).
+ *  edges in the direction on which weights are based: see adjustWeights()
+ *  in weights.c. LEFT is the default (the nodes follow their left neighbor;
+ *  this keeps the nodes together and makes the heuristic more stable).
  */
 extern enum adjust_weights_enum { NONE, LEFT, AVG } adjust_weights;
 
@@ -120,11 +152,30 @@ extern enum adjust_weights_enum { NONE, LEFT, AVG } adjust_weights;
  * Based on Matuszewski et al. "Extending sifting for k-layer straightline
  * crossing minimaization": The order in which nodes are sifted can be (1)
  * based on a layer-by-layer sweep; (2) based on their degree (largest degree
- * first); or (3) random.  Number (2), DEGREE, is the default and the only
- * option currently implemented. 
+ * first); or (3) random.  Number (2), DEGREE, is the default. LAYER groups
+ * the nodes by layer, ordered by degree within each layer, and alternates
+ * the direction of the sweep from one pass to the next; RANDOM visits the
+ * nodes in a new random order (from the genrand generator) on each pass.
+ * Only sifting() uses this option.
  */
 extern enum sift_option_enum { LAYER, DEGREE, RANDOM } sift_option;
 
+/**
+ * If positive, sifting, mcn, mce_s and post-processing also try block moves
+ * (-b option): after a node is sifted, the block of adjacent nodes that
+ * have the same neighbors as the node, or else block_sift_window nodes
+ * beginning with it, is moved as a unit if that reduces the crossings. 0
+ * means no block moves.
+ */
+extern int block_sift_window;
+
+/**
+ * If true (-L option), layers whose channels have as few crossings as the
+ * orders of their neighbors allow are skipped by the sweeps, sifting,
+ * maxCrossingsLayer() and swapping until a neighbor changes; see freeze.h
+ */
+extern bool freeze_solved_layers;
+
 /**
  * When a node is sifted during sifting, mcn, or mce, one can either base its
  * position on the minimum number of total crossings or, as in the original
@@ -155,8 +206,9 @@ extern enum mce_option_enum { NODES, EDGES, EARLY, ONE_NODE } mce_option;
 
 /**
  * For Pareto optimization we can choose a variety of different objectives;
- * for now we consider two at a time. This option currently affects only what
- * gets updated and reported, not the behavior of any heuristic.
+ * for now we consider two at a time. This option affects what gets updated
+ * and reported and which objectives standard termination looks at, not the
+ * behavior of any heuristic.
  *  NO_PARETO = no Pareto optimization, i.e., don't report Pareto points
  *  BOTTLENECK_TOTAL = maxEdgeCrossings(),numberOfCrossings()
  *  STRETCH_TOTAL = totalStretch(),numberOfCrossings()
@@ -186,6 +238,20 @@ extern bool write_ord_output;
  * true if output should go to an sgf file
  */
 extern bool write_sgf_output;
+/**
+ * true if output files should be layered GraphML instead (-G option)
+ */
+extern bool write_graphml_output;
+/**
+ * true if output files should only have the layer orders that differ from
+ * the input order (-D option); see delta.h
+ */
+extern bool write_delta_output;
+/**
+ * true if each edge in GraphML output has its number of crossings; the
+ * crossings must be up to date when a file is written
+ */
+extern bool graphml_edge_crossings;
 
 /**
  * true if (sfg) output should be written to stdout,
@@ -214,4 +280,10 @@ extern bool verbose;
  */
 extern int trace_freq;
 
+/**
+ * Number of threads to be used for parallel work, set with -T; the task
+ * scheduler in tasks.c is initialized with this many workers
+ */
+extern int number_of_threads;
+
 #endif
@@ -0,0 +1,189 @@
+/**
+ * @file delta.c
+ * @brief Implementation of delta output and of applying a delta to a graph.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include"constants.h"
+#include"defs.h"
+#include"graph.h"
+#include"graph_io.h"
+#include"hash.h"
+#include"delta.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdbool.h>
+
+/** the order of each layer when captureInputOrder() was called */
+static Nodeptr ** input_order = NULL;
+static int input_order_layers = 0;
+
+void captureInputOrder( void )
+{
+  freeInputOrder();
+  input_order_layers = number_of_layers;
+  input_order = (Nodeptr **) calloc( number_of_layers, sizeof(Nodeptr *) );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    int layer_size = layers[layer]->number_of_nodes;
+    input_order[layer] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    for ( int position = 0; position < layer_size; position++ )
+      input_order[layer][position] = layers[layer]->nodes[position];
+  }
+}
+
+void freeInputOrder( void )
+{
+  if ( input_order == NULL ) return;
+  for ( int layer = 0; layer < input_order_layers; layer++ )
+    free( input_order[layer] );
+  free( input_order );
+  input_order = NULL;
+  input_order_layers = 0;
+}
+
+void writeDelta( FILE * out )
+{
+  if ( input_order == NULL ) {
+    fprintf(stderr, "*** FATAL ERROR: delta output without an input order\n");
+    exit(EXIT_FAILURE);
+  }
+  startGettingComments();
+  char comment[MAX_NAME_LENGTH];
+  while ( getNextComment( comment ) != NULL ) {
+    fprintf( out, "c %s\n", comment );
+  }
+  fprintf( out, "t %s %d %d %d\n",
+           graph_name, number_of_nodes, number_of_edges, number_of_layers );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    Nodeptr * nodes = layers[layer]->nodes;
+    int layer_size = layers[layer]->number_of_nodes;
+    int position = 0;
+    while ( position < layer_size ) {
+      if ( nodes[position] == input_order[layer][position] ) {
+        position++;
+        continue;
+      }
+      fprintf( out, "d %d %d", layer, position );
+      while ( position < layer_size
+              && nodes[position] != input_order[layer][position] ) {
+        fprintf( out, " %s", nodes[position]->name );
+        position++;
+      }
+      fprintf( out, "\n" );
+    }
+  }
+}
+
+/**
+ * Puts the nodes named on a 'd' line (after the tag) into their positions
+ */
+static void apply_run( char * line, int line_number )
+{
+  char * token = strtok( line, " \t\r\n" );
+  char * layer_token = strtok( NULL, " \t\r\n" );
+  char * position_token = strtok( NULL, " \t\r\n" );
+  if ( layer_token == NULL || position_token == NULL ) {
+    fprintf(stderr, "*** FATAL ERROR, delta line %d: expected 'd LAYER POSITION ...'\n",
+            line_number);
+    exit(EXIT_FAILURE);
+  }
+  int layer = atoi( layer_token );
+  int position = atoi( position_token );
+  if ( layer < 0 || layer >= number_of_layers || position < 0 ) {
+    fprintf(stderr, "*** FATAL ERROR, delta line %d: bad layer %s or position %s\n",
+            line_number, layer_token, position_token);
+    exit(EXIT_FAILURE);
+  }
+  Layerptr layer_ptr = layers[layer];
+  while ( (token = strtok( NULL, " \t\r\n" )) != NULL ) {
+    Nodeptr node = getFromHashTable( token );
+    if ( node == NULL || node->layer != layer ) {
+      fprintf(stderr, "*** FATAL ERROR, delta line %d: no node %s on layer %d\n",
+              line_number, token, layer);
+      exit(EXIT_FAILURE);
+    }
+    if ( position >= layer_ptr->number_of_nodes ) {
+      fprintf(stderr, "*** FATAL ERROR, delta line %d: layer %d has only %d nodes\n",
+              line_number, layer, layer_ptr->number_of_nodes);
+      exit(EXIT_FAILURE);
+    }
+    layer_ptr->nodes[position] = node;
+    node->position = position;
+    position++;
+  }
+  LAYER_CHANGED( layer );
+}
+
+void applyDelta( FILE * in )
+{
+  initHashTable( number_of_nodes );
+  for ( int i = 0; i < number_of_nodes; i++ )
+    insertInHashTable( master_node_list[i]->name, master_node_list[i] );
+
+  char * line = NULL;
+  size_t capacity = 0;
+  int line_number = 0;
+  while ( getline( &line, &capacity, in ) != -1 ) {
+    line_number++;
+    char * end_of_line = strchr( line, '\n' );
+    if ( end_of_line != NULL ) *end_of_line = '\0';
+    if ( line[ strspn( line, " \t\r" ) ] == '\0' ) continue;
+    if ( line[0] == 'c' ) {
+      addComment( line[1] == '\0' ? "" : line + 2, true );
+    }
+    else if ( line[0] == 't' ) {
+      char name[MAX_NAME_LENGTH];
+      int nodes, edges, layer_count;
+      if ( sscanf( line, "t %511s %d %d %d",
+                   name, &nodes, &edges, &layer_count ) != 4 ) {
+        fprintf(stderr, "*** FATAL ERROR, delta line %d: bad header '%s'\n",
+                line_number, line);
+        exit(EXIT_FAILURE);
+      }
+      if ( nodes != number_of_nodes || edges != number_of_edges
+           || layer_count != number_of_layers ) {
+        fprintf(stderr, "*** FATAL ERROR: delta is for a graph with %d nodes, %d edges, %d layers,\n"
+                "    but the graph has %d nodes, %d edges, %d layers\n",
+                nodes, edges, layer_count,
+                number_of_nodes, number_of_edges, number_of_layers);
+        exit(EXIT_FAILURE);
+      }
+      if ( strcmp( name, graph_name ) != 0 ) {
+        fprintf(stderr, "*** Warning: delta is for graph %s, graph is %s\n",
+                name, graph_name);
+      }
+    }
+    else if ( line[0] == 'd' ) {
+      apply_run( line, line_number );
+    }
+    else {
+      fprintf(stderr, "*** FATAL ERROR, delta line %d: unexpected '%s'\n",
+              line_number, line);
+      exit(EXIT_FAILURE);
+    }
+  }
+  free( line );
+  removeHashTable();
+
+  // each node put somewhere has its new position; if a position still holds
+  // a node that now has a different position, some node was placed twice
+  // or moved without anything taking its place
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    for ( int position = 0; position < layers[layer]->number_of_nodes;
+          position++ ) {
+      if ( layers[layer]->nodes[position]->position != position ) {
+        fprintf(stderr, "*** FATAL ERROR: after the delta, layer %d is not a permutation of its nodes (position %d)\n",
+                layer, position);
+        exit(EXIT_FAILURE);
+      }
+    }
+  }
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
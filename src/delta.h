@@ -0,0 +1,58 @@
+/**
+ * @file delta.h
+ * @brief Output of only the parts of the layer orders that differ from the
+ * input order (delta files), and application of a delta to a graph.
+ *
+ * A delta file has the form
+ * <pre>
+ *    c comment line 1
+ *    ...
+ *    t graph_name num_nodes num_edges num_layers
+ *    d layer position name_0 name_1 ... name_k
+ *    ...
+ * </pre>
+ * where each 'd' line says that the nodes at positions position, ...,
+ * position + k of the layer are the ones with the given names (for sgf
+ * input, the names are the node ids). There is one 'd' line for each
+ * maximal run of positions where the order differs from the input order;
+ * layers that did not change do not appear at all.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef DELTA_H
+#define DELTA_H
+
+#include<stdio.h>
+
+/**
+ * Records the current order of every layer as the input order, the one
+ * that deltas are relative to; must be called after the graph is read and
+ * before anything changes the order
+ */
+void captureInputOrder( void );
+
+/**
+ * Writes the delta between the input order and the current order, with the
+ * comments of the graph, to the out stream
+ */
+void writeDelta( FILE * out );
+
+/**
+ * Reads a delta from the stream and changes the layers of the current graph
+ * accordingly; the comments of the delta are added to those of the graph.
+ * A fatal error occurs if the 't' line does not match the graph, a name is
+ * unknown or on the wrong layer, or a layer is not a permutation of its
+ * nodes afterwards.
+ */
+void applyDelta( FILE * in );
+
+/**
+ * Deallocates the input order recorded by captureInputOrder(), if any
+ */
+void freeInputOrder( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
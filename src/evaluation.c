@@ -0,0 +1,570 @@
+/**
+ * @file evaluation.c
+ * @brief Implementation of asynchronous evaluation of the objectives.
+ *
+ * The heuristic thread keeps a shadow copy of the orders and node positions
+ * as of the last snapshot and of the number of crossings in each channel;
+ * comparing against it tells which layers and channels go into the next
+ * snapshot. The helper keeps its own copy (the mirror), which it brings up
+ * to date from each snapshot, and caches the crossings, stretch and
+ * non-verticality values of each channel, recomputing only those of
+ * channels that changed. Channel values are combined in the same order as
+ * in numberOfCrossings(), maxEdgeCrossings(), totalStretch(),
+ * maxEdgeStretch() and totalNonverticality(), so the results are exactly
+ * the same.
+ *
+ * Node positions are recorded by slot, the index of the node on its layer
+ * when evaluation was started, so that the stretch of an edge can be
+ * computed from the slots of its endpoints.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#include"constants.h"
+#include"defs.h"
+#include"graph.h"
+#include"crossings.h"
+#include"channel.h"
+#include"order.h"
+#include"stats.h"
+#include"heuristics.h"
+#include"verticality.h"
+#include"evaluation.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<math.h>
+#include<pthread.h>
+
+typedef enum {
+  TOTAL_CROSSINGS_OBJECTIVE,
+  BOTTLENECK_CROSSINGS_OBJECTIVE,
+  TOTAL_STRETCH_OBJECTIVE,
+  BOTTLENECK_STRETCH_OBJECTIVE,
+  NONVERTICALITY_OBJECTIVE
+} Objective;
+
+/**
+ * What changed since the previous snapshot
+ */
+typedef struct snapshot {
+  int iteration;
+  int number_of_changed_layers;
+  int * changed_layers;
+  /** for each changed layer, its order and the positions of its nodes by
+   * slot */
+  Nodeptr ** orders;
+  int ** positions;
+  int number_of_changed_channels;
+  int * changed_channels;
+  /** for each changed channel, its crossings and those of its edges */
+  int * crossings;
+  int ** edge_crossings;
+  struct snapshot * next;
+} * Snapshotptr;
+
+static bool active = false;
+static Objective primary_objective;
+
+/** the nodes of each layer in slot order */
+static Nodeptr ** slot_nodes = NULL;
+
+// owned by the heuristic thread
+static Nodeptr ** shadow_order = NULL;
+static int ** shadow_positions = NULL;
+static int * shadow_crossings = NULL;
+static bool * layer_changed = NULL;
+
+// owned by the helper
+static Nodeptr ** mirror_order = NULL;
+static int ** mirror_positions = NULL;
+/** slots of the lower and upper endpoints of the edges of each channel, in
+ * the order of channels[i]->edges */
+static int ** lower_slots = NULL;
+static int ** upper_slots = NULL;
+static int * channel_crossings = NULL;
+static int * channel_max_edge_crossings = NULL;
+static double * channel_total_stretch = NULL;
+static double * channel_max_stretch = NULL;
+static double * channel_nonverticality = NULL;
+static bool * layer_dirty = NULL;
+
+static pthread_t helper;
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t snapshot_queued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t snapshot_done = PTHREAD_COND_INITIALIZER;
+static Snapshotptr first_snapshot = NULL;
+static Snapshotptr last_snapshot = NULL;
+/** number of snapshots submitted but not yet processed */
+static int pending_snapshots = 0;
+static bool stopping = false;
+
+/**
+ * @return the objective that the current heuristic is trying to minimize
+ */
+static Objective heuristic_objective( void )
+{
+  if ( strcmp( heuristic, "mce" ) == 0 || strcmp( heuristic, "mce_s" ) == 0 )
+    return BOTTLENECK_CROSSINGS_OBJECTIVE;
+  if ( strcmp( heuristic, "mse" ) == 0 )
+    return TOTAL_STRETCH_OBJECTIVE;
+  if ( strcmp( heuristic, "mnv" ) == 0 )
+    return NONVERTICALITY_OBJECTIVE;
+  return TOTAL_CROSSINGS_OBJECTIVE;
+}
+
+static int compare_node_pointers( const void * first, const void * second )
+{
+  Nodeptr first_node = *(Nodeptr *) first;
+  Nodeptr second_node = *(Nodeptr *) second;
+  return first_node < second_node ? -1 : ( first_node > second_node ? 1 : 0 );
+}
+
+/**
+ * @return the slot of a node on the given layer, using nodes sorted by
+ * address, whose slots are in the parallel array slots
+ */
+static int slot_of( Nodeptr node, Nodeptr * sorted_nodes, int * slots,
+                    int layer_size )
+{
+  Nodeptr * found = bsearch( &node, sorted_nodes, layer_size,
+                             sizeof(Nodeptr), compare_node_pointers );
+  return slots[ found - sorted_nodes ];
+}
+
+/**
+ * Determines the slots of the edge endpoints of each channel
+ */
+static void compute_edge_slots( void )
+{
+  Nodeptr ** sorted_nodes
+    = (Nodeptr **) calloc( number_of_layers, sizeof(Nodeptr *) );
+  int ** slots = (int **) calloc( number_of_layers, sizeof(int *) );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    int layer_size = layers[layer]->number_of_nodes;
+    sorted_nodes[layer] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    memcpy( sorted_nodes[layer], slot_nodes[layer],
+            layer_size * sizeof(Nodeptr) );
+    qsort( sorted_nodes[layer], layer_size, sizeof(Nodeptr),
+           compare_node_pointers );
+    slots[layer] = (int *) malloc( layer_size * sizeof(int) );
+    for ( int slot = 0; slot < layer_size; slot++ ) {
+      Nodeptr * found = bsearch( &slot_nodes[layer][slot], sorted_nodes[layer],
+                                 layer_size, sizeof(Nodeptr),
+                                 compare_node_pointers );
+      slots[layer][ found - sorted_nodes[layer] ] = slot;
+    }
+  }
+  for ( int channel = 1; channel < number_of_layers; channel++ ) {
+    int number_of_edges = channels[channel]->number_of_edges;
+    lower_slots[channel] = (int *) malloc( number_of_edges * sizeof(int) );
+    upper_slots[channel] = (int *) malloc( number_of_edges * sizeof(int) );
+    for ( int j = 0; j < number_of_edges; j++ ) {
+      Edgeptr edge = channels[channel]->edges[j];
+      lower_slots[channel][j]
+        = slot_of( edge->down_node, sorted_nodes[channel - 1],
+                   slots[channel - 1], layers[channel - 1]->number_of_nodes );
+      upper_slots[channel][j]
+        = slot_of( edge->up_node, sorted_nodes[channel],
+                   slots[channel], layers[channel]->number_of_nodes );
+    }
+  }
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    free( sorted_nodes[layer] );
+    free( slots[layer] );
+  }
+  free( sorted_nodes );
+  free( slots );
+}
+
+/**
+ * Recomputes the stretch and non-verticality values of a channel from the
+ * mirror; the arithmetic is that of stretch(), totalChannelStretch() and
+ * nonverticality()
+ */
+static void compute_channel_values( int channel )
+{
+  int lower_size = layers[channel - 1]->number_of_nodes;
+  int upper_size = layers[channel]->number_of_nodes;
+  double lower_scale = lower_size > 1 ? lower_size - 1.0 : 2.0;
+  double upper_scale = upper_size > 1 ? upper_size - 1.0 : 2.0;
+  int * lower_positions = mirror_positions[channel - 1];
+  int * upper_positions = mirror_positions[channel];
+  double total_stretch = 0.0;
+  double max_stretch = 0.0;
+  double total_nonverticality = 0.0;
+  for ( int j = 0; j < channels[channel]->number_of_edges; j++ ) {
+    int lower_position = lower_positions[ lower_slots[channel][j] ];
+    int upper_position = upper_positions[ upper_slots[channel][j] ];
+    double stretch
+      = fabs( lower_position / lower_scale - upper_position / upper_scale );
+    total_stretch += stretch;
+    if ( stretch > max_stretch ) max_stretch = stretch;
+    double offset = upper_position - lower_position;
+    total_nonverticality += offset * offset;
+  }
+  channel_total_stretch[channel] = total_stretch;
+  channel_max_stretch[channel] = max_stretch;
+  channel_nonverticality[channel] = total_nonverticality;
+}
+
+static int max_of( const int * values, int number_of_values )
+{
+  int max_value = -1;
+  for ( int i = 0; i < number_of_values; i++ )
+    if ( values[i] > max_value ) max_value = values[i];
+  return max_value;
+}
+
+/**
+ * Copies the mirror into an order, as save_order() does with the layers
+ */
+static void save_mirror_order( Orderptr order )
+{
+  order->num_layers = number_of_layers;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    memcpy( order->node_ptr_on_layer[layer], mirror_order[layer],
+            layers[layer]->number_of_nodes * sizeof(Nodeptr) );
+}
+
+static void update_secondary_int( Objective objective,
+                                  CROSSING_STATS_INT * stats, Orderptr order,
+                                  int value, int value_iteration )
+{
+  if ( objective == primary_objective || value >= stats->best ) return;
+  stats->best = value;
+  stats->best_heuristic_iteration = value_iteration;
+  save_mirror_order( order );
+}
+
+static void update_secondary_double( Objective objective,
+                                     CROSSING_STATS_DOUBLE * stats,
+                                     Orderptr order,
+                                     double value, int value_iteration )
+{
+  if ( objective == primary_objective || value >= stats->best ) return;
+  stats->best = value;
+  stats->best_heuristic_iteration = value_iteration;
+  save_mirror_order( order );
+}
+
+/**
+ * Brings the mirror up to date and does what update_best_all() would have
+ * done with the objectives other than the primary one
+ */
+static void evaluate( Snapshotptr snapshot )
+{
+  for ( int i = 0; i < snapshot->number_of_changed_layers; i++ ) {
+    int layer = snapshot->changed_layers[i];
+    int layer_size = layers[layer]->number_of_nodes;
+    memcpy( mirror_order[layer], snapshot->orders[i],
+            layer_size * sizeof(Nodeptr) );
+    memcpy( mirror_positions[layer], snapshot->positions[i],
+            layer_size * sizeof(int) );
+    layer_dirty[layer] = true;
+  }
+  for ( int i = 0; i < snapshot->number_of_changed_channels; i++ ) {
+    int channel = snapshot->changed_channels[i];
+    channel_crossings[channel] = snapshot->crossings[i];
+    channel_max_edge_crossings[channel]
+      = max_of( snapshot->edge_crossings[i],
+                channels[channel]->number_of_edges );
+  }
+  for ( int channel = 1; channel < number_of_layers; channel++ )
+    if ( layer_dirty[channel - 1] || layer_dirty[channel] )
+      compute_channel_values( channel );
+  for ( int i = 0; i < snapshot->number_of_changed_layers; i++ )
+    layer_dirty[ snapshot->changed_layers[i] ] = false;
+
+  int crossings = 0;
+  int bottleneck_crossings = -1;
+  double stretch = 0.0;
+  double bottleneck_stretch_value = 0.0;
+  double nonverticality_value = 0.0;
+  for ( int channel = 1; channel < number_of_layers; channel++ ) {
+    crossings += channel_crossings[channel];
+    if ( channel_max_edge_crossings[channel] > bottleneck_crossings )
+      bottleneck_crossings = channel_max_edge_crossings[channel];
+    stretch += channel_total_stretch[channel];
+    if ( channel_max_stretch[channel] > bottleneck_stretch_value )
+      bottleneck_stretch_value = channel_max_stretch[channel];
+    nonverticality_value += channel_nonverticality[channel];
+  }
+
+  update_secondary_int( TOTAL_CROSSINGS_OBJECTIVE, & total_crossings,
+                        best_crossings_order,
+                        crossings, snapshot->iteration );
+  update_secondary_int( BOTTLENECK_CROSSINGS_OBJECTIVE, & max_edge_crossings,
+                        best_edge_crossings_order,
+                        bottleneck_crossings, snapshot->iteration );
+  update_secondary_double( TOTAL_STRETCH_OBJECTIVE, & total_stretch,
+                           best_total_stretch_order,
+                           stretch, snapshot->iteration );
+  update_secondary_double( BOTTLENECK_STRETCH_OBJECTIVE, & bottleneck_stretch,
+                           best_bottleneck_stretch_order,
+                           bottleneck_stretch_value, snapshot->iteration );
+  update_secondary_double( NONVERTICALITY_OBJECTIVE, & total_nonverticality,
+                           best_nonverticality_order,
+                           nonverticality_value, snapshot->iteration );
+  if ( pareto_objective != NO_PARETO )
+    update_pareto_list( crossings, bottleneck_crossings, stretch,
+                        snapshot->iteration, mirror_order );
+}
+
+static void free_snapshot( Snapshotptr snapshot )
+{
+  for ( int i = 0; i < snapshot->number_of_changed_layers; i++ ) {
+    free( snapshot->orders[i] );
+    free( snapshot->positions[i] );
+  }
+  for ( int i = 0; i < snapshot->number_of_changed_channels; i++ )
+    free( snapshot->edge_crossings[i] );
+  free( snapshot->changed_layers );
+  free( snapshot->orders );
+  free( snapshot->positions );
+  free( snapshot->changed_channels );
+  free( snapshot->crossings );
+  free( snapshot->edge_crossings );
+  free( snapshot );
+}
+
+static void * helper_loop( void * argument )
+{
+  while ( true ) {
+    pthread_mutex_lock( &queue_lock );
+    while ( first_snapshot == NULL && ! stopping )
+      pthread_cond_wait( &snapshot_queued, &queue_lock );
+    Snapshotptr snapshot = first_snapshot;
+    if ( snapshot != NULL ) {
+      first_snapshot = snapshot->next;
+      if ( first_snapshot == NULL ) last_snapshot = NULL;
+    }
+    pthread_mutex_unlock( &queue_lock );
+    if ( snapshot == NULL ) break;
+
+    evaluate( snapshot );
+    free_snapshot( snapshot );
+
+    pthread_mutex_lock( &queue_lock );
+    pending_snapshots--;
+    pthread_cond_broadcast( &snapshot_done );
+    pthread_mutex_unlock( &queue_lock );
+  }
+  return NULL;
+}
+
+/**
+ * Records the current positions of the nodes of a layer by slot
+ */
+static void positions_by_slot( int layer, int * positions )
+{
+  for ( int slot = 0; slot < layers[layer]->number_of_nodes; slot++ )
+    positions[slot] = slot_nodes[layer][slot]->position;
+}
+
+/**
+ * @return true if the order or the node positions of the layer differ from
+ * the shadow copy, which is then brought up to date
+ */
+static bool update_shadow_layer( int layer )
+{
+  int layer_size = layers[layer]->number_of_nodes;
+  bool changed = memcmp( shadow_order[layer], layers[layer]->nodes,
+                         layer_size * sizeof(Nodeptr) ) != 0;
+  for ( int slot = 0; slot < layer_size && ! changed; slot++ )
+    changed = shadow_positions[layer][slot] != slot_nodes[layer][slot]->position;
+  if ( changed ) {
+    memcpy( shadow_order[layer], layers[layer]->nodes,
+            layer_size * sizeof(Nodeptr) );
+    positions_by_slot( layer, shadow_positions[layer] );
+  }
+  return changed;
+}
+
+static Snapshotptr take_snapshot( void )
+{
+  Snapshotptr snapshot = (Snapshotptr) calloc( 1, sizeof(struct snapshot) );
+  snapshot->iteration = iteration;
+  snapshot->changed_layers = (int *) malloc( number_of_layers * sizeof(int) );
+  snapshot->orders = (Nodeptr **) malloc( number_of_layers * sizeof(Nodeptr *) );
+  snapshot->positions = (int **) malloc( number_of_layers * sizeof(int *) );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    layer_changed[layer] = update_shadow_layer( layer );
+    if ( ! layer_changed[layer] ) continue;
+    int layer_size = layers[layer]->number_of_nodes;
+    int i = snapshot->number_of_changed_layers++;
+    snapshot->changed_layers[i] = layer;
+    snapshot->orders[i] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    memcpy( snapshot->orders[i], shadow_order[layer],
+            layer_size * sizeof(Nodeptr) );
+    snapshot->positions[i] = (int *) malloc( layer_size * sizeof(int) );
+    memcpy( snapshot->positions[i], shadow_positions[layer],
+            layer_size * sizeof(int) );
+  }
+
+  snapshot->changed_channels
+    = (int *) malloc( number_of_layers * sizeof(int) );
+  snapshot->crossings = (int *) malloc( number_of_layers * sizeof(int) );
+  snapshot->edge_crossings
+    = (int **) malloc( number_of_layers * sizeof(int *) );
+  for ( int channel = 1; channel < number_of_layers; channel++ ) {
+    int crossings = numberOfCrossingsChannel( channel );
+    if ( ! layer_changed[channel - 1] && ! layer_changed[channel]
+         && crossings == shadow_crossings[channel] )
+      continue;
+    shadow_crossings[channel] = crossings;
+    int number_of_edges = channels[channel]->number_of_edges;
+    int i = snapshot->number_of_changed_channels++;
+    snapshot->changed_channels[i] = channel;
+    snapshot->crossings[i] = crossings;
+    snapshot->edge_crossings[i]
+      = (int *) malloc( number_of_edges * sizeof(int) );
+    for ( int j = 0; j < number_of_edges; j++ )
+      snapshot->edge_crossings[i][j] = channels[channel]->edges[j]->crossings;
+  }
+  return snapshot;
+}
+
+void startAsynchronousEvaluation( void )
+{
+  primary_objective = heuristic_objective();
+  slot_nodes = (Nodeptr **) calloc( number_of_layers, sizeof(Nodeptr *) );
+  shadow_order = (Nodeptr **) calloc( number_of_layers, sizeof(Nodeptr *) );
+  shadow_positions = (int **) calloc( number_of_layers, sizeof(int *) );
+  mirror_order = (Nodeptr **) calloc( number_of_layers, sizeof(Nodeptr *) );
+  mirror_positions = (int **) calloc( number_of_layers, sizeof(int *) );
+  layer_changed = (bool *) calloc( number_of_layers, sizeof(bool) );
+  layer_dirty = (bool *) calloc( number_of_layers, sizeof(bool) );
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    int layer_size = layers[layer]->number_of_nodes;
+    slot_nodes[layer] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    memcpy( slot_nodes[layer], layers[layer]->nodes,
+            layer_size * sizeof(Nodeptr) );
+    shadow_order[layer] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    memcpy( shadow_order[layer], layers[layer]->nodes,
+            layer_size * sizeof(Nodeptr) );
+    mirror_order[layer] = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+    memcpy( mirror_order[layer], layers[layer]->nodes,
+            layer_size * sizeof(Nodeptr) );
+    shadow_positions[layer] = (int *) malloc( layer_size * sizeof(int) );
+    positions_by_slot( layer, shadow_positions[layer] );
+    mirror_positions[layer] = (int *) malloc( layer_size * sizeof(int) );
+    positions_by_slot( layer, mirror_positions[layer] );
+  }
+
+  lower_slots = (int **) calloc( number_of_layers, sizeof(int *) );
+  upper_slots = (int **) calloc( number_of_layers, sizeof(int *) );
+  compute_edge_slots();
+  shadow_crossings = (int *) calloc( number_of_layers, sizeof(int) );
+  channel_crossings = (int *) calloc( number_of_layers, sizeof(int) );
+  channel_max_edge_crossings = (int *) calloc( number_of_layers, sizeof(int) );
+  channel_total_stretch = (double *) calloc( number_of_layers, sizeof(double) );
+  channel_max_stretch = (double *) calloc( number_of_layers, sizeof(double) );
+  channel_nonverticality
+    = (double *) calloc( number_of_layers, sizeof(double) );
+  for ( int channel = 1; channel < number_of_layers; channel++ ) {
+    shadow_crossings[channel] = channel_crossings[channel]
+      = numberOfCrossingsChannel( channel );
+    int max_crossings = -1;
+    for ( int j = 0; j < channels[channel]->number_of_edges; j++ )
+      if ( channels[channel]->edges[j]->crossings > max_crossings )
+        max_crossings = channels[channel]->edges[j]->crossings;
+    channel_max_edge_crossings[channel] = max_crossings;
+    compute_channel_values( channel );
+  }
+
+  stopping = false;
+  if ( pthread_create( &helper, NULL, helper_loop, NULL ) != 0 ) {
+    fprintf( stderr, "*** FATAL ERROR: unable to create evaluation thread\n" );
+    exit( EXIT_FAILURE );
+  }
+  active = true;
+}
+
+bool asynchronousEvaluation( void )
+{
+  return active;
+}
+
+void submitEvaluation( void )
+{
+  switch ( primary_objective ) {
+  case TOTAL_CROSSINGS_OBJECTIVE:
+    update_best_int( & total_crossings, best_crossings_order,
+                     numberOfCrossings );
+    break;
+  case BOTTLENECK_CROSSINGS_OBJECTIVE:
+    update_best_int( & max_edge_crossings, best_edge_crossings_order,
+                     maxEdgeCrossings );
+    break;
+  case TOTAL_STRETCH_OBJECTIVE:
+    update_best_double( & total_stretch, best_total_stretch_order,
+                        totalStretch );
+    break;
+  case BOTTLENECK_STRETCH_OBJECTIVE:
+    update_best_double( & bottleneck_stretch, best_bottleneck_stretch_order,
+                        maxEdgeStretch );
+    break;
+  case NONVERTICALITY_OBJECTIVE:
+    update_best_double( & total_nonverticality, best_nonverticality_order,
+                        totalNonverticality );
+    break;
+  }
+  Snapshotptr snapshot = take_snapshot();
+  pthread_mutex_lock( &queue_lock );
+  while ( pending_snapshots >= MAX_PENDING_SNAPSHOTS )
+    pthread_cond_wait( &snapshot_done, &queue_lock );
+  if ( last_snapshot == NULL ) first_snapshot = snapshot;
+  else last_snapshot->next = snapshot;
+  last_snapshot = snapshot;
+  pending_snapshots++;
+  pthread_cond_signal( &snapshot_queued );
+  pthread_mutex_unlock( &queue_lock );
+}
+
+void synchronizeEvaluation( void )
+{
+  if ( ! active ) return;
+  pthread_mutex_lock( &queue_lock );
+  while ( pending_snapshots > 0 )
+    pthread_cond_wait( &snapshot_done, &queue_lock );
+  pthread_mutex_unlock( &queue_lock );
+}
+
+static void free_layer_arrays( void ** arrays, int number_of_arrays )
+{
+  for ( int i = 0; i < number_of_arrays; i++ ) free( arrays[i] );
+  free( arrays );
+}
+
+void finishAsynchronousEvaluation( void )
+{
+  if ( ! active ) return;
+  synchronizeEvaluation();
+  pthread_mutex_lock( &queue_lock );
+  stopping = true;
+  pthread_cond_signal( &snapshot_queued );
+  pthread_mutex_unlock( &queue_lock );
+  pthread_join( helper, NULL );
+  active = false;
+
+  free_layer_arrays( (void **) slot_nodes, number_of_layers );
+  free_layer_arrays( (void **) shadow_order, number_of_layers );
+  free_layer_arrays( (void **) shadow_positions, number_of_layers );
+  free_layer_arrays( (void **) mirror_order, number_of_layers );
+  free_layer_arrays( (void **) mirror_positions, number_of_layers );
+  free_layer_arrays( (void **) lower_slots, number_of_layers );
+  free_layer_arrays( (void **) upper_slots, number_of_layers );
+  free( shadow_crossings );
+  free( channel_crossings );
+  free( channel_max_edge_crossings );
+  free( channel_total_stretch );
+  free( channel_max_stretch );
+  free( channel_nonverticality );
+  free( layer_changed );
+  free( layer_dirty );
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,63 @@
+/**
+ * @file evaluation.h
+ * @brief Asynchronous evaluation of the objectives at the end of each
+ * iteration, on a helper thread (-A option).
+ *
+ * While asynchronous evaluation is active, update_best_all() only updates
+ * the best value and order of the primary objective of the heuristic
+ * (bottleneck crossings for mce and mce_s, total stretch for mse,
+ * non-verticality for mnv, total crossings otherwise) and then hands the helper a snapshot of what changed
+ * since the previous call: the orders and node positions of the layers
+ * that changed, and the crossings of the channels that changed. The helper
+ * keeps a copy of the orders and of the per-channel values, computes all
+ * objectives from them exactly as the synchronous code would, updates the
+ * best values, iterations and orders of the other objectives and the Pareto
+ * list.
+ *
+ * Anything that reads the best values or orders must first call
+ * synchronizeEvaluation(); the results are then identical to those of
+ * synchronous evaluation.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include<stdbool.h>
+
+/**
+ * Starts the helper thread; must be called after the crossings, channels
+ * and best orders are initialized and before the first update_best_all()
+ * of the heuristic
+ */
+void startAsynchronousEvaluation( void );
+
+/**
+ * @return true if the helper thread has been started and not finished
+ */
+bool asynchronousEvaluation( void );
+
+/**
+ * Updates the best value of the primary objective and queues a snapshot of
+ * the current order for the helper; waits if the helper has fallen too far
+ * behind (MAX_PENDING_SNAPSHOTS)
+ */
+void submitEvaluation( void );
+
+/**
+ * Waits until the helper has processed all snapshots submitted so far; does
+ * nothing if asynchronous evaluation is not active
+ */
+void synchronizeEvaluation( void );
+
+/**
+ * Waits for the helper to finish, stops it and deallocates its data; from
+ * then on update_best_all() works synchronously again
+ */
+void finishAsynchronousEvaluation( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
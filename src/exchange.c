@@ -0,0 +1,645 @@
+/**
+ * @file exchange.c
+ * @brief Implementation of the shared memory exchange of best orders.
+ *
+ * Layout of the segment: a header followed by one slot per objective; each
+ * slot is a seqlock sequence number, the pid of the process currently
+ * writing (if any), the best value (DBL_MAX if none) and the order, i.e.,
+ * number_of_nodes node ids, layer by layer.
+ *
+ * The header also lists the pids of the attached processes. The list is
+ * changed only under a lock in the header (taken over if its holder has
+ * died), and entries of processes that no longer exist are removed whenever
+ * it is. A process that finds no live process attached clears the slots, so
+ * that a new run never adopts orders from one that is over; the last live
+ * process to detach removes the segment. A segment that is still not
+ * initialized after the attach timeout was left by a creator that died, and
+ * is removed and created again.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include"graph.h"
+#include"defs.h"
+#include"crossings.h"
+#include"channel.h"
+#include"order.h"
+#include"stats.h"
+#include"heuristics.h"
+#include"exchange.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<stdint.h>
+#include<float.h>
+#include<errno.h>
+#include<fcntl.h>
+#include<signal.h>
+#include<sched.h>
+#include<time.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/types.h>
+
+/** identifies an initialized segment ("MLCM") */
+#define EXCHANGE_MAGIC 0x4d4c434dU
+
+/** number of times a reader retries a copy that raced with a writer */
+#define READ_ATTEMPTS 16
+
+/** number of 1ms waits for a peer to finish creating the segment */
+#define ATTACH_ATTEMPTS 1000
+
+/** maximum number of processes attached at the same time */
+#define MAX_ATTACHED 256
+
+/**
+ * number of times attaching starts over after finding a stale segment or
+ * one that was removed in the meantime
+ */
+#define ATTACH_RETRIES 3
+
+typedef enum {
+  TOTAL_CROSSINGS_SLOT,
+  BOTTLENECK_CROSSINGS_SLOT,
+  TOTAL_STRETCH_SLOT,
+  BOTTLENECK_STRETCH_SLOT,
+  NUMBER_OF_SLOTS
+} Objective;
+
+typedef struct exchange_header {
+  volatile uint32_t magic;
+  /** the process changing attached_pids, 0 if none */
+  volatile int32_t registry_pid;
+  uint64_t graph_hash;
+  int32_t number_of_nodes;
+  int32_t number_of_layers;
+  /** the processes attached; 0 marks an unused entry */
+  volatile int32_t attached_pids[MAX_ATTACHED];
+} * Headerptr;
+
+typedef struct exchange_slot {
+  /** odd while a write is in progress */
+  volatile uint32_t sequence;
+  /** the process doing the write in progress, 0 if none */
+  volatile int32_t writer_pid;
+  double value;
+  /** followed by number_of_nodes node ids */
+} * Slotptr;
+
+static char segment_name[MAX_NAME_LENGTH];
+static char * segment = NULL;
+/** identity of the segment, to tell whether its name still refers to it */
+static dev_t segment_device;
+static ino_t segment_inode;
+static size_t segment_size = 0;
+static size_t slot_size = 0;
+
+/** all nodes sorted by id, to map ids in the segment back to nodes */
+static Nodeptr * nodes_by_id = NULL;
+/** buffer for copies of shared orders */
+static int32_t * order_buffer = NULL;
+/** marks nodes already seen during validation of an order */
+static int * seen_stamp = NULL;
+static int current_stamp = 0;
+
+static Headerptr header( void )
+{
+  return (Headerptr) segment;
+}
+
+static Slotptr slot( Objective objective )
+{
+  return (Slotptr) (segment + sizeof(struct exchange_header)
+                    + objective * slot_size);
+}
+
+static int32_t * slot_order( Slotptr slot )
+{
+  return (int32_t *) ((char *) slot + sizeof(struct exchange_slot));
+}
+
+/**
+ * mixing function from splitmix64; combined by addition so that the hash
+ * does not depend on the order of the edges
+ */
+static uint64_t mix( uint64_t x )
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static uint64_t graph_hash( void )
+{
+  uint64_t hash = mix( number_of_layers ) + mix( number_of_nodes )
+    + mix( number_of_edges );
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    hash += mix( ((uint64_t) layer << 32) | layers[layer]->number_of_nodes );
+  for ( int i = 0; i < number_of_edges; i++ ) {
+    Edgeptr edge = master_edge_list[i];
+    hash += mix( ((uint64_t) (uint32_t) edge->down_node->id << 32)
+                 | (uint32_t) edge->up_node->id );
+  }
+  return hash;
+}
+
+static int compare_ids( const void * a, const void * b )
+{
+  int id_a = (*(const Nodeptr *) a)->id;
+  int id_b = (*(const Nodeptr *) b)->id;
+  return id_a < id_b ? -1 : id_a > id_b;
+}
+
+/**
+ * @return the index of the node with the given id in nodes_by_id, -1 if
+ * there is none
+ */
+static int index_of_id( int32_t id )
+{
+  int low = 0;
+  int high = number_of_nodes - 1;
+  while ( low <= high ) {
+    int middle = low + (high - low) / 2;
+    if ( nodes_by_id[middle]->id == id ) return middle;
+    if ( nodes_by_id[middle]->id < id ) low = middle + 1;
+    else high = middle - 1;
+  }
+  return -1;
+}
+
+static void pause_briefly( void )
+{
+  struct timespec one_millisecond = { 0, 1000000 };
+  nanosleep( &one_millisecond, NULL );
+}
+
+bool exchangeAttached( void )
+{
+  return segment != NULL;
+}
+
+static bool process_exists( pid_t pid )
+{
+  return kill( pid, 0 ) == 0 || errno != ESRCH;
+}
+
+/**
+ * Takes the lock on the list of attached processes; a holder that has died,
+ * or has held it for ATTACH_ATTEMPTS ms, which no live holder does, loses it
+ */
+static void lock_registry( void )
+{
+  pid_t self = getpid();
+  int attempts = 0;
+  for ( ;; ) {
+    pid_t holder = header()->registry_pid;
+    if ( ( holder == 0 || ! process_exists( holder )
+           || attempts++ >= ATTACH_ATTEMPTS )
+         && __sync_bool_compare_and_swap( &header()->registry_pid,
+                                          holder, self ) )
+      break;
+    pause_briefly();
+  }
+  __sync_synchronize();
+}
+
+static void unlock_registry( void )
+{
+  __sync_synchronize();
+  header()->registry_pid = 0;
+}
+
+/**
+ * Removes the processes that no longer exist from the list of attached
+ * ones; must be called with the registry locked
+ * @return the number of attached processes left
+ */
+static int reap_attached( void )
+{
+  int live = 0;
+  for ( int i = 0; i < MAX_ATTACHED; i++ ) {
+    pid_t pid = header()->attached_pids[i];
+    if ( pid == 0 ) continue;
+    if ( process_exists( pid ) ) live++;
+    else header()->attached_pids[i] = 0;
+  }
+  return live;
+}
+
+/**
+ * Forgets the values and orders in all slots; only called when no live
+ * process is attached, so there are no other readers or writers
+ */
+static void clear_slots( void )
+{
+  for ( Objective objective = 0; objective < NUMBER_OF_SLOTS; objective++ ) {
+    Slotptr shared = slot( objective );
+    shared->writer_pid = 0;
+    shared->value = DBL_MAX;
+    __sync_synchronize();
+    shared->sequence += ( shared->sequence & 1 ) ? 1 : 2;
+  }
+}
+
+/**
+ * @return true if the segment name still refers to the segment with the
+ * given identity, i.e., it has not been removed (and maybe created again)
+ */
+static bool is_named_segment( dev_t device, ino_t inode )
+{
+  int fd = shm_open( segment_name, O_RDONLY, 0600 );
+  if ( fd < 0 ) return false;
+  struct stat status;
+  bool same = fstat( fd, &status ) == 0
+    && status.st_dev == device && status.st_ino == inode;
+  close( fd );
+  return same;
+}
+
+/**
+ * Removes the segment open as fd, unless its name already refers to a new
+ * one, and closes fd
+ */
+static void remove_stale_segment( int fd )
+{
+  struct stat status;
+  if ( fstat( fd, &status ) == 0
+       && is_named_segment( status.st_dev, status.st_ino ) ) {
+    fprintf( stderr, "*** Warning: removing stale shared memory %s\n",
+             segment_name );
+    shm_unlink( segment_name );
+  }
+  close( fd );
+}
+
+typedef enum { ATTACHED, NOT_ATTACHED, START_OVER } AttachResult;
+
+/**
+ * One attempt to create or open the segment, map it and enter this
+ * process in the list of attached processes
+ */
+static AttachResult try_attach( uint64_t hash )
+{
+  bool creator = true;
+  int fd = shm_open( segment_name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+  if ( fd < 0 && errno == EEXIST ) {
+    creator = false;
+    fd = shm_open( segment_name, O_RDWR, 0600 );
+    if ( fd < 0 && errno == ENOENT ) return START_OVER;
+  }
+  if ( fd < 0 ) {
+    fprintf( stderr, "*** Warning: unable to open shared memory %s,"
+             " no exchange with other processes\n", segment_name );
+    return NOT_ATTACHED;
+  }
+  if ( creator ) {
+    if ( ftruncate( fd, segment_size ) != 0 ) {
+      fprintf( stderr, "*** Warning: unable to size shared memory %s,"
+               " no exchange with other processes\n", segment_name );
+      close( fd );
+      shm_unlink( segment_name );
+      return NOT_ATTACHED;
+    }
+  }
+  else {
+    // the creator may not have set the size yet
+    struct stat status;
+    int attempts = 0;
+    while ( fstat( fd, &status ) == 0 && status.st_size < segment_size
+            && attempts++ < ATTACH_ATTEMPTS )
+      pause_briefly();
+    if ( status.st_size < segment_size ) {
+      // the creator died before setting the size
+      remove_stale_segment( fd );
+      return START_OVER;
+    }
+    if ( status.st_size != segment_size ) {
+      fprintf( stderr, "*** Warning: shared memory %s has the wrong size,"
+               " no exchange with other processes\n", segment_name );
+      close( fd );
+      return NOT_ATTACHED;
+    }
+  }
+  struct stat status;
+  fstat( fd, &status );
+  segment_device = status.st_dev;
+  segment_inode = status.st_ino;
+  void * address = mmap( NULL, segment_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0 );
+  if ( address == MAP_FAILED ) {
+    fprintf( stderr, "*** Warning: unable to map shared memory %s,"
+             " no exchange with other processes\n", segment_name );
+    close( fd );
+    return NOT_ATTACHED;
+  }
+  segment = (char *) address;
+
+  if ( creator ) {
+    header()->graph_hash = hash;
+    header()->number_of_nodes = number_of_nodes;
+    header()->number_of_layers = number_of_layers;
+    for ( Objective objective = 0; objective < NUMBER_OF_SLOTS; objective++ )
+      slot( objective )->value = DBL_MAX;
+    __sync_synchronize();
+    header()->magic = EXCHANGE_MAGIC;
+  }
+  else {
+    int attempts = 0;
+    while ( header()->magic != EXCHANGE_MAGIC
+            && attempts++ < ATTACH_ATTEMPTS )
+      pause_briefly();
+    __sync_synchronize();
+    if ( header()->magic != EXCHANGE_MAGIC ) {
+      // the creator died before initializing the segment
+      munmap( segment, segment_size );
+      segment = NULL;
+      remove_stale_segment( fd );
+      return START_OVER;
+    }
+    if ( header()->graph_hash != hash
+         || header()->number_of_nodes != number_of_nodes
+         || header()->number_of_layers != number_of_layers ) {
+      fprintf( stderr, "*** Warning: shared memory %s does not match graph %s,"
+               " no exchange with other processes\n",
+               segment_name, graph_name );
+      munmap( segment, segment_size );
+      segment = NULL;
+      close( fd );
+      return NOT_ATTACHED;
+    }
+  }
+  close( fd );
+
+  lock_registry();
+  // the last process of an earlier run may have removed the segment after
+  // it was opened here
+  if ( ! is_named_segment( segment_device, segment_inode ) ) {
+    unlock_registry();
+    munmap( segment, segment_size );
+    segment = NULL;
+    return START_OVER;
+  }
+  if ( reap_attached() == 0 )
+    clear_slots();
+  int entry = 0;
+  while ( entry < MAX_ATTACHED && header()->attached_pids[entry] != 0 )
+    entry++;
+  if ( entry < MAX_ATTACHED )
+    header()->attached_pids[entry] = getpid();
+  unlock_registry();
+  if ( entry == MAX_ATTACHED ) {
+    fprintf( stderr, "*** Warning: %d processes already use shared memory %s,"
+             " no exchange with other processes\n", MAX_ATTACHED,
+             segment_name );
+    munmap( segment, segment_size );
+    segment = NULL;
+    return NOT_ATTACHED;
+  }
+  return ATTACHED;
+}
+
+void attachExchange( void )
+{
+  uint64_t hash = graph_hash();
+  sprintf( segment_name, "/minimization-%016llx", (unsigned long long) hash );
+  slot_size = sizeof(struct exchange_slot) + number_of_nodes * sizeof(int32_t);
+  slot_size = (slot_size + 7) & ~ (size_t) 7;
+  segment_size = sizeof(struct exchange_header) + NUMBER_OF_SLOTS * slot_size;
+
+  AttachResult result = START_OVER;
+  for ( int attempt = 0; attempt < ATTACH_RETRIES && result == START_OVER;
+        attempt++ )
+    result = try_attach( hash );
+  if ( result == START_OVER )
+    fprintf( stderr, "*** Warning: unable to attach to shared memory %s,"
+             " no exchange with other processes\n", segment_name );
+  if ( result != ATTACHED ) return;
+
+  nodes_by_id = (Nodeptr *) calloc( number_of_nodes, sizeof(Nodeptr) );
+  for ( int i = 0; i < number_of_nodes; i++ )
+    nodes_by_id[i] = master_node_list[i];
+  qsort( nodes_by_id, number_of_nodes, sizeof(Nodeptr), compare_ids );
+  order_buffer = (int32_t *) calloc( number_of_nodes + 1, sizeof(int32_t) );
+  seen_stamp = (int *) calloc( number_of_nodes + 1, sizeof(int) );
+  fprintf( stderr, "--- Exchanging best orders via shared memory %s\n",
+           segment_name );
+}
+
+/**
+ * @return the best value for the objective seen by this process
+ */
+static double own_best( Objective objective )
+{
+  switch ( objective ) {
+  case TOTAL_CROSSINGS_SLOT: return total_crossings.best;
+  case BOTTLENECK_CROSSINGS_SLOT: return max_edge_crossings.best;
+  case TOTAL_STRETCH_SLOT: return total_stretch.best;
+  default: return bottleneck_stretch.best;
+  }
+}
+
+static Orderptr own_best_order( Objective objective )
+{
+  switch ( objective ) {
+  case TOTAL_CROSSINGS_SLOT: return best_crossings_order;
+  case BOTTLENECK_CROSSINGS_SLOT: return best_edge_crossings_order;
+  case TOTAL_STRETCH_SLOT: return best_total_stretch_order;
+  default: return best_bottleneck_stretch_order;
+  }
+}
+
+/**
+ * @return the value of the objective for the current order; assumes
+ * crossings are up to date
+ */
+static double current_value( Objective objective )
+{
+  switch ( objective ) {
+  case TOTAL_CROSSINGS_SLOT: return numberOfCrossings();
+  case BOTTLENECK_CROSSINGS_SLOT: return maxEdgeCrossings();
+  case TOTAL_STRETCH_SLOT: return totalStretch();
+  default: return maxEdgeStretch();
+  }
+}
+
+/**
+ * @return the objective that the current heuristic is trying to minimize
+ */
+static Objective heuristic_objective( void )
+{
+  if ( strcmp( heuristic, "mce" ) == 0 || strcmp( heuristic, "mce_s" ) == 0 )
+    return BOTTLENECK_CROSSINGS_SLOT;
+  if ( strcmp( heuristic, "mse" ) == 0 )
+    return TOTAL_STRETCH_SLOT;
+  return TOTAL_CROSSINGS_SLOT;
+}
+
+/**
+ * Starts a write: makes the sequence number odd, taking over the slot if
+ * the process that left it odd no longer exists
+ * @return false if another live process is writing
+ */
+static bool acquire_slot( Slotptr slot )
+{
+  uint32_t sequence = slot->sequence;
+  if ( sequence & 1 ) {
+    pid_t writer = slot->writer_pid;
+    if ( writer == 0 || kill( writer, 0 ) == 0 || errno != ESRCH )
+      return false;
+    if ( ! __sync_bool_compare_and_swap( &slot->sequence,
+                                         sequence, sequence + 2 ) )
+      return false;
+  }
+  else if ( ! __sync_bool_compare_and_swap( &slot->sequence,
+                                            sequence, sequence + 1 ) )
+    return false;
+  slot->writer_pid = getpid();
+  __sync_synchronize();
+  return true;
+}
+
+static void release_slot( Slotptr slot )
+{
+  __sync_synchronize();
+  slot->writer_pid = 0;
+  __sync_fetch_and_add( &slot->sequence, 1 );
+}
+
+static void publish( Objective objective )
+{
+  Slotptr shared = slot( objective );
+  double value = own_best( objective );
+  if ( value >= shared->value ) return;
+  if ( ! acquire_slot( shared ) ) return;
+  if ( value < shared->value ) {
+    Orderptr order = own_best_order( objective );
+    int32_t * ids = slot_order( shared );
+    int index = 0;
+    for ( int layer = 0; layer < order->num_layers; layer++ )
+      for ( int j = 0; j < order->num_nodes_on_layer[layer]; j++ )
+        ids[index++] = order->node_ptr_on_layer[layer][j]->id;
+    shared->value = value;
+  }
+  release_slot( shared );
+}
+
+/**
+ * Copies the order in the slot into order_buffer without taking any lock
+ * @return the value of the copied order, DBL_MAX if no consistent copy
+ * could be made or nothing has been published
+ */
+static double read_slot( Slotptr shared )
+{
+  for ( int attempt = 0; attempt < READ_ATTEMPTS; attempt++ ) {
+    uint32_t before = shared->sequence;
+    if ( before & 1 ) {
+      sched_yield();
+      continue;
+    }
+    __sync_synchronize();
+    double value = shared->value;
+    memcpy( order_buffer, slot_order( shared ),
+            number_of_nodes * sizeof(int32_t) );
+    __sync_synchronize();
+    if ( shared->sequence == before ) return value;
+  }
+  return DBL_MAX;
+}
+
+/**
+ * Converts the ids in order_buffer to an order, checking that each node
+ * occurs exactly once and on its own layer
+ * @return true if the order is valid
+ */
+static bool buffer_to_order( Orderptr order )
+{
+  current_stamp++;
+  int index = 0;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    for ( int j = 0; j < layers[layer]->number_of_nodes; j++ ) {
+      int node_index = index_of_id( order_buffer[index++] );
+      if ( node_index < 0 || seen_stamp[node_index] == current_stamp )
+        return false;
+      Nodeptr node = nodes_by_id[node_index];
+      if ( node->layer != layer ) return false;
+      seen_stamp[node_index] = current_stamp;
+      order->node_ptr_on_layer[layer][j] = node;
+    }
+  return true;
+}
+
+/**
+ * Makes the peer order for the objective current if it is strictly better
+ * than anything this process has seen
+ * @return true if the order was adopted
+ */
+static bool adopt( Objective objective )
+{
+  double own = own_best( objective );
+  if ( read_slot( slot( objective ) ) >= own ) return false;
+
+  struct order_struct current;
+  struct order_struct peer;
+  init_order( &current );
+  init_order( &peer );
+  bool adopted = false;
+  if ( buffer_to_order( &peer ) ) {
+    restore_order( &peer );
+    updateAllCrossings();
+    // the published value is only a hint; recheck with the actual order
+    if ( current_value( objective ) < own ) {
+      update_best_all();
+      adopted = true;
+    }
+    else {
+      restore_order( &current );
+      updateAllCrossings();
+    }
+  }
+  cleanup_order( &current );
+  cleanup_order( &peer );
+  return adopted;
+}
+
+bool exchangeBestOrders( void )
+{
+  if ( segment == NULL ) return false;
+  for ( Objective objective = 0; objective < NUMBER_OF_SLOTS; objective++ )
+    publish( objective );
+  bool adopted = adopt( heuristic_objective() );
+  if ( adopted && verbose )
+    fprintf( stderr, "--- adopted order from peer: iteration %d\n",
+             iteration );
+  return adopted;
+}
+
+void detachExchange( void )
+{
+  if ( segment == NULL ) return;
+  lock_registry();
+  pid_t self = getpid();
+  for ( int i = 0; i < MAX_ATTACHED; i++ )
+    if ( header()->attached_pids[i] == self )
+      header()->attached_pids[i] = 0;
+  if ( reap_attached() == 0
+       && is_named_segment( segment_device, segment_inode ) )
+    shm_unlink( segment_name );
+  unlock_registry();
+  munmap( segment, segment_size );
+  segment = NULL;
+  free( nodes_by_id );
+  free( order_buffer );
+  free( seen_stamp );
+  nodes_by_id = NULL;
+  order_buffer = NULL;
+  seen_stamp = NULL;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
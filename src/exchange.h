@@ -0,0 +1,66 @@
+/**
+ * @file exchange.h
+ * @brief Exchange of best orders among concurrent minimization processes
+ * working on the same graph (-X option).
+ *
+ * The processes attach to a POSIX shared memory segment whose name is
+ * derived from a hash of the graph. The segment has one slot for each
+ * objective (total crossings, bottleneck crossings, total stretch and
+ * bottleneck stretch), holding the best value any process has published
+ * and the corresponding order as a sequence of node ids, layer by layer.
+ *
+ * Each slot is protected by a seqlock: readers never block or write, they
+ * simply retry if the sequence number changed (or was odd) during the copy.
+ * Writers take turns via compare-and-swap on the sequence number; a writer
+ * that finds the slot held by a process that no longer exists takes it
+ * over, so a process that dies in the middle of a write blocks nothing.
+ * Orders read from the segment are validated before being used.
+ *
+ * The segment records which processes are attached. When a process finds
+ * none of them alive, for instance because the earlier run on the graph was
+ * killed, it clears the slots before using them; a segment whose creator
+ * died before initializing it is removed and created again.
+ *
+ * At each pass boundary a process publishes its best values, and adopts the
+ * order of a peer if it is strictly better with respect to the objective of
+ * its heuristic.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef EXCHANGE_H
+#define EXCHANGE_H
+
+#include<stdbool.h>
+
+/**
+ * Attaches to (creating if necessary) the shared memory segment for the
+ * current graph. Must be called after the graph is read and before the
+ * master lists are permuted. Prints a warning and leaves exchange disabled
+ * if the segment cannot be used.
+ */
+void attachExchange( void );
+
+/**
+ * @return true if attachExchange() succeeded
+ */
+bool exchangeAttached( void );
+
+/**
+ * Publishes the best values and orders of this process where they improve
+ * on the shared ones; then, if a peer has published an order that is
+ * strictly better for the objective of the current heuristic, makes it the
+ * current order and updates the best values accordingly.
+ * @return true if a peer order was adopted
+ */
+bool exchangeBestOrders( void );
+
+/**
+ * Detaches from the segment; the last live process to detach removes it
+ */
+void detachExchange( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,189 @@
+/**
+ * @file freeze.c
+ * @brief Implementation of the detection of solved (frozen) layers.
+ *
+ * Whether a layer is frozen is cached together with the versions of the
+ * layer and its two neighbors, so it is recomputed only after one of them
+ * changes. The crossings of a channel equal the pairwise lower bound for a
+ * layer exactly when each pair of its nodes is in the better of its two
+ * relative orders, so the bound itself is never computed: the pairs are
+ * checked until one is found in the worse order.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include"constants.h"
+#include"defs.h"
+#include"graph.h"
+#include"crossings.h"
+#include"freeze.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+
+/** the two sides of a layer */
+#define BELOW 0
+#define ABOVE 1
+
+typedef struct freeze_struct {
+  /** true if frozen is valid for the versions recorded */
+  bool known;
+  bool frozen;
+  /** versions of the layer below, the layer and the layer above */
+  unsigned int versions[3];
+} * Freezeptr;
+
+/** information about each layer, allocated when first needed */
+static Freezeptr freeze_info = NULL;
+
+/**
+ * version of a layer or 0 for a layer that does not exist (below the
+ * bottom or above the top)
+ */
+static unsigned int layer_version( int layer )
+{
+  if ( layer < 0 || layer >= number_of_layers ) return 0;
+  return layers[ layer ]->version;
+}
+
+static int compare_ints( const void * a, const void * b )
+{
+  int x = * (const int *) a;
+  int y = * (const int *) b;
+  return ( x > y ) - ( x < y );
+}
+
+/**
+ * @return true if two nodes, whose sorted neighbor positions are given,
+ * have no more crossings among their edges with the first node to the left
+ * of the second than the other way around
+ */
+static bool pair_is_solved( const int * first, int first_degree,
+                            const int * second, int second_degree )
+{
+  long left_first = 0;
+  long right_first = 0;
+  int less = 0;                 /* neighbors of second < current one */
+  int less_or_equal = 0;        /* neighbors of second <= current one */
+  for ( int i = 0; i < first_degree; i++ ) {
+    while ( less < second_degree && second[less] < first[i] ) less++;
+    while ( less_or_equal < second_degree
+            && second[less_or_equal] <= first[i] )
+      less_or_equal++;
+    left_first += less;
+    right_first += second_degree - less_or_equal;
+  }
+  return left_first <= right_first;
+}
+
+/**
+ * @return true if the crossings between the layer and its neighbor on the
+ * given side equal the pairwise lower bound, i.e., every pair of nodes on
+ * the layer is in the relative order with fewer crossings; pairs of
+ * adjacent nodes are tried first since they are the likeliest to fail
+ */
+static bool attains_lower_bound( int layer, int side )
+{
+  Layerptr layer_ptr = layers[ layer ];
+  int number_of_nodes = layer_ptr->number_of_nodes;
+  int * start = (int *) malloc( ( number_of_nodes + 1 ) * sizeof(int) );
+  start[0] = 0;
+  for ( int i = 0; i < number_of_nodes; i++ ) {
+    Nodeptr node = layer_ptr->nodes[i];
+    start[i + 1] = start[i]
+      + ( side == BELOW ? node->down_degree : node->up_degree );
+  }
+  int * positions = (int *) malloc( ( start[number_of_nodes] + 1 )
+                                    * sizeof(int) );
+  for ( int i = 0; i < number_of_nodes; i++ ) {
+    Nodeptr node = layer_ptr->nodes[i];
+    int degree = start[i + 1] - start[i];
+    for ( int j = 0; j < degree; j++ )
+      positions[ start[i] + j ] = side == BELOW
+        ? node->down_edges[j]->down_node->position
+        : node->up_edges[j]->up_node->position;
+    qsort( positions + start[i], degree, sizeof(int), compare_ints );
+  }
+
+  bool solved = true;
+  for ( int distance = 1; solved && distance < number_of_nodes; distance++ )
+    for ( int i = 0; solved && i + distance < number_of_nodes; i++ ) {
+      int j = i + distance;
+      solved = pair_is_solved( positions + start[i], start[i + 1] - start[i],
+                               positions + start[j], start[j + 1] - start[j] );
+    }
+  free( positions );
+  free( start );
+  return solved;
+}
+
+/**
+ * @return true if the crossings of the channel between the layer and its
+ * neighbor on the given side, which must be up to date, are as few as
+ * possible for the current order of the neighbor
+ */
+static bool channel_is_solved( int layer, int side )
+{
+  int neighbor = side == BELOW ? layer - 1 : layer + 1;
+  if ( neighbor < 0 || neighbor >= number_of_layers ) return true;
+  if ( numberOfCrossingsChannel( side == BELOW ? layer : layer + 1 ) == 0 )
+    return true;
+  if ( layers[ layer ]->number_of_nodes > MAX_BOUND_LAYER_SIZE )
+    return false;
+  return attains_lower_bound( layer, side );
+}
+
+/**
+ * @return true if the channel with the given upper layer does not exist
+ * or its crossings are up to date
+ */
+static bool channel_is_current( int upper_layer )
+{
+  if ( upper_layer < 1 || upper_layer >= number_of_layers ) return true;
+  return isCurrentChannel( upper_layer );
+}
+
+bool isFrozenLayer( int layer )
+{
+  if ( ! freeze_solved_layers ) return false;
+  if ( freeze_info == NULL )
+    freeze_info
+      = (Freezeptr) calloc( number_of_layers, sizeof(struct freeze_struct) );
+  Freezeptr info = & freeze_info[ layer ];
+  unsigned int below = layer_version( layer - 1 );
+  unsigned int current = layer_version( layer );
+  unsigned int above = layer_version( layer + 1 );
+  if ( info->known
+       && info->versions[0] == below
+       && info->versions[1] == current
+       && info->versions[2] == above )
+    return info->frozen;
+
+  // not known until the crossings of both channels have been counted
+  if ( ! channel_is_current( layer ) || ! channel_is_current( layer + 1 ) )
+    return false;
+  info->frozen
+    = channel_is_solved( layer, BELOW ) && channel_is_solved( layer, ABOVE );
+  info->versions[0] = below;
+  info->versions[1] = current;
+  info->versions[2] = above;
+  info->known = true;
+  return info->frozen;
+}
+
+bool allLayersFrozen( void )
+{
+  if ( ! freeze_solved_layers ) return false;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    if ( ! isFrozenLayer( layer ) ) return false;
+  return true;
+}
+
+void deallocateFrozenLayers( void )
+{
+  free( freeze_info );
+  freeze_info = NULL;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
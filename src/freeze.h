@@ -0,0 +1,50 @@
+/**
+ * @file freeze.h
+ * @brief Detection of layers whose order cannot be improved as long as
+ * their neighbors stay as they are (-L option).
+ *
+ * A layer is solved if each channel incident on it has no crossings or as
+ * many as the pairwise lower bound for the layer with respect to the other
+ * layer of the channel: the sum, over all pairs of nodes on the layer, of
+ * the smaller of their crossings in the two relative orders. The crossings
+ * of the layer are then the least possible for the current orders of the
+ * layers next to it. The bound is checked only for layers with at most
+ * MAX_BOUND_LAYER_SIZE nodes; larger layers are solved only if both
+ * channels have no crossings.
+ *
+ * Solved layers are frozen: the barycenter and median sweeps,
+ * maxCrossingsLayer(), sifting and swapping skip them. A layer thaws as
+ * soon as it or one of its neighbors changes (see the version field in
+ * graph.h) and is frozen again if it is still solved once the crossings of
+ * its channels have been counted.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef FREEZE_H
+#define FREEZE_H
+
+#include<stdbool.h>
+
+/**
+ * @return true if freezing was requested (-L) and the layer is solved with
+ * respect to the current orders of its neighbors; false if the crossings of
+ * one of its channels are not up to date
+ */
+bool isFrozenLayer( int layer );
+
+/**
+ * @return true if freezing was requested and every layer is frozen, in
+ * which case the sweeps and sifting passes have nothing left to do
+ */
+bool allLayersFrozen( void );
+
+/**
+ * Deallocates the information kept about each layer
+ */
+void deallocateFrozenLayers( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
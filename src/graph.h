@@ -51,7 +51,11 @@ struct node_struct
   double weight;
 
   // Added on 09-11-08 for max. crossings node heuristic
-  bool fixed;
+  /**
+   * the node is fixed iff this equals the current node epoch; see
+   * isFixedNode() and clearFixedNodes() in heuristics.c
+   */
+  unsigned int fixed_epoch;
   int up_crossings;
   int down_crossings;
   
@@ -70,9 +74,10 @@ struct edge_struct {
 
   // for heuristics
   /**
-   * true if edge has been processed in current iteration
+   * equal to the current edge epoch if edge has been processed in current
+   * pass; see isFixedEdge() and clearFixedEdges() in heuristics.c
    */
-  bool fixed;
+  unsigned int fixed_epoch;
   /**
    * true if minimizing crossings for this edge should be given priority (not
    * used - instead, a list of priority edges is maintained)
@@ -84,10 +89,32 @@ struct layer_struct {
   int number_of_nodes;
   Nodeptr * nodes;
 
-  // for algorithms that fix layers during an iteration
-  bool fixed;
+  // for algorithms that fix layers during an iteration; same discipline as
+  // for nodes and edges
+  unsigned int fixed_epoch;
+
+  /**
+   * true if the order of the layer must not change; layer sorts and sifting
+   * leave pinned layers alone (used for the layers a band shares with its
+   * neighbors, see bands.h)
+   */
+  bool pinned;
+
+  /**
+   * incremented whenever the order of the layer changes or the crossing
+   * counts of edges incident on its nodes are changed other than by a full
+   * count; updateAllCrossings() recounts a channel only if the version of
+   * one of its layers differs from the one recorded at the last count
+   */
+  unsigned int version;
 };
 
+/**
+ * Records a change to the order of the given layer (a layer number); see
+ * the version field of layer_struct
+ */
+#define LAYER_CHANGED( layer ) ( layers[ layer ]->version++ )
+
 // The following are defined in graph_io.c
 
 /**
@@ -114,4 +141,4 @@ extern char * comments;
 
 #endif
 
-/*  [Last modified: 2021 02 15 at 18:15:29 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
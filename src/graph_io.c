@@ -15,10 +15,13 @@
 #include"ord.h"
 #include"sgf.h"
 #include"graph_io.h"
+#include"delta.h"
 
 #include<stdio.h>
 #include<stdlib.h>
 #include<string.h>
+#include<ctype.h>
+#include<limits.h>
 #include<assert.h>
 
 #define MIN_LAYER_CAPACITY 1 
@@ -35,10 +38,14 @@ char graph_name[MAX_NAME_LENGTH];
 char * output_base_name = NULL;
 /**
  * write_ord_output and write_sgf_output are based on the nature
- * of the input
+ * of the input; write_graphml_output, set by -G, and write_delta_output,
+ * set by -D, override both
  */
 bool write_ord_output = false;
 bool write_sgf_output = false;
+bool write_graphml_output = false;
+bool write_delta_output = false;
+bool graphml_edge_crossings = false;
 
 /**
  * @todo an odd place to put these, but necessary so that
@@ -116,7 +123,9 @@ void createOutputFileName(char * output_file_name,
 void writeFile(const char * objective_tag) {
     char output_file_name[MAX_NAME_LENGTH];
     char * extension = NULL;
-    if ( write_sgf_output ) extension = ".sgf";
+    if ( write_delta_output ) extension = ".delta";
+    else if ( write_graphml_output ) extension = ".graphml";
+    else if ( write_sgf_output ) extension = ".sgf";
     else if ( write_ord_output ) extension = ".ord";
     createOutputFileName(output_file_name, preprocessor, heuristic,
                          objective_tag, extension);
@@ -125,7 +134,9 @@ void writeFile(const char * objective_tag) {
         fprintf(stderr, "Unable to open file %s for output\n", output_file_name);
         exit( EXIT_FAILURE );
     }
-    if ( write_sgf_output ) writeSgf(out_stream);
+    if ( write_delta_output ) writeDelta(out_stream);
+    else if ( write_graphml_output ) writeGraphml(out_stream);
+    else if ( write_sgf_output ) writeSgf(out_stream);
     else if ( write_ord_output ) writeOrd(out_stream);
     fclose(out_stream);
 }
@@ -139,22 +150,30 @@ void addToNodeList(Nodeptr node) {
     master_node_list[index++] = node;
 }
 
-Nodeptr makeNumberedNode(int id, int layer, int position) {
-#ifdef DEBUG
-    printf("-> makeNumberedNode: id = %d, layer = %d, position = %d\n",
-           id, layer, position);
-#endif
+Nodeptr createNumberedNode(int id, int layer, int position) {
+    char name[MAX_NAME_LENGTH];
+    sprintf(name, "%d", id);
     Nodeptr new_node = (Nodeptr) calloc(1, sizeof(struct node_struct));
-    new_node->name = calloc(strlen(nameFromId(id)) + 1, sizeof(char));
-    strcpy(new_node->name, nameFromId(id));
+    new_node->name = calloc(strlen(name) + 1, sizeof(char));
+    strcpy(new_node->name, name);
     new_node->id = id;
     new_node->layer = layer;
     new_node->position = position;
     new_node->up_edges = new_node->down_edges = NULL;
     new_node->up_degree = new_node->down_degree = 0;
     new_node->up_crossings = new_node->down_crossings = 0;
-    new_node->marked = new_node->fixed = false;
+    new_node->marked = false;
+    new_node->fixed_epoch = 0;
     new_node->preorder_number = -1;
+    return new_node;
+}
+
+Nodeptr makeNumberedNode(int id, int layer, int position) {
+#ifdef DEBUG
+    printf("-> makeNumberedNode: id = %d, layer = %d, position = %d\n",
+           id, layer, position);
+#endif
+    Nodeptr new_node = createNumberedNode(id, layer, position);
     addToNodeList(new_node);
 #ifdef DEBUG
     printf("<- makeNumberedNode, number_of_nodes = %d\n", number_of_nodes);
@@ -231,7 +250,8 @@ void allocateLayers(void) {
         layers[layer_num] = (Layerptr) calloc(1, sizeof(struct layer_struct));
         layers[layer_num]->number_of_nodes = 0;
         layers[layer_num]->nodes = NULL;
-        layers[layer_num]->fixed = false;
+        layers[layer_num]->fixed_epoch = 0;
+        layers[layer_num]->pinned = false;
     }
 }
 
@@ -290,7 +310,8 @@ Nodeptr makeNode( const char * name )
   new_node->up_degree = new_node->down_degree = 0;
   new_node->up_edges = new_node->down_edges = NULL;
   new_node->up_crossings = new_node->down_crossings = 0;
-  new_node->marked = new_node->fixed = false;
+  new_node->marked = false;
+  new_node->fixed_epoch = 0;
   new_node->preorder_number = -1;
   insertInHashTable( name, new_node );
   master_node_list[ new_node->id ] = new_node;
@@ -315,6 +336,7 @@ void makeLayer() {
     Layerptr new_layer = (Layerptr) calloc(1, sizeof(struct layer_struct));
     new_layer->number_of_nodes = 0;
     new_layer->nodes = NULL;
+    new_layer->pinned = false;
     if( number_of_layers >= layer_capacity ) {
         layer_capacity *= 2;
         layers
@@ -377,7 +399,7 @@ void addEdge(const char * source, const char * target)
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
   new_edge->crossings = 0;
-  new_edge->fixed = false;
+  new_edge->fixed_epoch = 0;
   // these arrays will not be allocated when addEdge() is called while
   // reading an sgf file; we need to be careful to fill them later
   /**
@@ -627,6 +649,318 @@ void readDotAndOrd( const char * dot_file, const char * ord_file )
   removeHashTable();
 }
 
+// --------------- Reading lff and mlcm files
+//
+// Each file is read into memory in one piece and parsed there; the numbers
+// in the header determine the sizes of the master lists and layers, so
+// these are allocated once. Node ids follow directly from the layer sizes,
+// so endpoints are turned into master list indices arithmetically, without
+// the hash table, and the adjacency lists are allocated at their final
+// size after the degrees are counted.
+
+/** the text of the file being read and the current place in it */
+static char * input_text = NULL;
+static const char * input_position;
+static const char * input_end;
+static const char * input_file_name;
+static int input_line_number;
+
+/**
+ * Reads the whole file into input_text
+ */
+static void loadInputText( const char * file_name )
+{
+  FILE * in = fopen( file_name, "r" );
+  if ( in == NULL ) {
+    fprintf(stderr, "*** FATAL ERROR: file %s could not be opened\n", file_name);
+    exit(EXIT_FAILURE);
+  }
+  size_t capacity = BUFSIZ;
+  size_t length = 0;
+  input_text = (char *) malloc( capacity );
+  size_t bytes_read;
+  while ( (bytes_read = fread( input_text + length, 1, capacity - length, in ))
+          > 0 ) {
+    length += bytes_read;
+    if ( length == capacity ) {
+      capacity *= 2;
+      input_text = (char *) realloc( input_text, capacity );
+    }
+  }
+  fclose( in );
+  input_position = input_text;
+  input_end = input_text + length;
+  input_file_name = file_name;
+  input_line_number = 1;
+}
+
+/**
+ * Skips spaces and tabs (but not newlines)
+ * @return true if the rest of the current line is blank
+ */
+static bool atEndOfLine( void )
+{
+  while ( input_position < input_end && *input_position != '\n'
+          && isspace( (unsigned char) *input_position ) )
+    input_position++;
+  return input_position == input_end || *input_position == '\n';
+}
+
+/**
+ * Moves to the beginning of the next line, ignoring the rest of this one
+ */
+static void skipLine( void )
+{
+  while ( input_position < input_end && *input_position != '\n' )
+    input_position++;
+  if ( input_position < input_end ) {
+    input_position++;
+    input_line_number++;
+  }
+}
+
+/**
+ * @return the next number, which may be on a later line
+ */
+static int readNumber( const char * what )
+{
+  while ( input_position < input_end
+          && isspace( (unsigned char) *input_position ) ) {
+    if ( *input_position == '\n' ) input_line_number++;
+    input_position++;
+  }
+  bool negative = false;
+  if ( input_position < input_end && *input_position == '-' ) {
+    negative = true;
+    input_position++;
+  }
+  if ( input_position == input_end
+       || ! isdigit( (unsigned char) *input_position ) ) {
+    fprintf(stderr, "*** FATAL ERROR: %s, line %d: expected %s\n",
+            input_file_name, input_line_number, what);
+    exit(EXIT_FAILURE);
+  }
+  long long value = 0;
+  while ( input_position < input_end
+          && isdigit( (unsigned char) *input_position ) ) {
+    value = 10 * value + (*input_position - '0');
+    if ( value > INT_MAX ) {
+      fprintf(stderr, "*** FATAL ERROR: %s, line %d: %s is too large\n",
+              input_file_name, input_line_number, what);
+      exit(EXIT_FAILURE);
+    }
+    input_position++;
+  }
+  return negative ? (int) -value : (int) value;
+}
+
+static void freeInputText( void )
+{
+  free( input_text );
+  input_text = NULL;
+}
+
+/**
+ * Sets the graph name and comment and creates the nodes of each layer, in
+ * order of layer and position, with consecutive ids beginning at first_id
+ */
+static void createLayeredNodes( const char * file_name, const char * format,
+                                int first_id, int layer_count,
+                                const int * nodes_on_layer )
+{
+  getBaseName( graph_name, file_name );
+  startAddingComments();
+  addComment( "read from ", false );
+  addComment( format, false );
+  addComment( " file ", false );
+  addComment( file_name, true );
+  number_of_layers = layer_count;
+  number_of_nodes = 0;
+  for ( int layer = 0; layer < layer_count; layer++ ) {
+    if ( nodes_on_layer[layer] < 0
+         || number_of_nodes > INT_MAX - nodes_on_layer[layer] ) {
+      fprintf(stderr, "*** FATAL ERROR: %s: bad number of nodes, %d, on layer %d\n",
+              file_name, nodes_on_layer[layer], layer);
+      exit(EXIT_FAILURE);
+    }
+    number_of_nodes += nodes_on_layer[layer];
+  }
+  master_node_list = (Nodeptr *) calloc( number_of_nodes, sizeof(Nodeptr) );
+  int index = 0;
+  for ( int layer = 0; layer < layer_count; layer++ ) {
+    for ( int position = 0; position < nodes_on_layer[layer]; position++ ) {
+      master_node_list[index] = createNumberedNode( first_id + index,
+                                                    layer, position );
+      index++;
+    }
+  }
+  layers = (Layerptr *) calloc( number_of_layers, sizeof(Layerptr) );
+}
+
+/**
+ * Creates the edges, given as pairs of master list indices in input order,
+ * with exactly allocated adjacency lists, then puts the nodes on their
+ * layers
+ */
+static void createEdgesFromPairs( const int * endpoints, int edge_count )
+{
+  number_of_edges = edge_count;
+  master_edge_list = (Edgeptr *) calloc( number_of_edges, sizeof(Edgeptr) );
+  for ( int i = 0; i < number_of_edges; i++ ) {
+    Nodeptr source = master_node_list[ endpoints[2 * i] ];
+    Nodeptr target = master_node_list[ endpoints[2 * i + 1] ];
+    if ( abs( source->layer - target->layer ) != 1 ) {
+      fprintf(stderr, "*** FATAL ERROR: edge %s -> %s joins layers %d and %d, which are not adjacent\n",
+              source->name, target->name, source->layer, target->layer);
+      exit(EXIT_FAILURE);
+    }
+    Edgeptr new_edge = calloc( 1, sizeof(struct edge_struct) );
+    new_edge->up_node = source->layer > target->layer ? source : target;
+    new_edge->down_node = source->layer > target->layer ? target : source;
+    new_edge->crossings = 0;
+    new_edge->fixed_epoch = 0;
+    new_edge->down_node->up_degree++;
+    new_edge->up_node->down_degree++;
+    master_edge_list[i] = new_edge;
+  }
+  for ( int i = 0; i < number_of_nodes; i++ ) {
+    Nodeptr node = master_node_list[i];
+    if ( node->up_degree > 0 )
+      node->up_edges = (Edgeptr *) malloc( node->up_degree * sizeof(Edgeptr) );
+    if ( node->down_degree > 0 )
+      node->down_edges
+        = (Edgeptr *) malloc( node->down_degree * sizeof(Edgeptr) );
+    node->up_degree = node->down_degree = 0;
+  }
+  for ( int i = 0; i < number_of_edges; i++ ) {
+    Edgeptr edge = master_edge_list[i];
+    edge->down_node->up_edges[ edge->down_node->up_degree++ ] = edge;
+    edge->up_node->down_edges[ edge->up_node->down_degree++ ] = edge;
+  }
+  allocateLayers();
+  addNodesToLayers();
+  number_of_isolated_nodes = countIsolatedNodes();
+}
+
+void readLff( const char * lff_file )
+{
+  loadInputText( lff_file );
+  int declared_nodes = readNumber( "the number of nodes" );
+  int declared_edges = readNumber( "the number of edges" );
+  int declared_layers = readNumber( "the number of layers" );
+  skipLine();
+
+  // the second line has the number of nodes on each layer
+  int size_capacity = declared_layers > 0 ? declared_layers : 1;
+  int * nodes_on_layer = (int *) malloc( size_capacity * sizeof(int) );
+  int layer_count = 0;
+  while ( ! atEndOfLine() ) {
+    if ( layer_count == size_capacity ) {
+      size_capacity *= 2;
+      nodes_on_layer
+        = (int *) realloc( nodes_on_layer, size_capacity * sizeof(int) );
+    }
+    nodes_on_layer[layer_count++] = readNumber( "the number of nodes on a layer" );
+  }
+  skipLine();
+  createLayeredNodes( lff_file, "lff", 1, layer_count, nodes_on_layer );
+  free( nodes_on_layer );
+
+  // edges, up to the first blank line; node ids begin at 1
+  int edge_capacity = declared_edges > 0 ? declared_edges : 1;
+  int * endpoints = (int *) malloc( 2 * edge_capacity * sizeof(int) );
+  int edge_count = 0;
+  while ( ! atEndOfLine() ) {
+    if ( edge_count == edge_capacity ) {
+      edge_capacity *= 2;
+      endpoints
+        = (int *) realloc( endpoints, 2 * edge_capacity * sizeof(int) );
+    }
+    for ( int end = 0; end < 2; end++ ) {
+      int id = readNumber( "an edge endpoint" );
+      if ( id < 1 || id > number_of_nodes ) {
+        fprintf(stderr, "*** FATAL ERROR: %s, line %d: no node %d\n",
+                lff_file, input_line_number, id);
+        exit(EXIT_FAILURE);
+      }
+      endpoints[2 * edge_count + end] = id - 1;
+    }
+    edge_count++;
+    skipLine();
+  }
+  freeInputText();
+  createEdgesFromPairs( endpoints, edge_count );
+  free( endpoints );
+
+  if ( declared_nodes != number_of_nodes ) {
+    fprintf(stderr, "*** Warning: first line says %d nodes, but there are %d nodes\n",
+            declared_nodes, number_of_nodes);
+  }
+  if ( declared_layers != number_of_layers ) {
+    fprintf(stderr, "*** Warning: first line says %d layers, but there are %d layers\n",
+            declared_layers, number_of_layers);
+  }
+  if ( declared_edges != number_of_edges ) {
+    fprintf(stderr, "*** Warning: first line says %d edges, but there are %d edges\n",
+            declared_edges, number_of_edges);
+  }
+}
+
+void readMlcm( const char * mlcm_file )
+{
+  loadInputText( mlcm_file );
+  int level_count = readNumber( "the number of levels" );
+  if ( level_count < 1 ) {
+    fprintf(stderr, "*** FATAL ERROR: %s: bad number of levels, %d\n",
+            mlcm_file, level_count);
+    exit(EXIT_FAILURE);
+  }
+  int * edges_on_channel = (int *) calloc( level_count, sizeof(int) );
+  int * nodes_on_level = (int *) calloc( level_count, sizeof(int) );
+  long long total_edges = 0;
+  for ( int level = 0; level < level_count - 1; level++ ) {
+    edges_on_channel[level] = readNumber( "the number of edges of a channel" );
+    total_edges += edges_on_channel[level];
+  }
+  if ( total_edges < 0 || total_edges > INT_MAX / 2 ) {
+    fprintf(stderr, "*** FATAL ERROR: %s: bad number of edges, %lld\n",
+            mlcm_file, total_edges);
+    exit(EXIT_FAILURE);
+  }
+  for ( int level = 0; level < level_count; level++ ) {
+    nodes_on_level[level] = readNumber( "the number of nodes on a level" );
+  }
+  createLayeredNodes( mlcm_file, "mlcm", 0, level_count, nodes_on_level );
+
+  // the edges of each channel are pairs of positions on its two levels;
+  // node ids, which are also master list indices, begin at 0
+  int * endpoints = (int *) malloc( 2 * total_edges * sizeof(int) );
+  int edge_count = 0;
+  int first_on_level = 0;
+  for ( int level = 0; level < level_count - 1; level++ ) {
+    int first_on_next_level = first_on_level + nodes_on_level[level];
+    for ( int i = 0; i < edges_on_channel[level]; i++ ) {
+      int lower = readNumber( "an edge endpoint" );
+      int upper = readNumber( "an edge endpoint" );
+      if ( lower < 0 || lower >= nodes_on_level[level]
+           || upper < 0 || upper >= nodes_on_level[level + 1] ) {
+        fprintf(stderr, "*** FATAL ERROR: %s, line %d: no edge %d %d between levels %d and %d\n",
+                mlcm_file, input_line_number, lower, upper, level, level + 1);
+        exit(EXIT_FAILURE);
+      }
+      endpoints[2 * edge_count] = first_on_level + lower;
+      endpoints[2 * edge_count + 1] = first_on_next_level + upper;
+      edge_count++;
+    }
+    first_on_level = first_on_next_level;
+  }
+  freeInputText();
+  free( edges_on_channel );
+  free( nodes_on_level );
+  createEdgesFromPairs( endpoints, edge_count );
+  free( endpoints );
+}
+
 // --------------- Handling of comments
 
 void startAddingComments(void) {
@@ -743,6 +1077,117 @@ void writeDot( const char * dot_file_name,
   fclose( out );
 }
 
+// --------------- Output to GraphML files
+//
+// The text is put together in a buffer that is written with fwrite()
+// whenever it fills, so large graphs do not cost one library call per
+// attribute.
+
+#define GRAPHML_BUFFER_SIZE 65536
+
+static char graphml_buffer[GRAPHML_BUFFER_SIZE];
+static int graphml_length = 0;
+
+static void flushGraphml( FILE * out )
+{
+  fwrite( graphml_buffer, 1, graphml_length, out );
+  graphml_length = 0;
+}
+
+static void putGraphmlChar( FILE * out, char character )
+{
+  if ( graphml_length == GRAPHML_BUFFER_SIZE ) flushGraphml( out );
+  graphml_buffer[graphml_length++] = character;
+}
+
+static void putGraphmlText( FILE * out, const char * text )
+{
+  for ( ; *text != '\0'; text++ ) putGraphmlChar( out, *text );
+}
+
+/**
+ * Puts the text with the characters that are special in XML replaced by
+ * entities, so that names and comments can be used as they are
+ */
+static void putGraphmlEscaped( FILE * out, const char * text )
+{
+  for ( ; *text != '\0'; text++ ) {
+    switch ( *text ) {
+    case '&': putGraphmlText( out, "&amp;" ); break;
+    case '<': putGraphmlText( out, "&lt;" ); break;
+    case '>': putGraphmlText( out, "&gt;" ); break;
+    case '"': putGraphmlText( out, "&quot;" ); break;
+    default: putGraphmlChar( out, *text );
+    }
+  }
+}
+
+static void putGraphmlNumber( FILE * out, int number )
+{
+  char digits[16];
+  int length = 0;
+  unsigned int magnitude = number < 0 ? - (unsigned int) number : number;
+  do {
+    digits[length++] = '0' + magnitude % 10;
+    magnitude /= 10;
+  } while ( magnitude > 0 );
+  if ( number < 0 ) putGraphmlChar( out, '-' );
+  while ( length > 0 ) putGraphmlChar( out, digits[--length] );
+}
+
+static void putGraphmlAttribute( FILE * out, const char * name, int value )
+{
+  putGraphmlChar( out, ' ' );
+  putGraphmlText( out, name );
+  putGraphmlText( out, "=\"" );
+  putGraphmlNumber( out, value );
+  putGraphmlChar( out, '"' );
+}
+
+void writeGraphml( FILE * out )
+{
+  putGraphmlText( out,
+                  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                  "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\"\n"
+                  "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n"
+                  "xsi:schemaLocation=\"http://graphml.graphdrawing.org/xmlns\n"
+                  "http://graphml.graphdrawing.org/xmlns/1.0/graphml.xsd\">\n"
+                  "<comments>\n" );
+  startGettingComments();
+  char comment[MAX_NAME_LENGTH];
+  while ( getNextComment( comment ) != NULL ) {
+    putGraphmlChar( out, ' ' );
+    putGraphmlEscaped( out, comment );
+    putGraphmlChar( out, '\n' );
+  }
+  putGraphmlText( out, "</comments>\n"
+                  "<graph edgedefault=\"directed\" name=\"" );
+  putGraphmlEscaped( out, graph_name );
+  putGraphmlText( out, "\" type=\"layered\">\n" );
+  for ( int i = 0; i < number_of_nodes; i++ ) {
+    Nodeptr node = master_node_list[i];
+    putGraphmlText( out, "<node id=\"" );
+    putGraphmlEscaped( out, node->name );
+    putGraphmlChar( out, '"' );
+    putGraphmlAttribute( out, "layer", node->layer );
+    putGraphmlAttribute( out, "positionInLayer", node->position );
+    putGraphmlText( out, "/>\n" );
+  }
+  for ( int i = 0; i < number_of_edges; i++ ) {
+    Edgeptr edge = master_edge_list[i];
+    putGraphmlText( out, "<edge source=\"" );
+    putGraphmlEscaped( out, edge->down_node->name );
+    putGraphmlText( out, "\" target=\"" );
+    putGraphmlEscaped( out, edge->up_node->name );
+    putGraphmlChar( out, '"' );
+    if ( graphml_edge_crossings )
+      putGraphmlAttribute( out, "crossings", edge->crossings );
+    putGraphmlText( out, "/>\n" );
+  }
+  putGraphmlText( out, "</graph>\n</graphml>\n" );
+  flushGraphml( out );
+}
+
 // --------------- Debugging output --------------
 
 void printNode( Nodeptr node )
@@ -771,13 +1216,14 @@ void printNode( Nodeptr node )
 
 void printEdge(Edgeptr edge) {
     printf(" -- edge: %s, %s\n", edge->down_node->name, edge->up_node->name);
-    printf("   crossings = %d, fixed = %d\n", edge->crossings, edge->fixed);
+    printf("   crossings = %d, fixed_epoch = %u\n",
+           edge->crossings, edge->fixed_epoch);
 }
 
 void printLayer( int layer )
 {
-  printf("  --- layer %d nodes=%d fixed=%d\n",
-         layer, layers[layer]->number_of_nodes, layers[layer]->fixed );
+  printf("  --- layer %d nodes=%d fixed_epoch=%u\n",
+         layer, layers[layer]->number_of_nodes, layers[layer]->fixed_epoch );
   int node = 0;
   for( ; node < layers[layer]->number_of_nodes; node++ )
     {
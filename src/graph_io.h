@@ -96,6 +96,26 @@ void addNodesToLayers(void);
  */
 void readDotAndOrd( const char * dot_file, const char * ord_file );
 
+/**
+ * Reads the graph from an lff (layer first format) file, as described in
+ * scripts/lff2sgf.py, and builds the same graph that reading the output of
+ * that script would: the second line gives the number of nodes on each
+ * layer, starting with layer 0; the nodes are numbered 1, 2, ... in order of
+ * layer and then position; the edges follow, one per line, up to the first
+ * blank line or the end of the file. The graph name is the base name of the
+ * file.
+ */
+void readLff( const char * lff_file );
+
+/**
+ * Reads the graph from an mlcm file, as described in scripts/mlcm2sgf.py,
+ * and builds the same graph that reading the output of that script would:
+ * the nodes are numbered 0, 1, ... in order of level and then position and
+ * the edges of each channel are given as pairs of positions on the two
+ * levels. The graph name is the base name of the file.
+ */
+void readMlcm( const char * mlcm_file );
+
 /**
  * Deallocates memory allocated during reading of graph; see
  */
@@ -113,6 +133,15 @@ void printGraph();
  */
 void writeOrd(FILE * out);
 
+/**
+ * Writes the graph with the current layer orderings in the layered GraphML
+ * format of scripts/sgf2layered_graphml.py to the out stream: each node has
+ * its layer and position in the layer, each edge goes from its lower to
+ * its upper node and, if graphml_edge_crossings is true, also has its
+ * number of crossings. The output is buffered internally.
+ */
+void writeGraphml(FILE * out);
+
 /**
  * Writes a dot file with the given name.
  * @param dot_file_name the output file name (including .dot extension)
@@ -129,6 +158,14 @@ void writeDot(const char * dot_file_name,
                int edge_list_length
                );
 
+/**
+ * Creates a new node with the given id number, name, layer and position,
+ * without adding it to the master node list; safe to call from several
+ * threads at once
+ * @return (a pointer to) the newly created node
+ */
+Nodeptr createNumberedNode(int id, int layer, int position);
+
 /**
  * Creates a new node with the given id number
  *   and performs 2. (a)-(e) above
@@ -167,4 +204,4 @@ char * getNextComment(char * comment_buffer);
 
 #endif
 
-/*  [Last modified: 2021 02 15 at 17:00:05 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,206 @@
+/**
+ * @file greedy.c
+ * @brief Implementation of the greedy insertion preprocessor.
+ *
+ * When a node v is inserted, the cost of each position is found in a
+ * single scan of the nodes already inserted: moving v to the right past a
+ * node u changes the crossings by the number of pairs of neighbors (x of
+ * v, y of u) with x < y minus the number with x > y. Both counts come from
+ * a table, indexed by position on the neighboring layer, of the number of
+ * neighbors of v before and after each position, so the change for u is
+ * the sum of the table entries of the neighbors of u.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+
+#include"constants.h"
+#include"graph.h"
+#include"heuristics.h"
+#include"sorting.h"
+#include"greedy.h"
+
+/**
+ * DOWNWARD if the layer being built is based on the layer below, UPWARD if
+ * on the layer above (as in barycenter.c)
+ */
+static Orientation orientation;
+
+static int degree_toward( Nodeptr node )
+{
+  return orientation == DOWNWARD ? node->down_degree : node->up_degree;
+}
+
+/**
+ * @return the position of the neighbor of the node, on the layer the
+ * current one is based on, that is the i-th endpoint of its edges
+ */
+static int neighbor_position( Nodeptr node, int i )
+{
+  return orientation == DOWNWARD
+    ? node->down_edges[i]->down_node->position
+    : node->up_edges[i]->up_node->position;
+}
+
+/**
+ * Nodes with larger degree toward the neighboring layer come first; ties
+ * keep their current order
+ */
+static int compare_by_degree( const void * a, const void * b )
+{
+  Nodeptr first = * (const Nodeptr *) a;
+  Nodeptr second = * (const Nodeptr *) b;
+  int difference = degree_toward( second ) - degree_toward( first );
+  if ( difference != 0 ) return difference;
+  return first->position - second->position;
+}
+
+/**
+ * Sets the weight of each node on the layer to the average position of its
+ * neighbors, -1 if it has none, so that nodes without neighbors are placed
+ * on the far left as in barycenter.c
+ */
+static void assign_barycenters( int layer )
+{
+  for ( int i = 0; i < layers[ layer ]->number_of_nodes; i++ ) {
+    Nodeptr node = layers[ layer ]->nodes[i];
+    int degree = degree_toward( node );
+    if ( degree == 0 ) {
+      node->weight = -1;
+      continue;
+    }
+    double total = 0;
+    for ( int j = 0; j < degree; j++ )
+      total += neighbor_position( node, j );
+    node->weight = total / degree;
+  }
+}
+
+/**
+ * The nodes of the layer being built, in the order in which they are
+ * inserted, and the sorted positions of their neighbors on the layer it is
+ * based on, stored contiguously: those of node i are
+ * positions[start[i]..start[i+1]-1]
+ */
+typedef struct insertion_struct {
+  Nodeptr * nodes;
+  int * start;
+  int * positions;
+  /** work array, one entry per position on the neighboring layer */
+  int * differences;
+  int neighboring_layer_size;
+} * Insertionptr;
+
+/**
+ * Inserts node i into order[0..number_placed-1], which holds the indices
+ * of the nodes already inserted, at the position with the fewest crossings
+ * toward the neighboring layer
+ */
+static void insert_node( Insertionptr insertion, int i,
+                         int * order, int number_placed )
+{
+  const int * start = insertion->start;
+  const int * positions = insertion->positions;
+  int * differences = insertion->differences;
+  int degree = start[i + 1] - start[i];
+
+  // differences[y] = number of neighbors of the node to the left of y
+  // minus the number to the right of y
+  memset( differences, 0, insertion->neighboring_layer_size * sizeof(int) );
+  for ( int j = start[i]; j < start[i + 1]; j++ )
+    differences[ positions[j] ]++;
+  int less = 0;
+  for ( int y = 0; y < insertion->neighboring_layer_size; y++ ) {
+    int at_y = differences[y];
+    differences[y] = less - ( degree - less - at_y );
+    less += at_y;
+  }
+
+  // cost of each insertion position relative to the first one
+  double weight = insertion->nodes[i]->weight;
+  long cost = 0;
+  long best_cost = 0;
+  int best_slot = 0;
+  for ( int k = 0; k < number_placed; k++ ) {
+    int other = order[k];
+    for ( int j = start[other]; j < start[other + 1]; j++ )
+      cost += differences[ positions[j] ];
+    if ( cost < best_cost
+         || ( cost == best_cost
+              && insertion->nodes[other]->weight <= weight ) ) {
+      best_cost = cost;
+      best_slot = k + 1;
+    }
+  }
+
+  memmove( order + best_slot + 1, order + best_slot,
+           ( number_placed - best_slot ) * sizeof(int) );
+  order[ best_slot ] = i;
+}
+
+/**
+ * Builds the order of the layer by greedy insertion with respect to the
+ * layer below (DOWNWARD) or above (UPWARD)
+ */
+static void build_layer( int layer, Orientation based_on )
+{
+  orientation = based_on;
+  Layerptr layer_ptr = layers[ layer ];
+  int number_of_nodes = layer_ptr->number_of_nodes;
+  int neighboring_layer
+    = orientation == DOWNWARD ? layer - 1 : layer + 1;
+  struct insertion_struct insertion;
+  insertion.neighboring_layer_size
+    = layers[ neighboring_layer ]->number_of_nodes;
+
+  assign_barycenters( layer );
+  insertion.nodes = (Nodeptr *) malloc( number_of_nodes * sizeof(Nodeptr) );
+  memcpy( insertion.nodes, layer_ptr->nodes,
+          number_of_nodes * sizeof(Nodeptr) );
+  qsort( insertion.nodes, number_of_nodes, sizeof(Nodeptr),
+         compare_by_degree );
+
+  insertion.start = (int *) malloc( ( number_of_nodes + 1 ) * sizeof(int) );
+  insertion.start[0] = 0;
+  for ( int i = 0; i < number_of_nodes; i++ )
+    insertion.start[i + 1]
+      = insertion.start[i] + degree_toward( insertion.nodes[i] );
+  insertion.positions
+    = (int *) malloc( ( insertion.start[ number_of_nodes ] + 1 )
+                      * sizeof(int) );
+  for ( int i = 0; i < number_of_nodes; i++ )
+    for ( int j = 0; j < degree_toward( insertion.nodes[i] ); j++ )
+      insertion.positions[ insertion.start[i] + j ]
+        = neighbor_position( insertion.nodes[i], j );
+  insertion.differences
+    = (int *) malloc( ( insertion.neighboring_layer_size + 1 )
+                      * sizeof(int) );
+
+  int * order = (int *) malloc( ( number_of_nodes + 1 ) * sizeof(int) );
+  for ( int i = 0; i < number_of_nodes; i++ )
+    insert_node( & insertion, i, order, i );
+  for ( int k = 0; k < number_of_nodes; k++ )
+    layer_ptr->nodes[k] = insertion.nodes[ order[k] ];
+  updateNodePositions( layer );
+
+  free( order );
+  free( insertion.differences );
+  free( insertion.positions );
+  free( insertion.start );
+  free( insertion.nodes );
+}
+
+void greedyInsertion( void )
+{
+  int start = maxDegreeLayer();
+  for ( int layer = start + 1; layer < number_of_layers; layer++ )
+    build_layer( layer, DOWNWARD );
+  for ( int layer = start - 1; layer >= 0; layer-- )
+    build_layer( layer, UPWARD );
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
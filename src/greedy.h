@@ -0,0 +1,32 @@
+/**
+ * @file greedy.h
+ * @brief Greedy insertion preprocessor (-p greedy), which builds the order
+ * of each layer from scratch.
+ *
+ * The layer with the largest total degree keeps its order. The layers above
+ * it are built one at a time going up, each with respect to the layer below
+ * it, and then the layers below it going down, each with respect to the
+ * layer above it. The nodes of a layer are inserted in decreasing order of
+ * their degree toward that neighboring layer, each at the position among
+ * the nodes already inserted that minimizes the crossings of their edges to
+ * it; ties go to the position that agrees with the barycenter order.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef GREEDY_H
+#define GREEDY_H
+
+/**
+ * Reorders every layer except the one with the largest total degree by
+ * greedy insertion. Inserting a node takes time proportional to the number
+ * of edges of the nodes already inserted plus the size of the neighboring
+ * layer, so a layer of n nodes is built in O(n (n + m)) time, where m is
+ * the number of edges in its channel.
+ */
+void greedyInsertion( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -37,6 +37,10 @@
 #include"swap.h"
 #include"timing.h"
 #include"random.h"
+#include"exchange.h"
+#include"evaluation.h"
+#include"freeze.h"
+#include"verticality.h"
 
 /**
  * if trace_freq is <= TRACE_FREQ_THRESHOLD, then a message is printed at the
@@ -46,6 +50,7 @@
 
 int iteration = 0;
 int pass = 0;
+const char * stopping_reason = "heuristic_done";
 int post_processing_iteration = 0;
 
 int min_crossings = INT_MAX;
@@ -86,6 +91,7 @@ void createDotFileName( char * output_file_name, const char * appendix )
  */
 static void trace_printer( int layer, const char * message )
 {
+  synchronizeEvaluation();
   updateAllCrossings();
   int number_of_crossings = numberOfCrossings();
   int bottleneck_crossings = maxEdgeCrossings();
@@ -116,25 +122,34 @@ void tracePrint( int layer, const char * message )
 }
 
 /**
- * @return true if none of the measures of interest have improved
- * since the last call to this function
+ * number of consecutive passes without improvement, compared with patience
+ */
+static int passes_without_improvement = 0;
+
+/**
+ * @return true if none of the measures of interest, i.e., the
+ * termination_objectives, have improved (by more than the
+ * improvement_threshold) since the last call to this function
  *
- * <em>Side effect:</em> all measures are updated
- * @todo should probably rethink this to focus on relevant measures
+ * <em>Side effect:</em> the measures of interest are updated; the others
+ * are not looked at
  */
 static bool no_improvement( void )
 {
+  synchronizeEvaluation();
   // avoid shortcut logic to make sure side effects really happen
-  bool better_total_crossings = has_improved_int( & total_crossings );
-  bool better_max_edge_crossings = has_improved_int( & max_edge_crossings );
-  bool better_total_stretch = has_improved_double( & total_stretch );
-  bool better_bottleneck_stretch = has_improved_double( & bottleneck_stretch );
-  return
-    ! better_total_crossings
-    && ! better_max_edge_crossings
-    && ! better_total_stretch
-    && ! better_bottleneck_stretch
-    ;
+  bool improved = false;
+  if ( termination_objectives & TERMINATE_ON_TOTAL )
+    improved |= has_improved_int( & total_crossings );
+  if ( termination_objectives & TERMINATE_ON_BOTTLENECK )
+    improved |= has_improved_int( & max_edge_crossings );
+  if ( termination_objectives & TERMINATE_ON_STRETCH )
+    improved |= has_improved_double( & total_stretch );
+  if ( termination_objectives & TERMINATE_ON_BOTTLENECK_STRETCH )
+    improved |= has_improved_double( & bottleneck_stretch );
+  if ( termination_objectives & TERMINATE_ON_NONVERTICALITY )
+    improved |= has_improved_double( & total_nonverticality );
+  return ! improved;
 }
 
 /**
@@ -166,6 +181,10 @@ bool end_of_iteration( void )
   if( capture_iteration == iteration && write_files ) {
       char appendix[MAX_NAME_LENGTH];
       sprintf(appendix, "%d", iteration);
+      if ( graphml_edge_crossings ) {
+        updateAllCrossings();
+        ensureCrossingCounts( EDGE_COUNTS );
+      }
       writeFile(appendix);
   }
 #ifdef DEBUG
@@ -191,6 +210,8 @@ bool end_of_iteration( void )
   update_best_all();
   if ( iteration >= max_iterations ||  RUNTIME >= max_runtime ) {
       done = true;
+      stopping_reason
+        = iteration >= max_iterations ? "max_iterations" : "max_runtime";
       print_last_iteration_message();
   }
   iteration++;
@@ -223,67 +244,105 @@ static void print_standard_termination_message()
 }
 
 /**
- * Called at the end of a pass.
+ * Called at the end of a pass; this is also where best orders are exchanged
+ * with concurrent processes if the -X option was given.
  * @return true if one of the following holds
  *          - # of iterations >= what user specified with the -i option
  *          - # of passes >= what user specified with the -a option
- *          - no improvement has occurred in any objective if neither -i nor -a specified
+ *          - no improvement has occurred in any of the termination_objectives
+ *            during the last patience passes if none of -i, -a and -r
+ *            was specified
  * Prints a message about failure to improve even if stopping criterion is
- * number of iterations.
+ * number of iterations; records the reason for stopping in stopping_reason.
  */
 static bool terminate()
 {
+  // publish best orders and possibly adopt a better one from another process
+  // before deciding whether there has been improvement
+  if ( exchangeAttached() ) {
+    synchronizeEvaluation();
+    exchangeBestOrders();
+  }
+
   // no_improvement() has side effects
-  bool no_improvement_seen
-    = no_improvement();
+  if ( no_improvement() )
+    passes_without_improvement++;
+  else
+    passes_without_improvement = 0;
+  bool out_of_patience = passes_without_improvement >= patience;
 
   // separating message from actual termination
-  if ( no_improvement_seen )
+  if ( out_of_patience )
     print_standard_termination_message();
 
-  if ( standard_termination && no_improvement_seen ) return true;
-  if ( iteration >= max_iterations ) return true;
-  if ( pass >= max_passes ) return true;
+  if ( standard_termination && out_of_patience ) {
+    stopping_reason = "no_improvement";
+    return true;
+  }
+  if ( iteration >= max_iterations ) {
+    stopping_reason = "max_iterations";
+    return true;
+  }
+  if ( pass >= max_passes ) {
+    stopping_reason = "max_passes";
+    return true;
+  }
   pass++;
   return false;
 }
 
+/**
+ * @return true if every layer is frozen (-L), in which case the reason for
+ * stopping is recorded
+ */
+static bool all_layers_frozen( void )
+{
+  if ( ! allLayersFrozen() ) return false;
+  stopping_reason = "all_layers_frozen";
+  return true;
+}
+
 #endif // ! defined( TEST )
 
-bool isFixedNode( Nodeptr node ) { return node->fixed; }
-bool isFixedEdge( Edgeptr edge ) { return edge->fixed; }
-bool isFixedLayer( int layer ) { return layers[layer]->fixed; }
-void fixNode( Nodeptr node ) { node->fixed = true; }
-void fixEdge( Edgeptr edge ) { edge->fixed = true; }
-void fixLayer( int layer ) { layers[layer]->fixed = true; }
+/**
+ * Fixed marks are epoch stamps: an element is fixed iff its stamp equals the
+ * current epoch for its kind, so clearing all marks amounts to starting a
+ * new epoch. Epochs start at 1 so that freshly allocated elements (stamp 0)
+ * are unfixed. The number of fixed nodes in the current epoch is maintained
+ * so that allNodesFixed() takes constant time.
+ */
+static unsigned int node_epoch = 1;
+static unsigned int edge_epoch = 1;
+static unsigned int layer_epoch = 1;
+static int fixed_node_count = 0;
+
+bool isFixedNode( Nodeptr node ) { return node->fixed_epoch == node_epoch; }
+bool isFixedEdge( Edgeptr edge ) { return edge->fixed_epoch == edge_epoch; }
+bool isFixedLayer( int layer ) {
+  return layers[layer]->fixed_epoch == layer_epoch;
+}
 
-bool allNodesFixed( void ) {
-    for ( int index = 0; index < number_of_nodes; index++ ) {
-        Nodeptr node = master_node_list[index];
-        if( ! isFixedNode( node ) ) return false;
-    }
-    return true;
+void fixNode( Nodeptr node ) {
+  if ( node->fixed_epoch != node_epoch ) {
+    node->fixed_epoch = node_epoch;
+    fixed_node_count++;
+  }
 }
 
+void fixEdge( Edgeptr edge ) { edge->fixed_epoch = edge_epoch; }
+
+void fixLayer( int layer ) { layers[layer]->fixed_epoch = layer_epoch; }
+
+bool allNodesFixed( void ) { return fixed_node_count >= number_of_nodes; }
+
 void clearFixedNodes( void ) {
-    for ( int index = 0; index < number_of_nodes; index++ ) {
-        Nodeptr node = master_node_list[index];
-        node->fixed = false;
-    }
+  node_epoch++;
+  fixed_node_count = 0;
 }
 
-void clearFixedEdges( void ) {
-    for ( int index = 0; index < number_of_edges; index++ ) {
-        Edgeptr edge = master_edge_list[index];
-        edge->fixed = false;
-    }
-}
+void clearFixedEdges( void ) { edge_epoch++; }
 
-void clearFixedLayers( void ) {
-    for( int layer = 0; layer < number_of_layers; layer++ ) {
-        layers[ layer ]->fixed = false;
-    }
-}
+void clearFixedLayers( void ) { layer_epoch++; }
 
 int totalDegree( int layer )
 {
@@ -338,6 +397,8 @@ void median( void )
   tracePrint( -1, "^^^ start median" );
   while( ! terminate() )
     {
+      if ( all_layers_frozen() )
+        return;
       // return if max iterations have been reached as reported by one of the
       // sweep functions
       if ( medianUpSweep( 1 ) )
@@ -353,6 +414,8 @@ void barycenter( void )
   tracePrint( -1, "^^^ start barycenter" );
   while( ! terminate() )
     {
+      if ( all_layers_frozen() )
+        return;
       // return if max iterations have been reached as reported by one of the
       // sweep functions
       if ( barycenterUpSweep( 1 ) )
@@ -367,6 +430,8 @@ void modifiedBarycenter( void )
 {
   tracePrint( -1, "^^^ start modified barycenter" );
   while( ! terminate() ) {
+      if ( all_layers_frozen() )
+        return;
       clearFixedLayers();
       /* quit when all layers are fixed */
       while ( true ) {
@@ -403,6 +468,7 @@ void modifiedBarycenter( void )
 static bool sift_iteration( Nodeptr node )
 {
   sift( node );
+  if ( block_sift_window > 0 ) block_sift( node, block_sift_window );
   fixNode( node );
   sprintf( buffer, "$$$ %s, node = %s", heuristic, node->name );
   tracePrint( node->layer, buffer );
@@ -479,6 +545,18 @@ static bool total_stretch_sift_iteration( Nodeptr node ) {
   return false;
 }
 
+static bool nonverticality_sift_iteration( Nodeptr node ) {
+  sift_node_for_nonverticality( node );
+  fixNode( node );
+  updateAllCrossings();
+  sprintf( buffer, "$$$ %s, node = %s, position = %d",
+           heuristic, node->name, node->position );
+  tracePrint( node->layer, buffer );
+  if ( end_of_iteration() )
+    return true;
+  return false;
+}
+
 void maximumCrossingsNode( void )
 {
   tracePrint( -1, "^^^ start maximum crossings node" );
@@ -614,6 +692,29 @@ void maximumStretchEdge( void ) {
   }
 }
 
+void maximumNonverticalityEdge( void ) {
+  tracePrint( -1, "^^^ start maximum nonverticality edge" );
+  while( ! terminate() ) {
+      clearFixedNodes();
+      clearFixedEdges();
+      while ( true ) {
+        Edgeptr edge = maxNonverticalityEdge();
+        if ( edge == NULL || allNodesFixed() ) break;
+        sprintf( buffer, "->- mnv, edge %s -> %s",
+                 edge->down_node->name, edge->up_node->name );
+        tracePrint( edge->up_node->layer, buffer );
+        if ( ! isFixedNode( edge->up_node ) ) {
+          if ( nonverticality_sift_iteration( edge->up_node ) ) return;
+        }
+        if ( ! isFixedNode( edge->down_node ) ) {
+          if ( nonverticality_sift_iteration( edge->down_node ) ) return;
+        }
+        fixEdge( edge );
+      }
+      tracePrint( -1, "--- mnv, end pass" );
+  }
+}
+
 // the value used in the Matuszewski et al. paper
 #define MAX_FAILS 1
 
@@ -637,10 +738,14 @@ static bool sift_decreasing( const Nodeptr * node_array,
   int i;
   for( i = num_nodes - 1; i >= 0; i-- )
     {
+      if ( isFrozenLayer( node_array[ i ]->layer ) )
+        continue;
 #ifdef DEBUG
       printf( "  sifting i = %d, node = %s\n", i, node_array[i]->name );
 #endif
       sift( node_array[ i ] );
+      if ( block_sift_window > 0 )
+        block_sift( node_array[ i ], block_sift_window );
       tracePrint( node_array[ i ]->layer, "^^^ sift_increasing ^^^" );
       sprintf( buffer, " $$$ sift, node = %s, pos = %d",
                node_array[i]->name, node_array[i]->position );
@@ -670,7 +775,11 @@ static bool sift_increasing( const Nodeptr * node_array,
   int i;
   for( i = 0; i < num_nodes; i++ )
     {
+      if ( isFrozenLayer( node_array[ i ]->layer ) )
+        continue;
       sift( node_array[ i ] );
+      if ( block_sift_window > 0 )
+        block_sift( node_array[ i ], block_sift_window );
       tracePrint( node_array[ i ]->layer, "^^^ sift_increasing ^^^" );
       sprintf( buffer, " $$$ sift, node = %s, pos = %d",
                node_array[i]->name, node_array[i]->position );
@@ -680,11 +789,42 @@ static bool sift_increasing( const Nodeptr * node_array,
   return numberOfCrossings() < initial_crossings && iteration < max_iterations;
 }
 
+/**
+ * For sift_option LAYER: true if the layers are in decreasing order in the
+ * master node list; reversed before each pass, so that the sweeps alternate
+ * direction
+ */
+static bool layers_decreasing = true;
+
+/**
+ * Reorders the master node list between sifting passes: if randomize_order
+ * is true, ties are broken differently; for LAYER the direction of the
+ * sweep is reversed (the grouping by layer is stable, so the nodes of
+ * each layer stay in order of degree); RANDOM gets a new permutation
+ */
+static void reorder_for_next_pass( void )
+{
+  if ( sift_option == RANDOM ) {
+    genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
+    return;
+  }
+  if ( randomize_order ) {
+    genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
+    sortByDegree( master_node_list, number_of_nodes );
+  }
+  if ( sift_option == LAYER ) {
+    layers_decreasing = ! layers_decreasing;
+    sortByLayer( master_node_list, number_of_nodes, layers_decreasing );
+  }
+}
+
 void sifting( void ) {
-  // sort nodes by increasing degree (other options not implemented yet); but
-  // if randomize_order is true, then the order is randomized and the node
-  // list is resorted before each pass
-  sortByDegree( master_node_list, number_of_nodes );
+  // sort nodes by increasing degree, then reorder them before each pass if
+  // randomize_order is true or the sift option is not DEGREE; for LAYER the
+  // nodes are grouped by layer, so that consecutive sifts touch the same
+  // two channels, and stay in degree order within each layer
+  if ( sift_option != RANDOM )
+    sortByDegree( master_node_list, number_of_nodes );
 #ifdef DEBUG
   fprintf(stderr, "  sifting: nodes after sorting -\n" );
   for( index = 0; index < number_of_nodes; index++ )
@@ -698,11 +838,12 @@ void sifting( void ) {
   int fail_count = 0;
   while( ( standard_termination && fail_count < MAX_FAILS )
          || ! terminate() ) {
+    if ( all_layers_frozen() )
+      break;
     int crossings_before = numberOfCrossings();
     bool fail = false;
-    if ( randomize_order ) {
-      genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-      sortByDegree( master_node_list, number_of_nodes );
+    if ( randomize_order || sift_option != DEGREE ) {
+      reorder_for_next_pass();
     }
     fail = ! sift_decreasing( master_node_list, number_of_nodes, crossings_before );
     if ( iteration >= max_iterations )
@@ -710,9 +851,8 @@ void sifting( void ) {
     tracePrint( -1, "--- end of sifting pass" );
     if( fail ) {
       fail_count++;
-      if ( randomize_order ) {
-        genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-        sortByDegree( master_node_list, number_of_nodes );
+      if ( randomize_order || sift_option != DEGREE ) {
+        reorder_for_next_pass();
       }
       fail = ! sift_increasing( master_node_list, number_of_nodes,
                                 crossings_before );
@@ -720,9 +860,8 @@ void sifting( void ) {
         break;
     }
     else {
-      if ( randomize_order ) {
-        genrand_permute( master_node_list, number_of_nodes, sizeof(Nodeptr) );
-        sortByDegree( master_node_list, number_of_nodes );
+      if ( randomize_order || sift_option != DEGREE ) {
+        reorder_for_next_pass();
       }
       fail = ! sift_decreasing( master_node_list, number_of_nodes,
                                 crossings_before );
@@ -820,6 +959,7 @@ static void swap_nodes( Nodeptr * node_array, int i, int j )
   Nodeptr temp = node_array[i];
   node_array[i] = node_array[j];
   node_array[j] = temp;
+  LAYER_CHANGED( temp->layer );
 }
 
 /**
@@ -836,8 +976,12 @@ static int swapping_iteration( int crossings, int odd_even )
   printf( "-> swapping_iteration, crossings = %d, odd = %d\n",
           crossings, odd_even );
 #endif  
+  // frozen layers are known only for channels whose crossings are current
+  if ( freeze_solved_layers ) updateAllCrossings();
   for ( int layer = odd_even; layer < number_of_layers; layer += 2 )
     {
+      if ( isFrozenLayer( layer ) )
+        continue;
       Layerptr layer_ptr = layers[ layer ];
       for ( int i = odd_even; i <  layer_ptr->number_of_nodes - 1; i += 2 )
         {
@@ -865,6 +1009,23 @@ static int swapping_iteration( int crossings, int odd_even )
 }
 
 
+/**
+ * Tries a block move starting at each position of each layer
+ * @return the number of crossings saved
+ */
+static int block_sifting_pass( void )
+{
+  int reduction = 0;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    {
+      Layerptr layer_ptr = layers[ layer ];
+      for ( int i = 0; i < layer_ptr->number_of_nodes; i++ )
+        reduction += block_sift( layer_ptr->nodes[i], block_sift_window );
+      tracePrint( layer, "<-> block moves" );
+    }
+  return reduction;
+}
+
 /**
  * !!! attempted to update this so that it would fix the Pareto frontier, but
        a swapping iteration does not actually recompute total crossings !!!
@@ -910,6 +1071,20 @@ void swapping( void )
       // don't set improved to false here -- there may have been improvement
       // during the even iteration
       post_processing_iteration++;
+
+      // when swaps no longer help, block moves may
+      if ( ! improved && block_sift_window > 0 )
+        {
+          post_processing_crossings -= block_sifting_pass();
+          if ( post_processing_crossings < previous_best_crossings )
+            {
+              improved = true;
+              save_order( best_crossings_order );
+              previous_best_crossings = post_processing_crossings;
+              update_best_all();
+            }
+          post_processing_iteration++;
+        }
       tracePrint( -1, "-- end of swapping pass" );
     } // while improved
 
@@ -921,4 +1096,4 @@ void swapping( void )
 
 #endif // ! defined(TEST)
 
-/*  [Last modified: 2021 02 15 at 20:50:03 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
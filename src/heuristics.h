@@ -21,6 +21,19 @@
  */
 extern int iteration;
 
+/**
+ * The current pass, for heuristics that count passes (-a option)
+ */
+extern int pass;
+
+/**
+ * Why the main heuristic stopped, reported with the run statistics:
+ * "no_improvement" (standard termination), "max_iterations",
+ * "max_passes", "max_runtime", "all_layers_frozen" (-L) or, if the
+ * heuristic stopped on its own terms, "heuristic_done"
+ */
+extern const char * stopping_reason;
+
 /**
  * The minimum total number of crossings during post processing
  */
@@ -57,7 +70,7 @@ void tracePrint( int layer, const char * message );
 bool end_of_iteration( void );
 
 // ******** maintenance of fixed nodes and layers (for many of the
-// ******** heuristics)
+// ******** heuristics); all of these take constant time
 
 bool isFixedNode( Nodeptr node );
 bool isFixedEdge( Edgeptr edge );
@@ -65,6 +78,7 @@ bool isFixedLayer( int layer );
 void fixNode( Nodeptr node );
 void fixEdge( Edgeptr edge );
 void fixLayer( int layer );
+bool allNodesFixed( void );
 void clearFixedNodes( void );
 void clearFixedEdges( void );
 void clearFixedLayers( void );
@@ -199,6 +213,14 @@ void maximumCrossingsEdgeWithSifting( void );
  */
 void maximumStretchEdge( void );
 
+/**
+ * similar to mse: in each iteration, the unfixed edge with maximum
+ * non-verticality (see verticality.h) is chosen and its unfixed endpoints
+ * are moved to positions that minimize the total non-verticality of the
+ * edges incident on their layers
+ */
+void maximumNonverticalityEdge( void );
+
 void sifting( void );
 
 // preprocessors
@@ -222,4 +244,4 @@ void swapping( void );
 
 #endif
 
-/*  [Last modified: 2021 01 06 at 16:04:34 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
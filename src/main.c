@@ -28,6 +28,16 @@
 #include"order.h"
 #include"timing.h"
 #include"random.h"
+#include"transaction.h"
+#include"tasks.h"
+#include"exchange.h"
+#include"evaluation.h"
+#include"bands.h"
+#include"scoring.h"
+#include"delta.h"
+#include"freeze.h"
+#include"greedy.h"
+#include"verticality.h"
 
 // definition of command-line options with default values
 
@@ -39,8 +49,13 @@ double runtime = 0;
 double max_runtime = DBL_MAX;
 double start_time = 0;
 bool standard_termination = true;
+int patience = 1;
+double improvement_threshold = 0;
+unsigned int termination_objectives = TERMINATE_ON_ALL;
 enum adjust_weights_enum adjust_weights = LEFT;
 enum sift_option_enum sift_option = DEGREE;
+int block_sift_window = 0;
+bool freeze_solved_layers = false;
 enum mce_option_enum mce_option = NODES;
 enum sifting_style_enum sifting_style = DEFAULT;
 enum pareto_objective_enum pareto_objective = NO_PARETO;
@@ -81,18 +96,39 @@ bool write_stdout = false;
 
 bool verbose = false;
 int trace_freq = -1;
+int number_of_threads = 1;
 
 // definition of order saving structures
 Orderptr best_crossings_order = NULL;
 Orderptr best_edge_crossings_order = NULL;
 Orderptr best_total_stretch_order = NULL;
 Orderptr best_bottleneck_stretch_order = NULL;
+Orderptr best_nonverticality_order = NULL;
 Orderptr best_favored_crossings_order = NULL;
 
 /** buffer to be used for all output file names */
 
 static bool do_post_processing = false;
 
+/** true if best orders are to be exchanged with concurrent processes (-X) */
+static bool exchange_requested = false;
+
+/** true if objectives are to be evaluated on a helper thread (-A) */
+static bool asynchronous_evaluation_requested = false;
+
+/** true if only the crossing counts read by the heuristic are to be
+ * maintained (-C) */
+static bool count_only_needed = false;
+
+/** number of bands minimized by separate worker processes (-B) */
+static int number_of_bands = 1;
+
+/** true if the order of every Pareto point is to be written (-F) */
+static bool write_pareto_orders = false;
+
+/** file of candidate orderings to be scored, "-" for stdin (-S) */
+static char * candidate_file_name = NULL;
+
 /**
  * prints usage message
  *
@@ -104,14 +140,17 @@ static void printUsage( void )
   fprintf(stderr, "Usage: minimization [opts] [file(s)]\n"
           " the file(s) part is\n"
           "   * missing - read from stdin and assume sgf format (only if -I is an opt)\n"
-          "   * one file name - assumed to be an sgf file\n"
+          "   * one file name - an lff (.lff) or mlcm (.mlcm) file, otherwise sgf\n"
           "   * two file names - assumed to be a dot and an ord file\n");
   fprintf(stderr, " the opts are zero or more of the following\n" );
   fprintf(stderr,
          "  -I read from standard input, assume sgf format\n"
          "  -h (median | bary | mod_bary | mcn | sifting | mce | mce_s | mse\n"
-         "     [main heuristic - default none]\n"
-         "  -p (bfs | dfs | mds) [preprocessing - default none]\n"
+         "     | mnv) [main heuristic - default none]\n"
+         "  -p (bfs | dfs | mds | greedy) [preprocessing - default none]\n"
+         "      greedy builds each layer by inserting its nodes one at a time\n"
+         "      where they cause the fewest crossings, outward from the layer\n"
+         "      with the most edges\n"
          "  -z if post processing (repeated swaps until no improvement) is desired\n"
          "  -i MAX_ITERATIONS [default: stop if no improvement]\n"
          "  -a MAX_PASSES     [default: stop if no improvement]\n"
@@ -119,6 +158,11 @@ static void printUsage( void )
          "     after each pass of mod_bary, mce, mcn, mse, sifting, etc.\n"
          "     to break ties differently when sorting; SEED is an integer seed\n"
          "  -r SECONDS = maximum runtime [stop if no improvement]\n"
+         "  -k PATIENCE stop if no improvement in PATIENCE consecutive passes\n"
+         "      [default: 1]; only the objectives given with -o and -P count,\n"
+         "      all of them if neither is given\n"
+         "  -e EPSILON an improvement must be by more than the fraction EPSILON\n"
+         "      of the best value so far to count [default: 0]\n"
          "  -c ITERATION [capture the order after this iteration in a file or stdout]\n"
          "  -P PARETO_OBJECTIVES (b_t | s_t | b_s) pair of objectives for Pareto optima\n"
          "      b = bottleneck, t = total, s = stretch (default = none)\n"
@@ -130,12 +174,42 @@ static void printUsage( void )
          "  -O (upper case oh) send output to stdout\n"
          "  -o OBJECTIVE write best configuration for OBJECTIVE as sgf output to stdout\n"
          "      t = total (default), b = bottleneck, s = stretch, bs = bottleneck stretch\n"
+         "      v = non-verticality (sum of squared position differences of edges)\n"
          "     if -P is used, the line with Pareto optima is appended as a comment\n"
+         "     -o and -P also select the objectives that standard termination\n"
+         "     looks at (see -k)\n"
+         "  -F with -P and -w, also write the order of each Pareto point\n"
+         "      to a file whose objective tag is pareto_K, K = 0, 1, ...\n"
+         "  -D with -w, write only the runs of positions whose order differs from\n"
+         "      the input order (EXT is delta); apply_delta applies such a file\n"
+         "  -G (layers | crossings) with -w, write layered GraphML (EXT is graphml)\n"
+         "      with the layer and position of each node; crossings also gives\n"
+         "      the number of crossings of each edge\n"
          "  -s (layer | degree | random) [sifting variation - see paper]\n"
+         "  -b WINDOW also move blocks of adjacent nodes as a unit in sifting, mcn,\n"
+         "      mce_s and post processing; a block is a run of nodes with the same\n"
+         "      neighbors or else WINDOW nodes (0 = no block moves, the default)\n"
+         "  -L freeze solved layers: the sweeps, sifting, mod_bary and post\n"
+         "      processing skip a layer whose channels have no crossings, or as\n"
+         "      few as the orders of its neighbors allow, until a neighbor changes\n"
          "  -g (total | max) [what sifting is based on] [default: total for sifting, mcn; max for mce]\n"
          "      [not implemented yet]\n"
          "  -v to get verbose information about the graph\n"
          "  -t trace_freq, if trace printout is desired, 0 means only at the end of a pass, > 0 sets frequency\n"
+         "  -T THREADS number of threads for parallel work [default: 1]\n"
+         "  -X exchange best orders with concurrent processes on the same graph\n"
+         "      via shared memory; adopt better orders from them between passes\n"
+         "  -A evaluate objectives other than that of the heuristic on a helper\n"
+         "      thread, asynchronously [results are the same]\n"
+         "  -C maintain only the crossing counts the heuristic reads: totals for\n"
+         "      median, bary, mod_bary, sifting, mse and mnv, node counts for mcn;\n"
+         "      the others are computed only for bottleneck crossings and\n"
+         "      all are maintained during post-processing (-z)\n"
+         "      [results are the same; ignored with -A]\n"
+         "  -B BANDS split the layers into BANDS bands, each minimized by a\n"
+         "      separate process; boundary layers are exchanged between rounds\n"
+         "  -S CANDIDATES score each candidate ordering in file CANDIDATES\n"
+         "      (- for stdin) instead of minimizing; see scoring.h for formats\n"
          );
 }
 
@@ -150,6 +224,8 @@ static void runPreprocessor( void )
     depthFirstSearch();
   else if( strcmp( preprocessor, "mds" ) == 0 )
     middleDegreeSort();
+  else if( strcmp( preprocessor, "greedy" ) == 0 )
+    greedyInsertion();
   else
     {
       fprintf(stderr,  "*** FATAL ERROR: Bad preprocessor '%s'\n", preprocessor );
@@ -158,6 +234,32 @@ static void runPreprocessor( void )
     }
 }
 
+/**
+ * Writes a file for the current order; GraphML output with edge crossings
+ * needs the crossings of that order, which may not have been computed
+ */
+static void writeOrderFile( const char * objective_tag )
+{
+  if ( graphml_edge_crossings ) {
+    updateAllCrossings();
+    ensureCrossingCounts( EDGE_COUNTS );
+  }
+  writeFile( objective_tag );
+}
+
+/**
+ * @return the crossing counts read by the heuristic: those of the edges for
+ * mce and mce_s, those of the nodes for mcn and only the totals otherwise
+ */
+static CrossingCounts counts_for_heuristic( void )
+{
+  if ( strcmp( heuristic, "mce" ) == 0 || strcmp( heuristic, "mce_s" ) == 0 )
+    return EDGE_COUNTS;
+  if ( strcmp( heuristic, "mcn" ) == 0 )
+    return NODE_COUNTS;
+  return TOTAL_COUNTS;
+}
+
 /**
  * @todo It would be nice to have a way to run two heuristics, one after the
  * other. Not really needed - can always use the output file of one as input
@@ -186,6 +288,9 @@ static void runHeuristic( void )
   else if( strcmp( heuristic, "mse" ) == 0 ) {
     maximumStretchEdge();
   }
+  else if( strcmp( heuristic, "mnv" ) == 0 ) {
+    maximumNonverticalityEdge();
+  }
   else {
       fprintf(stderr,  "*** FATAL ERROR: Bad heuristic '%s'\n", heuristic );
       printUsage();
@@ -214,6 +319,11 @@ void deallocateAll(void) {
     deallocateCrossings();
     deallocateChannels();
     deallocateParetoList();
+    deallocateTransactions();
+    deallocateTasks();
+    detachExchange();
+    deallocateFrozenLayers();
+    deallocateNonverticality();
 }
 
 /**
@@ -245,7 +355,7 @@ int main( int argc, char * argv[] )
   // process command-line options; these must come before the file arguments
   // note: options that have an arg are followed by : but others are
   // not
-  while ( (ch = getopt(argc, argv, "a:c:fgh:Ii:Oo:p:P:R:r:s:t:vw:z")) != -1)
+  while ( (ch = getopt(argc, argv, "Aa:B:b:Cc:De:FfG:gh:Ii:k:LOo:p:P:R:r:S:s:T:t:vw:Xz")) != -1)
     {
       switch(ch)
         {
@@ -308,6 +418,26 @@ int main( int argc, char * argv[] )
           standard_termination = false;
           break;
 
+        case 'k':
+            if ( strspn(optarg, "0123456789") != strlen(optarg)
+                 || atoi( optarg ) < 1 ) {
+                fprintf(stderr, "*** FATAL ERROR: Value '%s' for -k option is not a positive integer\n", optarg);
+                printUsage();
+                exit( EXIT_FAILURE );
+            }
+          patience = atoi( optarg );
+          break;
+
+        case 'e':
+            if ( strspn(optarg, ".0123456789") != strlen(optarg)
+                 || atof( optarg ) >= 1 ) {
+                fprintf(stderr, "*** FATAL ERROR: Value '%s' for -e option is not a fraction less than 1\n", optarg);
+                printUsage();
+                exit( EXIT_FAILURE );
+            }
+          improvement_threshold = atof( optarg );
+          break;
+
         case 'P':
           if ( strcmp( optarg, "b_t" ) == 0 ) pareto_objective = BOTTLENECK_TOTAL;
           else if ( strcmp( optarg, "s_t" ) == 0 ) pareto_objective = STRETCH_TOTAL; 
@@ -336,7 +466,8 @@ int main( int argc, char * argv[] )
             if ( strcmp(optarg, "t") != 0
                  && strcmp(optarg, "b") != 0
                  && strcmp(optarg, "s") != 0
-                 && strcmp(optarg, "bs") != 0 ) {
+                 && strcmp(optarg, "bs") != 0
+                 && strcmp(optarg, "v") != 0 ) {
                 fprintf(stderr,  "*** FATAL ERROR: Bad value '%s' for option -o\n", optarg );
                 printUsage();
                 exit(EXIT_FAILURE);
@@ -351,6 +482,16 @@ int main( int argc, char * argv[] )
             strcpy(base_name_arg, optarg);
             break;
 
+        case 'b':
+          if ( strspn(optarg, "0123456789") != strlen(optarg)
+               || strlen(optarg) == 0 ) {
+            fprintf(stderr, "*** FATAL ERROR: Value '%s' for -b option is not a nonnegative integer\n", optarg);
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
+          block_sift_window = atoi( optarg );
+          break;
+
         case 's':
           if( strcmp( optarg, "layer" ) == 0 ) sift_option = LAYER;
           else if( strcmp( optarg, "degree" ) == 0 ) sift_option = DEGREE; 
@@ -386,6 +527,66 @@ int main( int argc, char * argv[] )
           trace_freq = atoi( optarg );
           break;
 
+        case 'T':
+          if ( strspn(optarg, "0123456789") != strlen(optarg)
+               || atoi( optarg ) < 1 ) {
+            fprintf(stderr, "*** FATAL ERROR: Value '%s' for -T option is not a positive integer\n", optarg);
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
+          number_of_threads = atoi( optarg );
+          break;
+
+        case 'X':
+          exchange_requested = true;
+          break;
+
+        case 'A':
+          asynchronous_evaluation_requested = true;
+          break;
+
+        case 'C':
+          count_only_needed = true;
+          break;
+
+        case 'L':
+          freeze_solved_layers = true;
+          break;
+
+        case 'B':
+          if ( strspn(optarg, "0123456789") != strlen(optarg)
+               || atoi( optarg ) < 1 ) {
+            fprintf(stderr, "*** FATAL ERROR: Value '%s' for -B option is not a positive integer\n", optarg);
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
+          number_of_bands = atoi( optarg );
+          break;
+
+        case 'S':
+          candidate_file_name = optarg;
+          break;
+
+        case 'F':
+          write_pareto_orders = true;
+          break;
+
+        case 'D':
+          write_delta_output = true;
+          break;
+
+        case 'G':
+          if ( strcmp( optarg, "layers" ) == 0 ) ;
+          else if ( strcmp( optarg, "crossings" ) == 0 )
+            graphml_edge_crossings = true;
+          else {
+            fprintf(stderr, "*** FATAL ERROR: Bad value '%s' for -G option\n", optarg);
+            printUsage();
+            exit( EXIT_FAILURE );
+          }
+          write_graphml_output = true;
+          break;
+
         default:
           printUsage();
           exit( EXIT_FAILURE );
@@ -399,6 +600,64 @@ int main( int argc, char * argv[] )
   argc -= optind;
   argv += optind;
 
+  initializeTasks( number_of_threads );
+
+  if ( write_pareto_orders && ( ! write_files || pareto_objective == NO_PARETO ) ) {
+    fprintf(stderr, "*** Warning: -F has no effect without -P and -w\n");
+  }
+  if ( write_graphml_output && ! write_files ) {
+    fprintf(stderr, "*** Warning: -G has no effect without -w\n");
+  }
+  if ( write_delta_output && ! write_files ) {
+    fprintf(stderr, "*** Warning: -D has no effect without -w\n");
+  }
+  if ( write_delta_output && write_graphml_output ) {
+    fprintf(stderr, "*** Warning: -G is ignored with -D\n");
+  }
+
+  // the band workers have their own copies of the graph; neither the shared
+  // memory exchange nor the helper thread would see their orders
+  if ( number_of_bands > 1
+       && ( exchange_requested || asynchronous_evaluation_requested ) ) {
+    fprintf(stderr, "*** Warning: -X and -A are ignored with -B\n");
+    exchange_requested = false;
+    asynchronous_evaluation_requested = false;
+  }
+
+  // the snapshots for the helper thread copy the per-edge counts
+  if ( count_only_needed && asynchronous_evaluation_requested ) {
+    fprintf(stderr, "*** Warning: -C is ignored with -A\n");
+    count_only_needed = false;
+  }
+  if ( count_only_needed ) {
+    setCrossingCounts( counts_for_heuristic() );
+  }
+
+  // standard termination looks only at the objectives of interest
+  if ( objective != NULL || pareto_objective != NO_PARETO ) {
+    if ( objective == NULL )
+      termination_objectives = 0;
+    else if ( strcmp( objective, "t" ) == 0 )
+      termination_objectives = TERMINATE_ON_TOTAL;
+    else if ( strcmp( objective, "b" ) == 0 )
+      termination_objectives = TERMINATE_ON_BOTTLENECK;
+    else if ( strcmp( objective, "s" ) == 0 )
+      termination_objectives = TERMINATE_ON_STRETCH;
+    else if ( strcmp( objective, "bs" ) == 0 )
+      termination_objectives = TERMINATE_ON_BOTTLENECK_STRETCH;
+    else
+      termination_objectives = TERMINATE_ON_NONVERTICALITY;
+    if ( pareto_objective == BOTTLENECK_TOTAL )
+      termination_objectives |= TERMINATE_ON_BOTTLENECK | TERMINATE_ON_TOTAL;
+    else if ( pareto_objective == STRETCH_TOTAL )
+      termination_objectives |= TERMINATE_ON_STRETCH | TERMINATE_ON_TOTAL;
+    else if ( pareto_objective == BOTTLENECK_STRETCH )
+      termination_objectives |= TERMINATE_ON_BOTTLENECK | TERMINATE_ON_STRETCH;
+  }
+  else if ( strcmp( heuristic, "mnv" ) == 0 ) {
+    termination_objectives |= TERMINATE_ON_NONVERTICALITY;
+  }
+
   input_base_name[0] = '\0';
   if ( argc == 2 ) {
       const char * dot_file_name = argv[0];
@@ -414,14 +673,24 @@ int main( int argc, char * argv[] )
       }
   } // end, dot and ord input
   else if ( argc == 1 ) {
-      char * sgf_file_name = argv[0];
-      FILE * input_stream = fopen(sgf_file_name, "r");
-      if ( input_stream == NULL ) {
-        fprintf(stderr, "*** FATAL ERROR: file %s could not be opened\n", sgf_file_name);
-        exit(EXIT_FAILURE);
+      // the format is sgf unless the extension says otherwise
+      char * input_file_name = argv[0];
+      char * extension = strrchr(input_file_name, '.');
+      if ( extension != NULL && strcmp(extension, ".lff") == 0 ) {
+        readLff(input_file_name);
+      }
+      else if ( extension != NULL && strcmp(extension, ".mlcm") == 0 ) {
+        readMlcm(input_file_name);
+      }
+      else {
+        FILE * input_stream = fopen(input_file_name, "r");
+        if ( input_stream == NULL ) {
+          fprintf(stderr, "*** FATAL ERROR: file %s could not be opened\n", input_file_name);
+          exit(EXIT_FAILURE);
+        }
+        readSgf(input_stream);
+        fclose(input_stream);
       }
-      readSgf(input_stream);
-      fclose(input_stream);
       if ( write_files ) {
           write_sgf_output = true;
       }
@@ -454,6 +723,40 @@ int main( int argc, char * argv[] )
          fprintf(stderr, "***          output base defaults to graph name\n");
   }
 
+  // delta output is relative to the order in which the graph was read
+  if ( write_files && write_delta_output ) {
+      captureInputOrder();
+  }
+
+  // scoring replaces minimization; the graph is left as it was read
+  if ( candidate_file_name != NULL ) {
+      FILE * candidate_stream = stdin;
+      if ( strcmp( candidate_file_name, "-" ) == 0 ) {
+          if ( stdin_requested ) {
+              fprintf(stderr, "*** FATAL ERROR: graph and candidates cannot both come from stdin\n");
+              exit(EXIT_FAILURE);
+          }
+      }
+      else {
+          candidate_stream = fopen( candidate_file_name, "r" );
+          if ( candidate_stream == NULL ) {
+              fprintf(stderr, "*** FATAL ERROR: file %s could not be opened\n", candidate_file_name);
+              exit(EXIT_FAILURE);
+          }
+      }
+      scoreCandidates( candidate_stream );
+      if ( candidate_stream != stdin ) fclose( candidate_stream );
+      deallocateGraph();
+      deallocateTasks();
+      return EXIT_SUCCESS;
+  }
+
+
+  // must precede preprocessing and heuristics, which permute the master
+  // node and edge lists
+  if ( exchange_requested ) {
+      attachExchange();
+  }
 
   addComment(command_line, true);
   
@@ -494,6 +797,10 @@ int main( int argc, char * argv[] )
     = (Orderptr) calloc( 1, sizeof(struct order_struct) );
   init_order( best_bottleneck_stretch_order );
 
+  best_nonverticality_order
+    = (Orderptr) calloc( 1, sizeof(struct order_struct) );
+  init_order( best_nonverticality_order );
+
   best_favored_crossings_order
     = (Orderptr) calloc( 1, sizeof(struct order_struct) ); 
   init_order( best_favored_crossings_order );
@@ -511,9 +818,17 @@ int main( int argc, char * argv[] )
   fprintf(stderr,  "after preprocessor, runtime = %f\n", RUNTIME );
 #endif
 
+  if ( asynchronous_evaluation_requested ) {
+      startAsynchronousEvaluation();
+  }
+
   // end of "iteration 0"
   end_of_iteration();
-  runHeuristic();
+  if ( number_of_bands > 1 )
+    runBands( number_of_bands, runHeuristic );
+  else
+    runHeuristic();
+  finishAsynchronousEvaluation();
   capture_heuristic_stats();
 #ifdef DEBUG
   fprintf(stderr,  "after heuristic, runtime = %f\n", RUNTIME );
@@ -522,16 +837,22 @@ int main( int argc, char * argv[] )
   if ( write_files ) {
       // write ordering after heuristic, before post-processing
       restore_order( best_crossings_order );
-      writeFile("t");
+      writeOrderFile("t");
   }
 
   if ( do_post_processing ) {
       restore_order( best_crossings_order );
       updateAllCrossings();
+      // swapping() takes bottleneck crossings from the per-edge counts as
+      // its swaps leave them, so they must be maintained from here on
+      if ( count_only_needed ) {
+        ensureCrossingCounts( EDGE_COUNTS );
+        setCrossingCounts( EDGE_COUNTS );
+      }
       swapping();
 
       if ( write_files ) {
-          writeFile("post");
+          writeOrderFile("post");
       }
   }
 
@@ -546,15 +867,29 @@ int main( int argc, char * argv[] )
   if ( write_files ) {
       // write file with best max edge order after overall
       restore_order( best_edge_crossings_order );
-      writeFile("b");
+      writeOrderFile("b");
 
       // write file with best stretch order overall
       restore_order( best_total_stretch_order );
-      writeFile("s");
+      writeOrderFile("s");
 
       // write file with best bottleneck stretch order overall
       restore_order( best_bottleneck_stretch_order );
-      writeFile("bs");
+      writeOrderFile("bs");
+
+      // write file with best non-verticality order overall
+      restore_order( best_nonverticality_order );
+      writeOrderFile("v");
+
+      // write a file for each point on the Pareto frontier
+      if ( write_pareto_orders && pareto_objective != NO_PARETO ) {
+          for ( int i = 0; i < numberOfParetoPoints(); i++ ) {
+              char appendix[MAX_NAME_LENGTH];
+              sprintf(appendix, "pareto_%d", i);
+              restoreParetoOrder(i);
+              writeOrderFile(appendix);
+          }
+      }
   }
 
   // write to stdout if requested; note that this is independent of
@@ -583,6 +918,9 @@ int main( int argc, char * argv[] )
       else if ( strcmp(objective, "bs") == 0 ) {
           restore_order( best_bottleneck_stretch_order );
       }
+      else if ( strcmp(objective, "v") == 0 ) {
+          restore_order( best_nonverticality_order );
+      }
       writeSgf(stdout);
   }
 
@@ -599,7 +937,10 @@ int main( int argc, char * argv[] )
   free( best_total_stretch_order );
   cleanup_order( best_bottleneck_stretch_order );
   free( best_bottleneck_stretch_order );
+  cleanup_order( best_nonverticality_order );
+  free( best_nonverticality_order );
 
+  freeInputOrder();
   deallocateAll();
 
   return EXIT_SUCCESS;
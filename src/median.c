@@ -17,6 +17,7 @@
 #include"crossings.h"
 #include"graph_io.h"
 #include"heuristics.h"
+#include"freeze.h"
 
 /**
  * @return the median position of the nodes adjacent to 'node' on the layer
@@ -181,6 +182,7 @@ bool medianUpSweep( int starting_layer )
   int layer = starting_layer;
   for( ; layer < number_of_layers; layer++ )
     {
+      if ( isFrozenLayer( layer ) ) continue;
       medianWeights( layer, DOWNWARD );
       layerSort( layer );
       updateCrossingsForLayer( layer );
@@ -200,6 +202,7 @@ bool medianDownSweep( int starting_layer )
   int layer = starting_layer;
   for( ; layer >= 0; layer-- )
     {
+      if ( isFrozenLayer( layer ) ) continue;
       medianWeights( layer, UPWARD );
       layerSort( layer );
       updateCrossingsForLayer( layer );
@@ -210,4 +213,4 @@ bool medianDownSweep( int starting_layer )
   return false;
 }
 
-/*  [Last modified: 2019 09 27 at 18:02:41 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -20,6 +20,7 @@ void medianWeights( int layer, Orientation orientation );
 /**
  * Repeats median heuristic moving upward from the starting layer to the
  * uppermost layer. Orientation of each heuristic application is downward.
+ * Frozen layers (see freeze.h) are skipped and do not count as iterations.
  *
  * @return true if max iterations was reached in the process
  */
@@ -28,6 +29,7 @@ bool medianUpSweep( int starting_layer );
 /**
  * Repeats median heuristic moving downward from the starting layer to the
  * bottom layer, layer 0. Orientation of each heuristic application is upward.
+ * Frozen layers are skipped as well.
  *
  * @return true if max iterations was reached in the process
  */
@@ -35,4 +37,4 @@ bool medianDownSweep( int starting_layer );
 
 #endif
 
-/*  [Last modified: 2011 06 20 at 19:39:19 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -9,6 +9,7 @@
 
 #include"order.h"
 #include"graph.h"
+#include"tasks.h"
 
 #ifdef DEBUG
 #include"crossings.h"
@@ -45,10 +46,13 @@ void cleanup_order( Orderptr ord_info )
   free( ord_info->num_nodes_on_layer );
 }
 
-void save_order( Orderptr ord_info )
+/**
+ * Copies the nodes of layers first, ..., last - 1 into the order
+ */
+static void save_layers( int first, int last, void * ord_info_ptr )
 {
-  ord_info->num_layers = number_of_layers;
-  for ( int i = 0; i < number_of_layers; i++ )
+  Orderptr ord_info = (Orderptr) ord_info_ptr;
+  for ( int i = first; i < last; i++ )
     {
       for( int j = 0; j < layers[i]->number_of_nodes; j++ )
         {
@@ -58,6 +62,15 @@ void save_order( Orderptr ord_info )
     }
 }
 
+void save_order( Orderptr ord_info )
+{
+  ord_info->num_layers = number_of_layers;
+  // layers are split evenly among the workers; the copies are cheap, so
+  // finer tasks would cost more than they save
+  int grain = number_of_layers / numberOfWorkers() + 1;
+  parallelFor( 0, number_of_layers, grain, save_layers, ord_info );
+}
+
 void restore_order( Orderptr ord_info )
 {
 #ifdef DEBUG
@@ -65,14 +78,18 @@ void restore_order( Orderptr ord_info )
   printf( "-> restore_order, num_layers = %d, crossings = %d\n", ord_info->num_layers, numberOfCrossings() );
 #endif
   // reorder each layer according to the information stored in ord_info
+  // only layers whose order differs count as changed
   for ( int i = 0; i < ord_info->num_layers; i++ )
     {
+      bool changed = false;
       for( int j = 0; j < ord_info->num_nodes_on_layer[i]; j++ )
         {
           Nodeptr node = ord_info->node_ptr_on_layer[i][j];
+          if ( layers[i]->nodes[j] != node ) changed = true;
           layers[i]->nodes[j] = node;
           node->position = j;
         }
+      if ( changed ) LAYER_CHANGED( i );
 #ifdef DEBUG
       updateAllCrossings();
       printf( " - restore_order, i = %d, num_nodes = %d, crossings = %d\n",
@@ -85,4 +102,4 @@ void restore_order( Orderptr ord_info )
 #endif
 }
 
-/*  [Last modified: 2011 05 23 at 21:09:34 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
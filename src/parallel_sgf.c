@@ -0,0 +1,526 @@
+/**
+ * @file parallel_sgf.c
+ * @brief Implementation of the parallel reader for the body of sgf files.
+ *
+ * Lines are handled the way the sequential reader handles them: blank lines
+ * are skipped, the first character must be the tag, and the numbers are
+ * read as sscanf() would read them. Lines too long for the line buffer of
+ * the sequential reader, which it would split, are left to it.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include"constants.h"
+#include"defs.h"
+#include"graph.h"
+#include"graph_io.h"
+#include"tasks.h"
+#include"parallel_sgf.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<ctype.h>
+#include<limits.h>
+#include<unistd.h>
+#include<sys/mman.h>
+#include<sys/stat.h>
+#include<sys/types.h>
+
+/**
+ * A piece of the text beginning and ending at line boundaries, with the
+ * numbers read from its nonblank lines: three per node (id, layer,
+ * position), two per edge (source, target)
+ */
+typedef struct chunk {
+  const char * begin;
+  const char * end;
+  int * values;
+  int capacity;
+  /** number of nodes or edges read */
+  int size;
+  /** index of the first node or edge of the chunk in the master list */
+  int offset;
+  int max_layer;
+  int min_id;
+  int max_id;
+  /** while looking for the edge section, its first line if in this chunk */
+  const char * edge_section;
+  /** true if the chunk has something the sequential reader must handle */
+  bool failed;
+} * Chunkptr;
+
+/** mapping from node ids to indices in the master list: either a direct
+ * table indexed by id - min_node_id or the indices sorted by id */
+static int * index_of_id = NULL;
+static int * indices_by_id = NULL;
+static int min_node_id;
+static int max_node_id;
+
+/**
+ * @return the end (the '\n' or the end of the text) of the line beginning
+ * at line
+ */
+static const char * end_of_line( const char * line, const char * end )
+{
+  const char * newline = memchr( line, '\n', end - line );
+  return newline == NULL ? end : newline;
+}
+
+static bool blank_line( const char * line, const char * line_end )
+{
+  for ( ; line < line_end; line++ )
+    if ( ! isspace( (unsigned char) *line ) ) return false;
+  return true;
+}
+
+/**
+ * Reads count integers the way sscanf() with " %d" would, ignoring anything
+ * after them
+ * @return true if all were read and fit in an int
+ */
+static bool read_integers( const char * text, const char * line_end,
+                           int count, int * values )
+{
+  for ( int i = 0; i < count; i++ ) {
+    while ( text < line_end && isspace( (unsigned char) *text ) ) text++;
+    bool negative = false;
+    if ( text < line_end && ( *text == '-' || *text == '+' ) ) {
+      negative = *text == '-';
+      text++;
+    }
+    if ( text == line_end || ! isdigit( (unsigned char) *text ) ) return false;
+    long long value = 0;
+    while ( text < line_end && isdigit( (unsigned char) *text ) ) {
+      value = 10 * value + (*text - '0');
+      if ( value > (long long) INT_MAX + 1 ) return false;
+      text++;
+    }
+    if ( negative ) value = -value;
+    if ( value > INT_MAX ) return false;
+    values[i] = (int) value;
+  }
+  return true;
+}
+
+/**
+ * Splits [begin, end) into number_of_chunks pieces of about equal length,
+ * each ending just after a '\n' (or at end)
+ */
+static void split_at_lines( const char * begin, const char * end,
+                            int number_of_chunks, Chunkptr chunks )
+{
+  const char * start = begin;
+  for ( int i = 0; i < number_of_chunks; i++ ) {
+    memset( &chunks[i], 0, sizeof(struct chunk) );
+    const char * stop = begin + (end - begin) / number_of_chunks * (i + 1);
+    if ( i == number_of_chunks - 1 || stop >= end ) stop = end;
+    else if ( stop > start ) stop = end_of_line( stop - 1, end ) + 1;
+    if ( stop < start ) stop = start;
+    if ( stop > end ) stop = end;
+    chunks[i].begin = start;
+    chunks[i].end = stop;
+    start = stop;
+  }
+}
+
+static void run_chunks( int number_of_chunks, Chunkptr chunks,
+                        TaskFunction function )
+{
+  struct task_group group;
+  beginTasks( &group );
+  for ( int i = 0; i < number_of_chunks; i++ )
+    forkTask( &group, function, &chunks[i] );
+  joinTasks( &group );
+}
+
+static bool any_failed( int number_of_chunks, Chunkptr chunks )
+{
+  for ( int i = 0; i < number_of_chunks; i++ )
+    if ( chunks[i].failed ) return true;
+  return false;
+}
+
+/**
+ * Finds the first nonblank line of the chunk that begins with 'e'
+ */
+static void find_edge_section( void * argument )
+{
+  Chunkptr chunk = (Chunkptr) argument;
+  const char * line = chunk->begin;
+  while ( line < chunk->end ) {
+    const char * line_end = end_of_line( line, chunk->end );
+    if ( *line == 'e' ) {
+      chunk->edge_section = line;
+      return;
+    }
+    line = line_end + 1;
+  }
+}
+
+/**
+ * Reads the numbers from each nonblank line of the chunk, which must begin
+ * with the given tag
+ */
+static void parse_lines( Chunkptr chunk, char tag, int count )
+{
+  const char * line = chunk->begin;
+  while ( line < chunk->end ) {
+    const char * line_end = end_of_line( line, chunk->end );
+    if ( line_end - line >= MAX_NAME_LENGTH - 1 ) {
+      chunk->failed = true;
+      return;
+    }
+    if ( ! blank_line( line, line_end ) ) {
+      if ( chunk->size == chunk->capacity ) {
+        chunk->capacity += chunk->capacity + CAPACITY_INCREMENT;
+        chunk->values = (int *) realloc( chunk->values,
+                                         chunk->capacity * count
+                                         * sizeof(int) );
+      }
+      int * values = chunk->values + count * chunk->size;
+      if ( *line != tag
+           || ! read_integers( line + 1, line_end, count, values ) ) {
+        chunk->failed = true;
+        return;
+      }
+      chunk->size++;
+    }
+    line = line_end + 1;
+  }
+}
+
+static void parse_node_lines( void * argument )
+{
+  Chunkptr chunk = (Chunkptr) argument;
+  parse_lines( chunk, 'n', 3 );
+  chunk->max_layer = -1;
+  chunk->min_id = INT_MAX;
+  chunk->max_id = INT_MIN;
+  for ( int i = 0; i < chunk->size && ! chunk->failed; i++ ) {
+    int id = chunk->values[3 * i];
+    int layer = chunk->values[3 * i + 1];
+    if ( layer < 0 ) chunk->failed = true;
+    if ( layer > chunk->max_layer ) chunk->max_layer = layer;
+    if ( id < chunk->min_id ) chunk->min_id = id;
+    if ( id > chunk->max_id ) chunk->max_id = id;
+  }
+}
+
+static void parse_edge_lines( void * argument )
+{
+  parse_lines( (Chunkptr) argument, 'e', 2 );
+}
+
+static void create_nodes( void * argument )
+{
+  Chunkptr chunk = (Chunkptr) argument;
+  for ( int i = 0; i < chunk->size; i++ ) {
+    int * values = chunk->values + 3 * i;
+    master_node_list[ chunk->offset + i ]
+      = createNumberedNode( values[0], values[1], values[2] );
+  }
+}
+
+static int compare_ids( const void * first, const void * second )
+{
+  int first_id = master_node_list[ *(const int *) first ]->id;
+  int second_id = master_node_list[ *(const int *) second ]->id;
+  return first_id < second_id ? -1 : ( first_id > second_id ? 1 : 0 );
+}
+
+/**
+ * Builds the mapping from ids to indices: a direct table if the ids are
+ * dense enough, the indices sorted by id otherwise
+ * @return false if two nodes have the same id
+ */
+static bool map_ids( void )
+{
+  long long range = (long long) max_node_id - min_node_id + 1;
+  if ( range <= 4 * (long long) number_of_nodes + CAPACITY_INCREMENT ) {
+    index_of_id = (int *) malloc( range * sizeof(int) );
+    for ( long long i = 0; i < range; i++ ) index_of_id[i] = -1;
+    for ( int i = 0; i < number_of_nodes; i++ ) {
+      int * entry = &index_of_id[ master_node_list[i]->id - min_node_id ];
+      if ( *entry >= 0 ) return false;
+      *entry = i;
+    }
+    return true;
+  }
+  indices_by_id = (int *) malloc( number_of_nodes * sizeof(int) );
+  for ( int i = 0; i < number_of_nodes; i++ ) indices_by_id[i] = i;
+  qsort( indices_by_id, number_of_nodes, sizeof(int), compare_ids );
+  for ( int i = 1; i < number_of_nodes; i++ )
+    if ( master_node_list[ indices_by_id[i - 1] ]->id
+         == master_node_list[ indices_by_id[i] ]->id )
+      return false;
+  return true;
+}
+
+/**
+ * @return the index of the node with the given id in the master list, -1 if
+ * there is none
+ */
+static int node_index( int id )
+{
+  if ( id < min_node_id || id > max_node_id ) return -1;
+  if ( index_of_id != NULL ) return index_of_id[ id - min_node_id ];
+  int low = 0;
+  int high = number_of_nodes - 1;
+  while ( low <= high ) {
+    int middle = low + (high - low) / 2;
+    int middle_id = master_node_list[ indices_by_id[middle] ]->id;
+    if ( middle_id == id ) return indices_by_id[middle];
+    if ( middle_id < id ) low = middle + 1;
+    else high = middle - 1;
+  }
+  return -1;
+}
+
+/**
+ * Creates the edges of the chunk, replacing the source and target ids by
+ * the indices of the lower and upper endpoints
+ */
+static void create_edges( void * argument )
+{
+  Chunkptr chunk = (Chunkptr) argument;
+  for ( int i = 0; i < chunk->size; i++ ) {
+    int * values = chunk->values + 2 * i;
+    int source = node_index( values[0] );
+    int target = node_index( values[1] );
+    if ( source < 0 || target < 0 ) {
+      chunk->failed = true;
+      return;
+    }
+    Nodeptr source_node = master_node_list[ source ];
+    Nodeptr target_node = master_node_list[ target ];
+    if ( abs( source_node->layer - target_node->layer ) != 1 ) {
+      chunk->failed = true;
+      return;
+    }
+    bool source_is_upper = source_node->layer > target_node->layer;
+    values[0] = source_is_upper ? target : source;
+    values[1] = source_is_upper ? source : target;
+    Edgeptr new_edge = calloc( 1, sizeof(struct edge_struct) );
+    new_edge->up_node = master_node_list[ values[1] ];
+    new_edge->down_node = master_node_list[ values[0] ];
+    new_edge->crossings = 0;
+    new_edge->fixed_epoch = 0;
+    master_edge_list[ chunk->offset + i ] = new_edge;
+  }
+}
+
+struct adjacency_context {
+  int number_of_chunks;
+  Chunkptr chunks;
+};
+
+/**
+ * Builds the edge lists of the nodes with indices in [first, last): counts
+ * their edges in all chunks, allocates the lists and fills them in the
+ * order of the file; each block of nodes needs only its own degree fields,
+ * so no per-chunk counts are kept
+ */
+static void build_edge_lists( int first, int last, void * context )
+{
+  struct adjacency_context * adjacency = context;
+  for ( int chunk = 0; chunk < adjacency->number_of_chunks; chunk++ ) {
+    const int * values = adjacency->chunks[chunk].values;
+    for ( int i = 0; i < adjacency->chunks[chunk].size; i++ ) {
+      int lower = values[2 * i];
+      int upper = values[2 * i + 1];
+      if ( lower >= first && lower < last )
+        master_node_list[lower]->up_degree++;
+      if ( upper >= first && upper < last )
+        master_node_list[upper]->down_degree++;
+    }
+  }
+  for ( int i = first; i < last; i++ ) {
+    Nodeptr node = master_node_list[i];
+    if ( node->up_degree > 0 )
+      node->up_edges = (Edgeptr *) malloc( node->up_degree * sizeof(Edgeptr) );
+    if ( node->down_degree > 0 )
+      node->down_edges
+        = (Edgeptr *) malloc( node->down_degree * sizeof(Edgeptr) );
+    // the degrees count the edges again as they are added
+    node->up_degree = node->down_degree = 0;
+  }
+  for ( int chunk = 0; chunk < adjacency->number_of_chunks; chunk++ ) {
+    Chunkptr edges = &adjacency->chunks[chunk];
+    for ( int i = 0; i < edges->size; i++ ) {
+      int lower = edges->values[2 * i];
+      int upper = edges->values[2 * i + 1];
+      Edgeptr edge = master_edge_list[ edges->offset + i ];
+      if ( lower >= first && lower < last ) {
+        Nodeptr node = master_node_list[lower];
+        node->up_edges[ node->up_degree++ ] = edge;
+      }
+      if ( upper >= first && upper < last ) {
+        Nodeptr node = master_node_list[upper];
+        node->down_edges[ node->down_degree++ ] = edge;
+      }
+    }
+  }
+}
+
+/**
+ * Sets the offset of each chunk to the number of items in the chunks
+ * before it
+ * @return the total number of items, -1 if it does not fit in an int
+ */
+static int prefix_sums( int number_of_chunks, Chunkptr chunks )
+{
+  long long total = 0;
+  for ( int i = 0; i < number_of_chunks; i++ ) {
+    chunks[i].offset = (int) total;
+    total += chunks[i].size;
+    if ( total > INT_MAX ) return -1;
+  }
+  return (int) total;
+}
+
+static void free_chunks( int number_of_chunks, Chunkptr chunks )
+{
+  for ( int i = 0; i < number_of_chunks; i++ ) {
+    free( chunks[i].values );
+  }
+  free( chunks );
+}
+
+/**
+ * Undoes whatever was built before the input turned out to need the
+ * sequential reader
+ */
+static void discard_graph( void )
+{
+  for ( int i = 0; i < number_of_edges; i++ ) free( master_edge_list[i] );
+  for ( int i = 0; i < number_of_nodes; i++ ) {
+    Nodeptr node = master_node_list[i];
+    if ( node == NULL ) continue;
+    free( node->up_edges );
+    free( node->down_edges );
+    free( node->name );
+    free( node );
+  }
+  free( master_node_list );
+  free( master_edge_list );
+  master_node_list = NULL;
+  master_edge_list = NULL;
+  number_of_nodes = number_of_edges = number_of_layers = 0;
+}
+
+/**
+ * Builds the graph from the text of the node and edge sections
+ * @return false if the sequential reader must take over
+ */
+static bool read_body( const char * begin, const char * end,
+                       int number_of_chunks, int declared_nodes,
+                       int declared_edges, int declared_layers )
+{
+  Chunkptr chunks = (Chunkptr) calloc( number_of_chunks,
+                                       sizeof(struct chunk) );
+
+  // the edge section begins at the first line that begins with 'e'
+  split_at_lines( begin, end, number_of_chunks, chunks );
+  run_chunks( number_of_chunks, chunks, find_edge_section );
+  const char * edge_section = end;
+  for ( int i = number_of_chunks - 1; i >= 0; i-- )
+    if ( chunks[i].edge_section != NULL ) edge_section = chunks[i].edge_section;
+
+  split_at_lines( begin, edge_section, number_of_chunks, chunks );
+  run_chunks( number_of_chunks, chunks, parse_node_lines );
+  number_of_nodes = prefix_sums( number_of_chunks, chunks );
+  if ( any_failed( number_of_chunks, chunks ) || number_of_nodes < 0 ) {
+    number_of_nodes = 0;
+    free_chunks( number_of_chunks, chunks );
+    return false;
+  }
+  min_node_id = INT_MAX;
+  max_node_id = INT_MIN;
+  for ( int i = 0; i < number_of_chunks; i++ ) {
+    if ( chunks[i].max_layer + 1 > number_of_layers )
+      number_of_layers = chunks[i].max_layer + 1;
+    if ( chunks[i].min_id < min_node_id ) min_node_id = chunks[i].min_id;
+    if ( chunks[i].max_id > max_node_id ) max_node_id = chunks[i].max_id;
+  }
+  master_node_list = (Nodeptr *) calloc( number_of_nodes, sizeof(Nodeptr) );
+  run_chunks( number_of_chunks, chunks, create_nodes );
+  bool ids_unique = map_ids();
+  free_chunks( number_of_chunks, chunks );
+  if ( ! ids_unique ) return false;
+
+  chunks = (Chunkptr) calloc( number_of_chunks, sizeof(struct chunk) );
+  split_at_lines( edge_section, end, number_of_chunks, chunks );
+  run_chunks( number_of_chunks, chunks, parse_edge_lines );
+  int total_edges = prefix_sums( number_of_chunks, chunks );
+  if ( any_failed( number_of_chunks, chunks ) || total_edges < 0 ) {
+    free_chunks( number_of_chunks, chunks );
+    return false;
+  }
+  master_edge_list = (Edgeptr *) calloc( total_edges, sizeof(Edgeptr) );
+  run_chunks( number_of_chunks, chunks, create_edges );
+  if ( any_failed( number_of_chunks, chunks ) ) {
+    // only the edges that were created are freed
+    for ( int i = 0; i < total_edges; i++ ) free( master_edge_list[i] );
+    free_chunks( number_of_chunks, chunks );
+    return false;
+  }
+  number_of_edges = total_edges;
+
+  struct adjacency_context adjacency = { number_of_chunks, chunks };
+  parallelFor( 0, number_of_nodes,
+               number_of_nodes / numberOfWorkers() + 1,
+               build_edge_lists, &adjacency );
+  free_chunks( number_of_chunks, chunks );
+
+  if ( declared_nodes != number_of_nodes ) {
+    fprintf(stderr, "*** Warning: 't' line says %d nodes, but there are %d nodes\n",
+            declared_nodes, number_of_nodes);
+  }
+  if ( declared_layers != number_of_layers ) {
+    fprintf(stderr, "*** Warning: 't' line says %d layers, but there are %d layers\n",
+            declared_layers, number_of_layers);
+  }
+  if ( declared_edges != number_of_edges ) {
+    fprintf(stderr, "*** Warning: 't' line says %d edges, but there are %d edges\n",
+            declared_edges, number_of_edges);
+  }
+  layers = (Layerptr *) calloc( number_of_layers, sizeof(Layerptr) );
+  return true;
+}
+
+bool readSgfInParallel( FILE * stream, int declared_nodes,
+                        int declared_edges, int declared_layers )
+{
+  if ( numberOfWorkers() < 2 ) return false;
+  int file_descriptor = fileno( stream );
+  struct stat file_status;
+  if ( file_descriptor < 0 || fstat( file_descriptor, &file_status ) != 0
+       || ! S_ISREG( file_status.st_mode ) || file_status.st_size == 0 )
+    return false;
+  long body_offset = ftell( stream );
+  if ( body_offset < 0 || body_offset > file_status.st_size ) return false;
+  size_t length = file_status.st_size;
+  void * text = mmap( NULL, length, PROT_READ, MAP_PRIVATE,
+                      file_descriptor, 0 );
+  if ( text == MAP_FAILED ) return false;
+
+  const char * end = (const char *) text + length;
+  bool success = read_body( (const char *) text + body_offset, end,
+                            numberOfWorkers(), declared_nodes,
+                            declared_edges, declared_layers );
+  munmap( text, length );
+  free( index_of_id );
+  free( indices_by_id );
+  index_of_id = indices_by_id = NULL;
+  if ( ! success ) {
+    discard_graph();
+    fseek( stream, body_offset, SEEK_SET );
+  }
+  return success;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
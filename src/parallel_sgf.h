@@ -0,0 +1,47 @@
+/**
+ * @file parallel_sgf.h
+ * @brief Reading the node and edge sections of an sgf file in parallel.
+ *
+ * The file is mapped into memory and the part after the 't' line is split
+ * at line boundaries into one chunk per thread, first to find where the
+ * edge section begins and then separately for the node and edge sections.
+ * The chunks are parsed concurrently into per-chunk buffers; prefix sums
+ * over the chunks give each chunk its offset in the master lists. The
+ * adjacency lists are built in parallel over blocks of nodes, one per
+ * thread: each block scans the edges of all chunks, in order, and handles
+ * only those of its own nodes, so that the edges end up in file order and
+ * no memory beyond the node fields is needed.
+ *
+ * The resulting graph is identical to that built by the sequential reader,
+ * including the order of the master lists and of the edges of each node.
+ * Anything the sequential reader would reject (or read differently) causes
+ * the parallel reader to undo its work and leave the stream where it was,
+ * so that the sequential reader can handle it and report the error.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef PARALLEL_SGF_H
+#define PARALLEL_SGF_H
+
+#include<stdio.h>
+#include<stdbool.h>
+
+/**
+ * Reads the nodes and edges of an sgf file whose comments and 't' line have
+ * already been read from the stream. On success allocates and fills the
+ * master lists and the (empty) layers array and prints the same warnings
+ * as the sequential reader about counts that differ from the 't' line.
+ * @param declared_nodes, declared_edges, declared_layers the numbers on the
+ * 't' line
+ * @return false, with nothing allocated and the stream position unchanged,
+ * if there is only one thread, the stream is not a regular file that can be
+ * mapped, or the input is not well formed
+ */
+bool readSgfInParallel( FILE * stream, int declared_nodes,
+                        int declared_edges, int declared_layers );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -0,0 +1,384 @@
+/**
+ * @file parallel_sift.c
+ * @brief Implementation of parallel candidate evaluation for sifting a node
+ * on a very large layer.
+ *
+ * Let x be the node being sifted and y another node on its layer. For each
+ * edge e incident on x let delta(e,y) = cr_e(x,y) - cr_e(y,x), where
+ * cr_e(a,b) is the number of crossings of e with edges of y when a and b are
+ * in the given order; delta(e,y) is the change in the crossings of e when x
+ * moves from the right of y to its left. Similarly, for an edge f of y,
+ * delta(f,x) = cr_f(x,y) - cr_f(y,x). Since edges of the same node never
+ * cross each other, these are computed by merging the edge arrays of x and
+ * y, each sorted by position of the other endpoint, with no side effects.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#include"graph.h"
+#include"defs.h"
+#include"constants.h"
+#include"sorting.h"
+#include"parallel_sift.h"
+#include"tasks.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdbool.h>
+#include<limits.h>
+
+/**
+ * Information about the node being sifted, shared (read-only) by all
+ * threads; edges are indexed with the upward edges first, then the
+ * downward ones, each sorted by position of the other endpoint
+ */
+static Nodeptr sifted_node;
+static int up_degree;
+static int down_degree;
+static int * other_end_position;
+static int * base_crossings;
+
+/**
+ * Work assigned to one thread: the positions first, ..., last - 1 on the
+ * layer; also holds the results of the thread's computation
+ */
+typedef struct sift_block {
+  int first;
+  int last;
+  /** buffer for delta(e,y) for all edges e of the sifted node */
+  int * delta;
+
+  /** sifting for total crossings: sum of diff over the block */
+  int diff_sum;
+  /** min prefix sum within the block and where it occurs */
+  int min_prefix_sum;
+  int min_position;
+  int max_distance;
+
+  /**
+   * mce: per-edge change in crossings caused by all moves across nodes of
+   * the block during the left (right) sweep, and the per-edge change at
+   * the start of the block during the second phase
+   */
+  int * left_change;
+  int * right_change;
+  int * left_offset;
+  int * right_offset;
+  /** mce: output array, indexed by position */
+  int * value;
+  /** mce: max crossings of an edge of y after the move, indexed by position */
+  int * other_node_max;
+} * SiftBlockptr;
+
+bool use_parallel_sift( int layer_size )
+{
+  return numberOfWorkers() > 1 && layer_size >= PARALLEL_SIFT_THRESHOLD;
+}
+
+/**
+ * Computes delta(e,y) for the edges e of the sifted node in one channel and
+ * delta(f,x) for the edges f of y in that channel.
+ *
+ * @param x_position sorted positions of other endpoints of the sifted node's
+ * edges in this channel
+ * @param x_degree number of such edges
+ * @param y_edges edges of y in this channel, sorted by position of other
+ * endpoint
+ * @param y_degree number of edges of y in this channel
+ * @param upward true if the other endpoints are on the layer above
+ * @param delta if not NULL, delta(e,y) is stored here for each edge e
+ * @param sign +1 if y is to the left of x before the move, -1 otherwise
+ * @param y_max updated to the max, over edges f of y, of the crossings of f
+ * after the move, i.e., f->crossings + sign * delta(f,x)
+ * @return the sum of delta(e,y) over edges e of the sifted node
+ */
+static int channel_delta( const int * x_position, int x_degree,
+                          Edgeptr * y_edges, int y_degree, bool upward,
+                          int * delta, int sign, int * y_max )
+{
+  int sum = 0;
+  int less = 0;                 /* edges of y with position < current */
+  int less_or_equal = 0;        /* edges of y with position <= current */
+  for ( int j = 0; j < x_degree; j++ ) {
+    int key = x_position[j];
+    while ( less < y_degree
+            && (upward ? y_edges[less]->up_node->position
+                : y_edges[less]->down_node->position) < key )
+      less++;
+    if ( less_or_equal < less ) less_or_equal = less;
+    while ( less_or_equal < y_degree
+            && (upward ? y_edges[less_or_equal]->up_node->position
+                : y_edges[less_or_equal]->down_node->position) <= key )
+      less_or_equal++;
+    int edge_delta = less - (y_degree - less_or_equal);
+    if ( delta != NULL ) delta[j] = edge_delta;
+    sum += edge_delta;
+  }
+  if ( y_max == NULL ) return sum;
+
+  less = less_or_equal = 0;
+  for ( int k = 0; k < y_degree; k++ ) {
+    Edgeptr edge = y_edges[k];
+    int key = upward ? edge->up_node->position : edge->down_node->position;
+    while ( less < x_degree && x_position[less] < key ) less++;
+    if ( less_or_equal < less ) less_or_equal = less;
+    while ( less_or_equal < x_degree && x_position[less_or_equal] <= key )
+      less_or_equal++;
+    int edge_delta = (x_degree - less_or_equal) - less;
+    int crossings_after_move = edge->crossings + sign * edge_delta;
+    if ( crossings_after_move > *y_max ) *y_max = crossings_after_move;
+  }
+  return sum;
+}
+
+/**
+ * Computes delta(e,y) for all edges e of the sifted node, sorting the edges
+ * of y as a side effect (the sequential computation does the same).
+ * @param y_max if not NULL, see channel_delta(); initialized here
+ * @return the sum of delta(e,y), i.e., cr(x,y) - cr(y,x)
+ */
+static int node_delta( Nodeptr y, int * delta, int sign, int * y_max )
+{
+  if ( y_max != NULL ) *y_max = 0;
+  sortByUpNodePosition( y->up_edges, y->up_degree );
+  sortByDownNodePosition( y->down_edges, y->down_degree );
+  int sum = channel_delta( other_end_position, up_degree,
+                           y->up_edges, y->up_degree, true,
+                           delta, sign, y_max );
+  sum += channel_delta( other_end_position + up_degree, down_degree,
+                        y->down_edges, y->down_degree, false,
+                        delta == NULL ? NULL : delta + up_degree,
+                        sign, y_max );
+  return sum;
+}
+
+/**
+ * Runs the worker on each block as a separate task and waits for all of them
+ */
+static void run_blocks( TaskFunction worker,
+                        struct sift_block * blocks, int number_of_blocks )
+{
+  struct task_group group;
+  beginTasks( &group );
+  for ( int b = 0; b < number_of_blocks; b++ )
+    forkTask( &group, worker, &blocks[b] );
+  joinTasks( &group );
+}
+
+/**
+ * Records the sifted node's edges, sorted, and splits the layer into
+ * blocks, one per thread
+ * @return the number of blocks
+ */
+static int prepare_blocks( Nodeptr node, struct sift_block ** blocks_ptr )
+{
+  sifted_node = node;
+  up_degree = node->layer < number_of_layers - 1 ? node->up_degree : 0;
+  down_degree = node->layer > 0 ? node->down_degree : 0;
+  sortByUpNodePosition( node->up_edges, node->up_degree );
+  sortByDownNodePosition( node->down_edges, node->down_degree );
+  int degree = up_degree + down_degree;
+  other_end_position = (int *) calloc( degree + 1, sizeof(int) );
+  base_crossings = (int *) calloc( degree + 1, sizeof(int) );
+  for ( int j = 0; j < up_degree; j++ ) {
+    other_end_position[j] = node->up_edges[j]->up_node->position;
+    base_crossings[j] = node->up_edges[j]->crossings;
+  }
+  for ( int j = 0; j < down_degree; j++ ) {
+    other_end_position[up_degree + j]
+      = node->down_edges[j]->down_node->position;
+    base_crossings[up_degree + j] = node->down_edges[j]->crossings;
+  }
+
+  int layer_size = layers[ node->layer ]->number_of_nodes;
+  int number_of_blocks = numberOfWorkers();
+  if ( number_of_blocks > layer_size ) number_of_blocks = layer_size;
+  struct sift_block * blocks
+    = (struct sift_block *) calloc( number_of_blocks,
+                                    sizeof(struct sift_block) );
+  for ( int b = 0; b < number_of_blocks; b++ ) {
+    blocks[b].first = (int) ((long) layer_size * b / number_of_blocks);
+    blocks[b].last = (int) ((long) layer_size * (b + 1) / number_of_blocks);
+    blocks[b].delta = (int *) calloc( degree + 1, sizeof(int) );
+  }
+  *blocks_ptr = blocks;
+  return number_of_blocks;
+}
+
+static void free_blocks( struct sift_block * blocks, int number_of_blocks )
+{
+  for ( int b = 0; b < number_of_blocks; b++ ) {
+    free( blocks[b].delta );
+    free( blocks[b].left_change );
+    free( blocks[b].right_change );
+    free( blocks[b].left_offset );
+    free( blocks[b].right_offset );
+  }
+  free( blocks );
+  free( other_end_position );
+  free( base_crossings );
+  other_end_position = base_crossings = NULL;
+}
+
+/**
+ * Computes the prefix sums of diff(x,y_i) = cr(y_i,x) - cr(x,y_i) over the
+ * block and the position of the minimum, breaking ties the same way as
+ * sift(): larger distance from the node's position first, then earlier
+ * position.
+ */
+static void sift_block_worker( void * arg )
+{
+  SiftBlockptr block = (SiftBlockptr) arg;
+  Nodeptr * nodes = layers[ sifted_node->layer ]->nodes;
+  int prefix_sum = 0;
+  block->min_prefix_sum = INT_MAX;
+  block->min_position = -1;
+  block->max_distance = 0;
+  for ( int i = block->first; i < block->last; i++ ) {
+    if ( nodes[i] != sifted_node )
+      prefix_sum -= node_delta( nodes[i], NULL, 0, NULL );
+    int distance = abs( i - sifted_node->position );
+    if ( prefix_sum < block->min_prefix_sum
+         || ( prefix_sum == block->min_prefix_sum
+              && distance > block->max_distance ) ) {
+      block->min_prefix_sum = prefix_sum;
+      block->min_position = i;
+      block->max_distance = distance;
+    }
+  }
+  block->diff_sum = prefix_sum;
+}
+
+int parallel_sift_position( Nodeptr node )
+{
+  struct sift_block * blocks;
+  int number_of_blocks = prepare_blocks( node, &blocks );
+  run_blocks( sift_block_worker, blocks, number_of_blocks );
+
+  // combine the blocks in order; the minimum of each block is shifted by
+  // the sum of the diffs in all earlier blocks
+  int offset = 0;
+  int min_prefix_sum = 0;
+  int min_position = -1;
+  int max_distance = 0;
+  for ( int b = 0; b < number_of_blocks; b++ ) {
+    int block_min = offset + blocks[b].min_prefix_sum;
+    if ( block_min < min_prefix_sum
+         || ( block_min == min_prefix_sum
+              && blocks[b].max_distance > max_distance ) ) {
+      min_prefix_sum = block_min;
+      min_position = blocks[b].min_position;
+      max_distance = blocks[b].max_distance;
+    }
+    offset += blocks[b].diff_sum;
+  }
+  free_blocks( blocks, number_of_blocks );
+  return min_position;
+}
+
+/**
+ * First phase for mce: computes, for each position in the block, the max
+ * crossings of an edge of the node there after the move, and the total
+ * per-edge change for the sifted node's edges over the block, separately
+ * for the left and the right sweep
+ */
+static void edge_change_worker( void * arg )
+{
+  SiftBlockptr block = (SiftBlockptr) arg;
+  Nodeptr * nodes = layers[ sifted_node->layer ]->nodes;
+  int position = sifted_node->position;
+  int degree = up_degree + down_degree;
+  for ( int i = block->first; i < block->last; i++ ) {
+    if ( i == position ) continue;
+    int sign = i < position ? +1 : -1;
+    node_delta( nodes[i], block->delta, sign, &block->other_node_max[i] );
+    int * change = i < position ? block->left_change : block->right_change;
+    for ( int j = 0; j < degree; j++ )
+      change[j] += sign * block->delta[j];
+  }
+}
+
+/**
+ * @return max crossings among edges of the sifted node when the changes
+ * in crossings of its edges are given by change
+ */
+static int max_edge_crossings( const int * change )
+{
+  int max_crossings = 0;
+  for ( int j = 0; j < up_degree + down_degree; j++ )
+    if ( base_crossings[j] + change[j] > max_crossings )
+      max_crossings = base_crossings[j] + change[j];
+  return max_crossings;
+}
+
+/**
+ * Second phase for mce: walks the left part of the block right to left and
+ * the right part left to right, the same direction as the sweeps, starting
+ * from the offsets computed by the scan over the blocks
+ */
+static void edge_value_worker( void * arg )
+{
+  SiftBlockptr block = (SiftBlockptr) arg;
+  Nodeptr * nodes = layers[ sifted_node->layer ]->nodes;
+  int position = sifted_node->position;
+  int degree = up_degree + down_degree;
+
+  int * change = block->left_offset;
+  int left_end = block->last < position ? block->last : position;
+  for ( int i = left_end - 1; i >= block->first; i-- ) {
+    node_delta( nodes[i], block->delta, +1, NULL );
+    for ( int j = 0; j < degree; j++ ) change[j] += block->delta[j];
+    int value = max_edge_crossings( change );
+    block->value[i] = value > block->other_node_max[i]
+      ? value : block->other_node_max[i];
+  }
+
+  change = block->right_offset;
+  int right_start = block->first > position ? block->first : position + 1;
+  for ( int i = right_start; i < block->last; i++ ) {
+    node_delta( nodes[i], block->delta, -1, NULL );
+    for ( int j = 0; j < degree; j++ ) change[j] -= block->delta[j];
+    int value = max_edge_crossings( change );
+    block->value[i] = value > block->other_node_max[i]
+      ? value : block->other_node_max[i];
+  }
+}
+
+int * parallel_edge_crossings_after_moves( Nodeptr node )
+{
+  struct sift_block * blocks;
+  int number_of_blocks = prepare_blocks( node, &blocks );
+  int layer_size = layers[ node->layer ]->number_of_nodes;
+  int degree = up_degree + down_degree;
+  int * value = (int *) calloc( layer_size, sizeof(int) );
+  int * other_node_max = (int *) calloc( layer_size, sizeof(int) );
+  for ( int b = 0; b < number_of_blocks; b++ ) {
+    blocks[b].value = value;
+    blocks[b].other_node_max = other_node_max;
+    blocks[b].left_change = (int *) calloc( degree + 1, sizeof(int) );
+    blocks[b].right_change = (int *) calloc( degree + 1, sizeof(int) );
+    blocks[b].left_offset = (int *) calloc( degree + 1, sizeof(int) );
+    blocks[b].right_offset = (int *) calloc( degree + 1, sizeof(int) );
+  }
+  run_blocks( edge_change_worker, blocks, number_of_blocks );
+
+  // exclusive scans: the left sweep reaches a block after all blocks to its
+  // right, the right sweep after all blocks to its left
+  for ( int b = number_of_blocks - 2; b >= 0; b-- )
+    for ( int j = 0; j < degree; j++ )
+      blocks[b].left_offset[j]
+        = blocks[b + 1].left_offset[j] + blocks[b + 1].left_change[j];
+  for ( int b = 1; b < number_of_blocks; b++ )
+    for ( int j = 0; j < degree; j++ )
+      blocks[b].right_offset[j]
+        = blocks[b - 1].right_offset[j] + blocks[b - 1].right_change[j];
+
+  run_blocks( edge_value_worker, blocks, number_of_blocks );
+
+  free( other_node_max );
+  free_blocks( blocks, number_of_blocks );
+  return value;
+}
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
@@ -0,0 +1,61 @@
+/**
+ * @file parallel_sift.h
+ * @brief Parallel evaluation of candidate positions when a single node is
+ * sifted on a very large layer.
+ *
+ * The positions on the layer are split into one contiguous block per
+ * thread. For sifting based on total crossings each thread computes the
+ * prefix sums of diff(x,y) for its block along with the best position in
+ * the block; the blocks are then combined in order, using the same
+ * tie-breaking as sift(). For mce each thread computes, for its block, the
+ * per-edge changes in crossings of the sifted node's edges; an exclusive scan
+ * over the blocks gives each thread the state at the start of its block, so
+ * that the max edge crossings value of every position can be computed
+ * independently.
+ *
+ * The crossing counts on edges and nodes are not touched: the counts are
+ * computed without side effects and the caller recomputes crossings after
+ * the node is repositioned. Like the sequential version, however, the edge
+ * arrays of nodes on the layer are left sorted by the positions of their
+ * other endpoints. The position chosen is the one sift() or
+ * sift_node_for_edge_crossings() would choose, so results do not depend on
+ * the number of threads.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef PARALLEL_SIFT_H
+#define PARALLEL_SIFT_H
+
+#include<stdbool.h>
+
+#include"graph.h"
+
+/**
+ * @return true if sifting on a layer with the given number of nodes should
+ * evaluate candidate positions in parallel, i.e., more than one thread was
+ * requested and the layer has at least PARALLEL_SIFT_THRESHOLD nodes
+ */
+bool use_parallel_sift( int layer_size );
+
+/**
+ * @return the position after which the node should be placed to minimize
+ * the total number of crossings, -1 if it belongs before all other nodes;
+ * this is the min_position computed by sift()
+ */
+int parallel_sift_position( Nodeptr node );
+
+/**
+ * @return an array whose i-th entry is the maximum number of crossings
+ * among edges incident on the node and the node in position i, after the
+ * node has been moved from its current position to the far side of position
+ * i, i.e., the value of edge_crossings_after_swap() at step i of the left or
+ * right sweep in sift_node_for_edge_crossings(); the entry for the node's
+ * own position is undefined; the caller must free the array
+ */
+int * parallel_edge_crossings_after_moves( Nodeptr node );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -68,7 +68,8 @@ static Nodeptr create_node( int node_number )
   new_node->up_degree = new_node->down_degree = 0;
   new_node->up_edges = new_node->down_edges = NULL;
   new_node->up_crossings = new_node->down_crossings = 0;
-  new_node->marked = new_node->fixed = false;
+  new_node->marked = false;
+  new_node->fixed_epoch = 0;
   new_node->preorder_number = -1;
   return new_node;
 }
@@ -93,7 +94,8 @@ static void init_layers( int num_layers )
       layers[i] = calloc( 1, sizeof( struct layer_struct ) );
       layers[i]->number_of_nodes = 0;
       layers[i]->nodes = NULL;
-      layers[i]->fixed = false;
+      layers[i]->fixed_epoch = 0;
+      layers[i]->pinned = false;
     }
 }
 
@@ -172,7 +174,7 @@ static void add_edge( Nodeptr upper_node, Nodeptr lower_node )
   Edgeptr new_edge = (Edgeptr) calloc( 1, sizeof(struct edge_struct) );
   new_edge->up_node = upper_node;
   new_edge->down_node = lower_node;
-  new_edge->fixed = false;
+  new_edge->fixed_epoch = 0;
 
   // add new edge to master edge list, making room if necessary
   if ( number_of_edges % CAPACITY_INCREMENT == 0 )
@@ -344,4 +346,4 @@ int main( int argc, char * argv[] )
 }
 #endif
 
-/*  [Last modified: 2021 03 03 at 16:23:07 GMT] */
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
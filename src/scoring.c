@@ -0,0 +1,378 @@
+/**
+ * @file scoring.c
+ * @brief Implementation of the scoring of candidate orderings.
+ *
+ * A candidate is held in an order_struct, as used by save_order() and
+ * restore_order(): it starts as a copy of the graph's order (save_order())
+ * and the layers given in the input are then overwritten. Instead of
+ * restoring it into the graph, a scoring task restores it into its own
+ * position arrays, indexed by the position each node has in the graph; the
+ * crossings of each channel are then counted with
+ * count_inversions_by_position(), which also gives the crossings of each
+ * edge (needed for the bottleneck).
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#include"graph.h"
+#include"defs.h"
+#include"order.h"
+#include"hash.h"
+#include"ord.h"
+#include"tasks.h"
+#include"crossing_utilities.h"
+#include"scoring.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<string.h>
+#include<ctype.h>
+#include<math.h>
+
+typedef struct candidate_struct {
+  struct order_struct order;
+  bool valid;
+  int crossings;
+  int bottleneck_crossings;
+  double stretch;
+  double bottleneck_stretch;
+} * Candidateptr;
+
+/**
+ * Scratch space of a scoring task
+ */
+typedef struct scratch_struct {
+  /** new position of each node, at layer_offset[layer] + node->position */
+  int * position;
+  /** upper and lower position and crossings of the edges of a channel */
+  int * upper_position;
+  int * lower_position;
+  int * edge_crossings;
+  /** scratch space for count_inversions_by_position() */
+  int * tree;
+} * Scratchptr;
+
+/** index of the first node of each layer in the position arrays */
+static int * layer_offset = NULL;
+static int max_layer_size = 0;
+static int max_channel_edges = 0;
+
+/** input state */
+typedef enum { ORD_FORMAT, PERMUTATION_FORMAT } CandidateFormat;
+static CandidateFormat format;
+/** layer already read for the next candidate (-1 if none) */
+static int pending_layer = -1;
+static bool end_of_input = false;
+/** stamps to recognize layers already given and nodes already placed */
+static int * layer_stamp = NULL;
+static int * node_stamp = NULL;
+static int stamp = 0;
+static int candidate_number = 0;
+
+static void compute_sizes( void )
+{
+  layer_offset = (int *) calloc( number_of_layers + 1, sizeof(int) );
+  max_layer_size = 0;
+  max_channel_edges = 0;
+  for ( int layer = 0; layer < number_of_layers; layer++ ) {
+    int layer_size = layers[layer]->number_of_nodes;
+    layer_offset[layer + 1] = layer_offset[layer] + layer_size;
+    if ( layer_size > max_layer_size ) max_layer_size = layer_size;
+    int channel_edges = 0;
+    for ( int position = 0; position < layer_size; position++ )
+      channel_edges += layers[layer]->nodes[position]->down_degree;
+    if ( channel_edges > max_channel_edges )
+      max_channel_edges = channel_edges;
+  }
+}
+
+/**
+ * Skips white space and comments
+ * @return the next character (not consumed), EOF if none
+ */
+static int peek_past_comments( FILE * in )
+{
+  int ch;
+  while ( (ch = getc( in )) != EOF ) {
+    if ( ch == '#' ) {
+      while ( (ch = getc( in )) != EOF && ch != '\n' )
+        ;
+      if ( ch == EOF ) break;
+    }
+    else if ( ! isspace( ch ) ) {
+      ungetc( ch, in );
+      break;
+    }
+  }
+  return ch;
+}
+
+/**
+ * Reads an int from the rest of the current line of a permutation
+ * @return false at the end of the line (or of the input or at a comment);
+ * the newline, if any, is consumed
+ */
+static bool next_int_on_line( FILE * in, int * value )
+{
+  int ch;
+  while ( (ch = getc( in )) != EOF && ch != '\n' && isspace( ch ) )
+    ;
+  if ( ch == '#' )
+    while ( (ch = getc( in )) != EOF && ch != '\n' )
+      ;
+  if ( ch == EOF || ch == '\n' ) return false;
+  ungetc( ch, in );
+  if ( fscanf( in, "%d", value ) != 1 ) {
+    fprintf( stderr, "*** FATAL ERROR: bad number in candidate %d\n",
+             candidate_number );
+    exit( EXIT_FAILURE );
+  }
+  return true;
+}
+
+/**
+ * Reads the number of the next layer
+ * @return false at the end of the input
+ */
+static bool next_candidate_layer( FILE * in, int * layer )
+{
+  if ( format == ORD_FORMAT ) return nextLayer( in, layer );
+  int ch = peek_past_comments( in );
+  if ( ch == EOF ) return false;
+  getc( in );
+  if ( ch != 'p' || fscanf( in, "%d", layer ) != 1 ) {
+    fprintf( stderr, "*** FATAL ERROR: expected 'p LAYER' in candidate %d\n",
+             candidate_number );
+    exit( EXIT_FAILURE );
+  }
+  return true;
+}
+
+static void invalidate( Candidateptr candidate, const char * reason,
+                        int layer )
+{
+  if ( candidate->valid )
+    fprintf( stderr, "*** Warning: candidate %d, layer %d: %s\n",
+             candidate_number, layer, reason );
+  candidate->valid = false;
+}
+
+/**
+ * Places a node in the given position of a layer of the candidate, unless
+ * the layer is invalid in some way
+ */
+static void place_node( Candidateptr candidate, int layer, int position,
+                        Nodeptr node )
+{
+  if ( layer < 0 || layer >= number_of_layers ) {
+    invalidate( candidate, "no such layer", layer );
+    return;
+  }
+  if ( node == NULL || node->layer != layer ) {
+    invalidate( candidate, "node is not on this layer", layer );
+    return;
+  }
+  if ( position >= layers[layer]->number_of_nodes ) {
+    invalidate( candidate, "too many nodes", layer );
+    return;
+  }
+  int * node_stamp_ptr = node_stamp + layer_offset[layer] + node->position;
+  if ( * node_stamp_ptr == stamp ) {
+    invalidate( candidate, "node appears twice", layer );
+    return;
+  }
+  * node_stamp_ptr = stamp;
+  candidate->order.node_ptr_on_layer[layer][position] = node;
+}
+
+/**
+ * Reads the nodes of a layer into the candidate
+ */
+static void read_layer( FILE * in, Candidateptr candidate, int layer )
+{
+  stamp++;
+  int position = 0;
+  if ( format == ORD_FORMAT ) {
+    char name[MAX_NAME_LENGTH];
+    while ( nextNode( in, name ) )
+      place_node( candidate, layer, position++, getFromHashTable( name ) );
+  }
+  else {
+    int index;
+    while ( next_int_on_line( in, & index ) ) {
+      Nodeptr node = NULL;
+      if ( layer >= 0 && layer < number_of_layers
+           && index >= 0 && index < layers[layer]->number_of_nodes )
+        node = layers[layer]->nodes[index];
+      place_node( candidate, layer, position++, node );
+    }
+  }
+  if ( layer >= 0 && layer < number_of_layers
+       && position < layers[layer]->number_of_nodes )
+    invalidate( candidate, "too few nodes", layer );
+}
+
+/**
+ * Reads the next candidate
+ * @return false if there are no more
+ */
+static bool read_candidate( FILE * in, Candidateptr candidate )
+{
+  if ( end_of_input ) return false;
+  int layer = pending_layer;
+  pending_layer = -1;
+  if ( layer < 0 && ! next_candidate_layer( in, & layer ) ) {
+    end_of_input = true;
+    return false;
+  }
+  candidate_number++;
+  save_order( & candidate->order );
+  candidate->valid = true;
+  do {
+    if ( layer >= 0 && layer < number_of_layers ) {
+      if ( layer_stamp[layer] == candidate_number ) {
+        pending_layer = layer;
+        return true;
+      }
+      layer_stamp[layer] = candidate_number;
+    }
+    read_layer( in, candidate, layer );
+  } while ( next_candidate_layer( in, & layer ) );
+  end_of_input = true;
+  return true;
+}
+
+static double scale( int layer_size )
+{
+  return layer_size > 1 ? layer_size - 1.0 : 2.0;
+}
+
+/**
+ * Computes all objectives for the candidate; same definitions as
+ * numberOfCrossings(), maxEdgeCrossings(), totalStretch() and
+ * maxEdgeStretch()
+ */
+static void score_candidate( Candidateptr candidate, Scratchptr scratch )
+{
+  Orderptr order = & candidate->order;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    for ( int j = 0; j < order->num_nodes_on_layer[layer]; j++ ) {
+      Nodeptr node = order->node_ptr_on_layer[layer][j];
+      scratch->position[ layer_offset[layer] + node->position ] = j;
+    }
+
+  candidate->crossings = 0;
+  candidate->bottleneck_crossings = 0;
+  candidate->stretch = 0.0;
+  candidate->bottleneck_stretch = 0.0;
+  for ( int upper_layer = 1; upper_layer < number_of_layers; upper_layer++ ) {
+    int lower_layer = upper_layer - 1;
+    int upper_size = order->num_nodes_on_layer[upper_layer];
+    int lower_size = order->num_nodes_on_layer[lower_layer];
+    int * lower_positions = scratch->position + layer_offset[lower_layer];
+    int edges = 0;
+    for ( int j = 0; j < upper_size; j++ ) {
+      Nodeptr node = order->node_ptr_on_layer[upper_layer][j];
+      for ( int k = 0; k < node->down_degree; k++ ) {
+        scratch->upper_position[edges] = j;
+        scratch->lower_position[edges]
+          = lower_positions[ node->down_edges[k]->down_node->position ];
+        edges++;
+      }
+    }
+
+    candidate->crossings
+      += count_inversions_by_position( scratch->upper_position,
+                                       scratch->lower_position,
+                                       edges, lower_size,
+                                       scratch->edge_crossings,
+                                       scratch->tree );
+
+    double upper_scale = scale( upper_size );
+    double lower_scale = scale( lower_size );
+    for ( int e = 0; e < edges; e++ ) {
+      if ( scratch->edge_crossings[e] > candidate->bottleneck_crossings )
+        candidate->bottleneck_crossings = scratch->edge_crossings[e];
+      double edge_stretch
+        = fabs( scratch->lower_position[e] / lower_scale
+                - scratch->upper_position[e] / upper_scale );
+      candidate->stretch += edge_stretch;
+      if ( edge_stretch > candidate->bottleneck_stretch )
+        candidate->bottleneck_stretch = edge_stretch;
+    }
+  }
+}
+
+/**
+ * Scores candidates first, ..., last - 1 of a batch
+ */
+static void score_candidates( int first, int last, void * batch_ptr )
+{
+  Candidateptr batch = (Candidateptr) batch_ptr;
+  struct scratch_struct scratch;
+  scratch.position = (int *) calloc( number_of_nodes + 1, sizeof(int) );
+  scratch.upper_position = (int *) calloc( max_channel_edges + 1, sizeof(int) );
+  scratch.lower_position = (int *) calloc( max_channel_edges + 1, sizeof(int) );
+  scratch.edge_crossings = (int *) calloc( max_channel_edges + 1, sizeof(int) );
+  scratch.tree = (int *) calloc( max_layer_size + 1, sizeof(int) );
+  for ( int i = first; i < last; i++ )
+    if ( batch[i].valid ) score_candidate( batch + i, & scratch );
+  free( scratch.position );
+  free( scratch.upper_position );
+  free( scratch.lower_position );
+  free( scratch.edge_crossings );
+  free( scratch.tree );
+}
+
+void scoreCandidates( FILE * in )
+{
+  compute_sizes();
+  layer_stamp = (int *) calloc( number_of_layers, sizeof(int) );
+  node_stamp = (int *) calloc( number_of_nodes + 1, sizeof(int) );
+
+  int first_char = peek_past_comments( in );
+  format = isdigit( first_char ) ? ORD_FORMAT : PERMUTATION_FORMAT;
+  if ( format == ORD_FORMAT ) {
+    initHashTable( number_of_nodes );
+    for ( int i = 0; i < number_of_nodes; i++ )
+      insertInHashTable( master_node_list[i]->name, master_node_list[i] );
+  }
+
+  struct candidate_struct batch[ SCORING_BATCH_SIZE ];
+  for ( int i = 0; i < SCORING_BATCH_SIZE; i++ )
+    init_order( & batch[i].order );
+
+  printf( "Candidate,Crossings,BottleneckCrossings,Stretch,BottleneckStretch\n" );
+  int first_in_batch = 1;
+  int batch_size;
+  do {
+    batch_size = 0;
+    while ( batch_size < SCORING_BATCH_SIZE
+            && read_candidate( in, batch + batch_size ) )
+      batch_size++;
+    parallelFor( 0, batch_size, 1, score_candidates, batch );
+    for ( int i = 0; i < batch_size; i++ ) {
+      Candidateptr candidate = batch + i;
+      if ( candidate->valid )
+        printf( "%d,%d,%d,%f,%f\n", first_in_batch + i,
+                candidate->crossings, candidate->bottleneck_crossings,
+                candidate->stretch, candidate->bottleneck_stretch );
+      else
+        printf( "%d,invalid\n", first_in_batch + i );
+    }
+    fflush( stdout );
+    first_in_batch += batch_size;
+  } while ( batch_size == SCORING_BATCH_SIZE );
+
+  fprintf( stderr, "--- scored %d candidates\n", first_in_batch - 1 );
+
+  for ( int i = 0; i < SCORING_BATCH_SIZE; i++ )
+    cleanup_order( & batch[i].order );
+  if ( format == ORD_FORMAT ) removeHashTable();
+  free( layer_offset );
+  free( layer_stamp );
+  free( node_stamp );
+}
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
@@ -0,0 +1,56 @@
+/**
+ * @file scoring.h
+ * @brief Scoring of many candidate orderings of a graph that is read only
+ * once (-S option).
+ *
+ * The candidates are read from a file or standard input in one of two
+ * formats, recognized by the first character that is not white space or
+ * part of a comment (comments begin with # and end with newline):
+ *
+ * - ord format: a sequence of layers as in an ord file,
+ * <pre>
+ *     0 { node_0_0 node_0_1 ... }
+ *     1 { ... }
+ * </pre>
+ * - permutation format: one line per layer,
+ * <pre>
+ *     p LAYER i_0 i_1 ... i_k
+ * </pre>
+ * where i_j is the position, in the order of the graph as it was read, of
+ * the node that is to be at position j.
+ *
+ * A candidate ends when a layer appears that it already has, or at the end
+ * of the input. Layers missing from a candidate keep the order of the graph
+ * as it was read.
+ *
+ * For each candidate one line is written on standard output:
+ * <pre>
+ *    number,crossings,bottleneck_crossings,stretch,bottleneck_stretch
+ * </pre>
+ * or number,invalid if a layer of the candidate is not a permutation of the
+ * nodes on that layer (a warning on standard error gives the reason).
+ *
+ * Candidates are read in batches of SCORING_BATCH_SIZE and the candidates
+ * of a batch are scored in parallel; each task has its own position arrays
+ * and never changes the graph, so the output does not depend on the number
+ * of threads.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef SCORING_H
+#define SCORING_H
+
+#include<stdio.h>
+
+/**
+ * Scores all candidates on the stream against the current graph, whose
+ * order is the reference for the permutation format; the graph is not
+ * changed
+ */
+void scoreCandidates( FILE * candidate_stream );
+
+#endif
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
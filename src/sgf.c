@@ -14,6 +14,7 @@
 #include "graph.h"
 #include "graph_io.h"
 #include "hash.h"
+#include "parallel_sgf.h"
 
 /**
  * stores a long string of comments separated by '\n's
@@ -258,6 +259,10 @@ static void insert_nodes_in_hash_table(void) {
  *      - add it to the arrays for up and down edges of endpoints
  *  7. Deallocate hash table
  *
+ * With more than one thread, steps 2-3 and 6 are done by
+ * readSgfInParallel() instead when the input is a regular file; see
+ * parallel_sgf.h
+ *
  * Notes
  *  - use FILE * instead of file name; this allows use of pipes to run
  * multiple heuristics in sequence
@@ -267,6 +272,12 @@ static void insert_nodes_in_hash_table(void) {
  */
 void readSgf(FILE * sgf_stream) {
     initSgf(sgf_stream);
+    if ( readSgfInParallel(sgf_stream, num_nodes, num_edges, num_layers) ) {
+        allocateLayers();
+        addNodesToLayers();
+        number_of_isolated_nodes = countIsolatedNodes();
+        return;
+    }
     master_node_list = (Nodeptr *) calloc(num_nodes, sizeof(Nodeptr));
     master_edge_list = (Edgeptr *) calloc(num_edges, sizeof(Edgeptr));
     layers = (Layerptr *) calloc(num_layers, sizeof(Layerptr));
@@ -316,3 +327,5 @@ void writeSgf(FILE * output_stream) {
     writeSgfNodes(output_stream);
     writeSgfEdges(output_stream);
 }
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
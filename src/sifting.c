@@ -17,6 +17,8 @@
 #include"swap.h"
 #include"sorting.h"
 #include"channel.h"
+#include"transaction.h"
+#include"parallel_sift.h"
 
 #include<stdio.h>
 #include<stdlib.h>
@@ -35,6 +37,12 @@
 static void reposition_node( Nodeptr node, Nodeptr * nodes,
                              int after_position );
 
+/**
+ * @return the position after which the node should go to minimize the
+ * total number of crossings, -1 if it should go first; see sift() below
+ */
+static int sift_position( Nodeptr node );
+
 /**
  * @brief puts the node in a position that minimizes the number of crossings.
  *
@@ -53,6 +61,9 @@ static void reposition_node( Nodeptr node, Nodeptr * nodes,
  * Note that prefix(i) represents the crossings(i) - crossings(-1), where
  * crossings(i) = the number of crossings that arise when the node is
  * inserted between y_i and y_{i+1}
+ *
+ * On very large layers the diffs and prefix sums are computed in parallel,
+ * see parallel_sift.h
  */
 void sift( Nodeptr node )
 {
@@ -60,6 +71,27 @@ void sift( Nodeptr node )
   printf( "-> sift, node = %s, layer = %d, position = %d\n",
           node->name, node->layer, node->position );
 #endif
+  if ( layers[node->layer]->pinned ) return;
+  int layer_size =  layers[node->layer]->number_of_nodes;
+  Nodeptr * nodes = layers[node->layer]->nodes;
+  int min_position = use_parallel_sift( layer_size )
+    ? parallel_sift_position( node ) : sift_position( node );
+
+  // if min_position is i, then the node belongs between nodes[i] and
+  // nodes[i+1];
+
+  reposition_node( node, nodes, min_position ); 
+
+  // recompute crossings with respect to this layer
+  updateCrossingsForLayer( node->layer );
+#ifdef DEBUG
+  printf( "<- sift, node = %s, layer = %d, position = %d\n",
+          node->name, node->layer, node->position );
+#endif
+}
+
+static int sift_position( Nodeptr node )
+{
   // create an array containing diff( node, y_i ) for each y_i on the same
   // layer as 'node', assuming y_i is the node in position i of the layer
   int layer_size =  layers[node->layer]->number_of_nodes;
@@ -100,22 +132,12 @@ void sift( Nodeptr node )
   }
   free( diff );
 
-  // if min_position is i, then the node belongs between nodes[i] and
-  // nodes[i+1];
-
 #ifdef DEBUG
   printf( "   sift, reposition: min_prefix_sum = %d, old = %d, new = %d\n",
           min_prefix_sum, node->position, min_position );
 #endif
 
-  reposition_node( node, nodes, min_position ); 
-
-  // recompute crossings with respect to this layer
-  updateCrossingsForLayer( node->layer );
-#ifdef DEBUG
-  printf( "<- sift, node = %s, layer = %d, position = %d\n",
-          node->name, node->layer, node->position );
-#endif
+  return min_position;
 }
 
 static void reposition_node( Nodeptr node, Nodeptr * nodes,
@@ -128,21 +150,178 @@ static void reposition_node( Nodeptr node, Nodeptr * nodes,
     // intervening nodes, including the one it goes after, are shifted left.
     int i = node->position;
     if( after_position < node->position - 1 ) {
+        if ( transaction_depth > 0 ) logPositionChange( node );
         for( ; i > after_position + 1; i-- ) {
             nodes[i] = nodes[i - 1];
+            if ( transaction_depth > 0 ) logPositionChange( nodes[i] );
             nodes[i]->position = i;
         }
         nodes[after_position + 1] = node;
         node->position = after_position + 1;
+        LAYER_CHANGED( node->layer );
     }
     else if( after_position > node->position ) {
+        if ( transaction_depth > 0 ) logPositionChange( node );
         for( ; i < after_position; i++ ) {
             nodes[i] = nodes[i + 1];
+            if ( transaction_depth > 0 ) logPositionChange( nodes[i] );
             nodes[i]->position = i;
         }
         nodes[after_position] = node;
         node->position = after_position;
+        LAYER_CHANGED( node->layer );
+    }
+}
+
+/**
+ * Fills positions with the positions of the neighbors of the node on the
+ * layer above (up) or below (down), sorted
+ * @return the number of neighbors
+ */
+static int neighbor_positions( Nodeptr node, bool up, int * positions )
+{
+  int degree = up ? node->up_degree : node->down_degree;
+  for ( int i = 0; i < degree; i++ ) {
+    positions[i] = up ? node->up_edges[i]->up_node->position
+      : node->down_edges[i]->down_node->position;
+    // insertion sort; degrees are small
+    for ( int j = i; j > 0 && positions[j - 1] > positions[j]; j-- ) {
+      int temp = positions[j];
+      positions[j] = positions[j - 1];
+      positions[j - 1] = temp;
     }
+  }
+  return degree;
+}
+
+/**
+ * @return true if the two nodes have exactly the same neighbors
+ */
+static bool same_neighborhood( Nodeptr node_a, Nodeptr node_b )
+{
+  if ( node_a->up_degree != node_b->up_degree
+       || node_a->down_degree != node_b->down_degree
+       || DEGREE( node_a ) == 0 )
+    return false;
+  int max_degree = node_a->up_degree > node_a->down_degree
+    ? node_a->up_degree : node_a->down_degree;
+  int * positions_a = (int *) malloc( 2 * max_degree * sizeof(int) );
+  int * positions_b = positions_a + max_degree;
+  bool same = true;
+  for ( int direction = 0; same && direction < 2; direction++ ) {
+    int degree = neighbor_positions( node_a, direction == 0, positions_a );
+    neighbor_positions( node_b, direction == 0, positions_b );
+    for ( int i = 0; same && i < degree; i++ )
+      same = positions_a[i] == positions_b[i];
+  }
+  free( positions_a );
+  return same;
+}
+
+/**
+ * Finds the block that contains the node: the maximal run of adjacent
+ * nodes with the same neighbors as the node or, if there is no such run
+ * with more than one node, the window nodes beginning with the node (moved
+ * left if the layer ends too soon)
+ * @return the number of nodes in the block, whose first position is put
+ * in first_position
+ */
+static int find_block( Nodeptr node, int window, int * first_position )
+{
+  Nodeptr * nodes = layers[ node->layer ]->nodes;
+  int layer_size = layers[ node->layer ]->number_of_nodes;
+  int first = node->position;
+  int last = node->position;
+  while ( first > 0 && same_neighborhood( node, nodes[first - 1] ) )
+    first--;
+  while ( last < layer_size - 1 && same_neighborhood( node, nodes[last + 1] ) )
+    last++;
+  if ( first == last ) {
+    if ( window > layer_size ) window = layer_size;
+    first = node->position;
+    if ( first + window > layer_size ) first = layer_size - window;
+    last = first + window - 1;
+  }
+  *first_position = first;
+  return last - first + 1;
+}
+
+/**
+ * Puts the block of block_size nodes beginning at first_position after the
+ * node that is in position after_position once the block is taken out (-1
+ * means first), keeping the order of the nodes within the block
+ */
+static void reposition_block( Nodeptr * nodes, int layer_size,
+                              int first_position, int block_size,
+                              int after_position )
+{
+  Nodeptr * old_order = (Nodeptr *) malloc( layer_size * sizeof(Nodeptr) );
+  for ( int i = 0; i < layer_size; i++ ) old_order[i] = nodes[i];
+  int position = 0;
+  for ( int i = 0; i <= layer_size - block_size; i++ ) {
+    // i counts the nodes outside the block that precede the next slot
+    if ( i == after_position + 1 ) {
+      for ( int j = 0; j < block_size; j++ )
+        nodes[position++] = old_order[ first_position + j ];
+    }
+    if ( i < layer_size - block_size ) {
+      int old_index = i < first_position ? i : i + block_size;
+      nodes[position++] = old_order[ old_index ];
+    }
+  }
+  for ( int i = 0; i < layer_size; i++ ) {
+    if ( nodes[i]->position != i ) {
+      if ( transaction_depth > 0 ) logPositionChange( nodes[i] );
+      nodes[i]->position = i;
+    }
+  }
+  LAYER_CHANGED( nodes[0]->layer );
+  free( old_order );
+}
+
+/**
+ * The block is evaluated like a single node in sift(): if x_1, ..., x_k are
+ * the nodes of the block and y is another node on the layer, then
+ * diff(y) = sum over j of cr(y,x_j) - cr(x_j,y), and prefix sums over the
+ * other nodes, in order, give the change in crossings for each position of
+ * the block relative to the first. Crossings among the nodes of the block
+ * do not change because the block keeps its internal order.
+ */
+int block_sift( Nodeptr node, int window )
+{
+  int layer = node->layer;
+  int layer_size = layers[ layer ]->number_of_nodes;
+  if ( layers[ layer ]->pinned || layer_size < 3 ) return 0;
+  Nodeptr * nodes = layers[ layer ]->nodes;
+  int first_position;
+  int block_size = find_block( node, window, &first_position );
+  if ( block_size < 2 || block_size == layer_size ) return 0;
+
+  int prefix_sum = 0;
+  int min_prefix_sum = 0;
+  int min_position = -1;
+  int current_prefix_sum = 0;
+  int other_index = 0;
+  for ( int i = 0; i < layer_size; i++ ) {
+    if ( i >= first_position && i < first_position + block_size ) continue;
+    for ( int j = first_position; j < first_position + block_size; j++ )
+      prefix_sum += node_crossings( nodes[i], nodes[j] )
+        - node_crossings( nodes[j], nodes[i] );
+    if ( prefix_sum < min_prefix_sum ) {
+      min_prefix_sum = prefix_sum;
+      min_position = other_index;
+    }
+    if ( i < first_position ) current_prefix_sum = prefix_sum;
+    other_index++;
+  }
+
+  // node_crossings() changes the crossing counts as a side effect
+  int reduction = current_prefix_sum - min_prefix_sum;
+  if ( reduction > 0 )
+    reposition_block( nodes, layer_size, first_position, block_size,
+                      min_position );
+  updateCrossingsForLayer( layer );
+  return reduction;
 }
 
 /**
@@ -162,6 +341,10 @@ static void reposition_node( Nodeptr node, Nodeptr * nodes,
  *    x
  * The calculation of inversions needs to be done both for the upward and the
  * downward edges.       
+ *
+ * The left sweep is done inside a transaction so that the crossing counts
+ * can be restored by rolling back the undo log instead of swapping the node
+ * back across the layer.
  */
 
 void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
@@ -171,6 +354,7 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
           edge->down_node->name, edge->up_node->name, node->name );
 #endif
   int layer = node->layer;
+  if ( layers[ layer ]->pinned ) return;
   int layer_size = layers[ layer ]->number_of_nodes;
   Nodeptr * nodes_on_layer = layers[ layer ]->nodes;
 
@@ -183,10 +367,17 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
   int max_distance = 0;
   int current_edge_crossing_count = INT_MAX;
 
+  // on a very large layer, the values at all positions of both sweeps are
+  // computed in parallel up front, without changing any crossing counts
+  int * values = NULL;
+  if ( use_parallel_sift( layer_size ) )
+    values = parallel_edge_crossings_after_moves( node );
+
   // begin with a sweep to the left of the current node position
+  int start = beginTransaction();
   for ( int i = node->position - 1; i >= 0; i-- ) {
-    current_edge_crossing_count
-      = edge_crossings_after_swap( nodes_on_layer[i], node );
+    current_edge_crossing_count = values != NULL ? values[i]
+      : edge_crossings_after_swap( nodes_on_layer[i], node );
     if ( current_edge_crossing_count < min_edge_crossing_count
          || ( current_edge_crossing_count == min_edge_crossing_count
               && node->position - i > max_distance )
@@ -202,18 +393,13 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
   }
 
   // Undo the left sweep (no need to check for min)
-  for ( int i = 0; i < node->position; i++ ) {
-    edge_crossings_after_swap( node, nodes_on_layer[i] );
-#ifdef DEBUG
-    printf( " mce undo sweep: pos = %2d, min_pos = %2d, edge xings = %d\n",
-            i, min_position, current_edge_crossing_count );
-#endif
-  }
+  rollbackTo( start );
+  commitTransaction( start );
 
   // Then sweep all the way to the right
   for ( int i = node->position + 1; i < layer_size; i++ ) {
-    current_edge_crossing_count
-      = edge_crossings_after_swap( node, nodes_on_layer[i] );
+    current_edge_crossing_count = values != NULL ? values[i]
+      : edge_crossings_after_swap( node, nodes_on_layer[i] );
     if ( current_edge_crossing_count < min_edge_crossing_count
          || ( current_edge_crossing_count == min_edge_crossing_count
               && abs(node->position - i) > max_distance )
@@ -227,6 +413,7 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node ) {
             i, min_position, current_edge_crossing_count );
 #endif
   }
+  free( values );
 
   reposition_node( node, nodes_on_layer, min_position ); 
 
@@ -243,18 +430,23 @@ static void swap_nodes(int layer, int i, int j) {
   assert(i >= 0 && j >= 0);
   assert(i < layers[layer]->number_of_nodes && i < layers[layer]->number_of_nodes);
   Nodeptr * nodes_on_layer = layers[layer]->nodes;
+  if ( transaction_depth > 0 ) {
+    logPositionChange(nodes_on_layer[i]);
+    logPositionChange(nodes_on_layer[j]);
+  }
   Nodeptr tmp = nodes_on_layer[i];
   nodes_on_layer[i] = nodes_on_layer[j];
   nodes_on_layer[j] = tmp;
   nodes_on_layer[i]->position = i;
   nodes_on_layer[j]->position = j;
+  LAYER_CHANGED( layer );
 } 
 
 void sift_node_for_total_stretch(Nodeptr node) {
   int layer = node->layer;
   int layer_size = layers[layer]->number_of_nodes;
 
-  if ( layer_size == 1 ) return;
+  if ( layer_size == 1 || layers[layer]->pinned ) return;
 
   // resorting to the (possibly inefficient) naive algorithm here, i.e.,
   // recomputing stretch after each move
@@ -263,7 +455,9 @@ void sift_node_for_total_stretch(Nodeptr node) {
   int original_position = node->position;
 
   // begin with a sweep to the left of the current node position, keeping
-  // track of minimum stretch, or maximum distance as a tie breaker
+  // track of minimum stretch, or maximum distance as a tie breaker; both
+  // sweeps are tentative and are undone via the transaction log
+  int start = beginTransaction();
   for ( int i = original_position - 1; i >= 0; i-- ) {
     swap_nodes(layer, i, i+1);
     double current_stretch = totalLayerStretch(layer);
@@ -280,10 +474,8 @@ void sift_node_for_total_stretch(Nodeptr node) {
 #endif
   }
 
-  // sweep right, back to the original position (no need to track stretch)
-  for ( int i = 0; i < original_position; i++ ) {
-    swap_nodes(layer, i, i+1);
-  }
+  // back to the original position (no need to track stretch)
+  rollbackTo(start);
 
   // sweep to the right of original position, tracking stretch and distance
   for ( int i = original_position + 1; i < layer_size; i++ ) {
@@ -302,11 +494,89 @@ void sift_node_for_total_stretch(Nodeptr node) {
 #endif
   }
 
-  // sweep left to the min position
-  for ( int i = layer_size - 1; i > min_position; i-- ) {
-    swap_nodes(layer, i-1, i);
-  }
+  // undo the right sweep and move the node directly to the min position
+  abortTransaction(start);
+  if ( min_position < original_position )
+    reposition_node(node, layers[layer]->nodes, min_position - 1);
+  else
+    reposition_node(node, layers[layer]->nodes, min_position);
 
 } // end, sift node for total stretch
 
-/*  [Last modified: 2021 01 06 at 15:47:00 GMT] */
+/**
+ * @return the sum of the positions of all neighbors of the node
+ */
+static long neighbor_position_sum( Nodeptr node )
+{
+  long sum = 0;
+  for ( int i = 0; i < node->up_degree; i++ )
+    sum += node->up_edges[i]->up_node->position;
+  for ( int i = 0; i < node->down_degree; i++ )
+    sum += node->down_edges[i]->down_node->position;
+  return sum;
+}
+
+/**
+ * @return the change in the non-verticality of the edges of the node when
+ * it moves from position p to p + 1 (direction 1) or p - 1 (direction -1):
+ * each edge to a neighbor at position q changes by
+ * (p + direction - q)^2 - (p - q)^2 = 2 direction (p - q) + 1
+ */
+static long nonverticality_change( Nodeptr node, int p, int direction,
+                                   long neighbor_sum )
+{
+  int degree = DEGREE( node );
+  return 2 * direction * ( (long) degree * p - neighbor_sum ) + degree;
+}
+
+void sift_node_for_nonverticality( Nodeptr node ) {
+  int layer = node->layer;
+  int layer_size = layers[layer]->number_of_nodes;
+  Nodeptr * nodes = layers[layer]->nodes;
+
+  if ( layer_size == 1 || layers[layer]->pinned ) return;
+
+  // the neighbors of the nodes on the layer stay put, so the change caused
+  // by each move takes constant time once the position sums are known
+  long * neighbor_sums = (long *) malloc( layer_size * sizeof(long) );
+  for ( int i = 0; i < layer_size; i++ )
+    neighbor_sums[i] = neighbor_position_sum( nodes[i] );
+  int original_position = node->position;
+  long node_sum = neighbor_sums[ original_position ];
+
+  // as in sift_node_for_total_stretch(), ties are broken in favor of the
+  // position farthest from the original one; min_position is the position
+  // the node ends up in
+  long change = 0;
+  long min_change = 0;
+  int min_position = original_position;
+  for ( int i = original_position - 1; i >= 0; i-- ) {
+    // the node moves from i + 1 to i, nodes[i] from i to i + 1
+    change += nonverticality_change( node, i + 1, -1, node_sum )
+      + nonverticality_change( nodes[i], i, 1, neighbor_sums[i] );
+    if ( change <= min_change ) {
+      min_change = change;
+      min_position = i;
+    }
+  }
+  change = 0;
+  for ( int i = original_position + 1; i < layer_size; i++ ) {
+    // the node moves from i - 1 to i, nodes[i] from i to i - 1
+    change += nonverticality_change( node, i - 1, 1, node_sum )
+      + nonverticality_change( nodes[i], i, -1, neighbor_sums[i] );
+    if ( change < min_change
+         || ( change == min_change
+              && i - original_position > abs( original_position - min_position ) ) ) {
+      min_change = change;
+      min_position = i;
+    }
+  }
+  free( neighbor_sums );
+
+  if ( min_position < original_position )
+    reposition_node( node, nodes, min_position - 1 );
+  else
+    reposition_node( node, nodes, min_position );
+} // end, sift node for nonverticality
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
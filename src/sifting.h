@@ -21,6 +21,16 @@
  */
 void sift( Nodeptr node );
 
+/**
+ * Moves a block of adjacent nodes, as a unit, to the position on their layer
+ * that minimizes the total number of crossings, if that is better than the
+ * current one. The block is the maximal run of adjacent nodes that have the
+ * same neighbors as the node or, if the node has no such neighbor on its
+ * layer, the window nodes beginning with the node.
+ * @return the number of crossings saved (0 if the block did not move)
+ */
+int block_sift( Nodeptr node, int window );
+
 /**
  * @param edge An edge that has the current maximum number of crossings; for
  * convience so that this does not need to be recalculated, it is assumed
@@ -37,6 +47,15 @@ void sift_node_for_edge_crossings( Edgeptr edge, Nodeptr node );
  */
 void sift_node_for_total_stretch(Nodeptr node);
 
+/**
+ * @param node This node is placed into a position that minimizes the total
+ * non-verticality (see verticality.h) of edges incident on its layer; ties
+ * are broken as in sift_node_for_total_stretch(). Each candidate position
+ * is evaluated in constant time, so this takes time linear in the size of
+ * the layer and the number of its edges.
+ */
+void sift_node_for_nonverticality( Nodeptr node );
+
 #endif
 
-/*  [Last modified: 2016 05 19 at 20:15:25 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -10,133 +10,64 @@
 #include<stdio.h>
 #include<stdlib.h>
 #include<stdbool.h>
-#include<string.h>              /* memcpy() */
 
 #include"sorting.h"
 #include"graph.h"
 
 /**
- * Performs an insertion sort using the same argument types as qsort
- * @return true if the original order has changed
+ * Defines an insertion sort specialized to one element type and one sort
+ * key, so that the key comparison is inlined instead of going through a
+ * qsort-style comparison function and memcpy of generic elements.
+ *
+ * @param name name of the generated function; it has the signature
+ *   bool name( element_type * array, int length )
+ * and returns true if the original order has changed
+ * @param element_type the type of the array elements (a pointer type)
+ * @param key_type the type of the key (int or double)
+ * @param KEY a macro that extracts the key from an element
+ * @param BEFORE a macro that is true if an element with the first key must
+ * be placed before one with the second; use IS_LESS for a stable sort and
+ * IS_LESS_OR_EQUAL for one that puts equal elements in reverse order
  */
-static bool insertion_sort(void *base, size_t nmemb, size_t size,
-                           int (*compar)(const void *, const void *)) {
-  bool changed = false;
-  // used to store the item to be inserted
-  void * tmp = malloc(size);
-  int i = 1;
-  for( ; i < nmemb; i++ ) {
-    // 1. insert the A[i] among A[0],...,A[i-1]
-    //    (a) copy A[i] into tmp
-    memcpy( tmp, base + i * size, size );
-    //    (b) find largest j for which A[j] <= tmp (or -1 if none exists),
-    //    shifting elements to the right as you go
-    int j = i - 1;
-    while( j >= 0 && compar( tmp, base + j * size) < 0 ) {
-      changed = true;
-      memcpy( base + (j + 1) * size, base + j * size, size );
-      j--;
-    }
-
-    //    (c) copy tmp into A[i+1]
-    memcpy( base + (j + 1) * size, tmp, size ); 
-  }
-  free( tmp );
-  return changed;
-}
-
-/**
- * Performs an "unstable" insertion sort using the same argument types as
- * qsort; unstable means that elements with equal keys will be put in reverse
- * of their original order
- * @return true if the original order has changed
- */
-static bool unstable_insertion_sort(void *base, size_t nmemb, size_t size,
-                                    int (*compar)(const void *, const void *)) {
-  bool changed = false;
-  // used to store the item to be inserted
-  void * tmp = malloc(size);
-  int i = 1;
-  for( ; i < nmemb; i++ ) {
-    // 1. insert the A[i] among A[0],...,A[i-1]
-    //    (a) copy A[i] into tmp
-    memcpy( tmp, base + i * size, size );
-    //    (b) find largest i for which A[i] <= tmp (or -1 if none exists),
-    //    shifting elements to the right as you go
-    int j = i - 1;
-    while( j >= 0 && compar( tmp, base + j * size) <= 0 ) {
-      changed = true;
-      memcpy( base + (j + 1) * size, base + j * size, size );
-      j--;
-    }
-
-    //    (c) copy tmp into A[i+1]
-    memcpy( base + (j + 1) * size, tmp, size ); 
+#define DEFINE_INSERTION_SORT( name, element_type, key_type, KEY, BEFORE ) \
+  static bool name( element_type * array, int length ) {                \
+    bool changed = false;                                               \
+    for( int i = 1; i < length; i++ ) {                                 \
+      /* insert A[i] among A[0],...,A[i-1], shifting larger elements */ \
+      /* to the right as we go */                                       \
+      element_type to_insert = array[i];                                \
+      key_type key = KEY( to_insert );                                  \
+      int j = i - 1;                                                    \
+      while( j >= 0 && BEFORE( key, KEY( array[j] ) ) ) {               \
+        changed = true;                                                 \
+        array[j + 1] = array[j];                                        \
+        j--;                                                            \
+      }                                                                 \
+      array[j + 1] = to_insert;                                         \
+    }                                                                   \
+    return changed;                                                     \
   }
-  free( tmp );
-  return changed;
-}
-
-/**
- * Comparison function to be used by qsort or insertion_sort to compare the
- * weights of two nodes. Assumes that each array element is a pointer to a
- * node. Insertion sort is preferred in most cases because it is stable (and
- * usually does not increase the asymptotic time).
- */
-static int compare_weights( const void * ptr_i, const void * ptr_j ) {
-  Nodeptr * entry_ptr_i = (Nodeptr *) ptr_i;
-  Nodeptr * entry_ptr_j = (Nodeptr *) ptr_j;
-  Nodeptr node_i = * entry_ptr_i;
-  Nodeptr node_j = * entry_ptr_j;
-  if ( node_i->weight > node_j->weight ) return 1;
-  else if( node_i->weight < node_j->weight ) return -1;
-  else return 0;
-}
 
-/**
- * Comparison function to be used by sorting to compare degrees of nodes.
- */
-static int compare_degrees( const void * ptr_i, const void * ptr_j ) {
-  Nodeptr * entry_ptr_i = (Nodeptr *) ptr_i;
-  Nodeptr * entry_ptr_j = (Nodeptr *) ptr_j;
-  Nodeptr node_i = * entry_ptr_i;
-  Nodeptr node_j = * entry_ptr_j;
-  int node_i_degree = node_i->up_degree + node_i->down_degree;
-  int node_j_degree = node_j->up_degree + node_j->down_degree;
-  if( node_i_degree > node_j_degree ) return 1;
-  else if( node_i_degree < node_j_degree ) return -1;
-  else return 0;
-}
-
-/**
- * Comparison function to be used by sorting to compare the weights of two
- * nodes. Assumes that each array element is a pointer to a node.
- */
-static int compare_down_edges( const void * ptr_i, const void * ptr_j ) {
-  Edgeptr * entry_ptr_i = (Edgeptr *) ptr_i;
-  Edgeptr * entry_ptr_j = (Edgeptr *) ptr_j;
-  Edgeptr edge_i = * entry_ptr_i;
-  Edgeptr edge_j = * entry_ptr_j;
-  if( edge_i->down_node->position > edge_j->down_node->position ) return 1;
-  else if( edge_i->down_node->position < edge_j->down_node->position )
-    return -1;
-  else return 0;
-}
-
-/**
- * Comparison function to be used by mergesort to compare the weights of two
- * nodes. Assumes that each array element is a pointer to a node.
- */
-static int compare_up_edges( const void * ptr_i, const void * ptr_j ) {
-  Edgeptr * entry_ptr_i = (Edgeptr *) ptr_i;
-  Edgeptr * entry_ptr_j = (Edgeptr *) ptr_j;
-  Edgeptr edge_i = * entry_ptr_i;
-  Edgeptr edge_j = * entry_ptr_j;
-  if( edge_i->up_node->position > edge_j->up_node->position ) return 1;
-  else if( edge_i->up_node->position < edge_j->up_node->position )
-    return -1;
-  else return 0;
-}
+#define IS_LESS( key_one, key_two ) ( (key_one) < (key_two) )
+#define IS_LESS_OR_EQUAL( key_one, key_two ) ( (key_one) <= (key_two) )
+
+#define WEIGHT_KEY( node ) ( (node)->weight )
+#define DEGREE_KEY( node ) ( (node)->up_degree + (node)->down_degree )
+#define DOWN_POSITION_KEY( edge ) ( (edge)->down_node->position )
+#define UP_POSITION_KEY( edge ) ( (edge)->up_node->position )
+
+// Insertion sort is preferred in most cases because it is stable (and
+// usually does not increase the asymptotic time).
+DEFINE_INSERTION_SORT( sort_by_weight, Nodeptr, double,
+                       WEIGHT_KEY, IS_LESS )
+DEFINE_INSERTION_SORT( unstable_sort_by_weight, Nodeptr, double,
+                       WEIGHT_KEY, IS_LESS_OR_EQUAL )
+DEFINE_INSERTION_SORT( sort_by_degree, Nodeptr, int,
+                       DEGREE_KEY, IS_LESS )
+DEFINE_INSERTION_SORT( sort_by_down_position, Edgeptr, int,
+                       DOWN_POSITION_KEY, IS_LESS )
+DEFINE_INSERTION_SORT( sort_by_up_position, Edgeptr, int,
+                       UP_POSITION_KEY, IS_LESS )
 
 void updateAllPositions( void )
 {
@@ -149,16 +80,23 @@ void updateAllPositions( void )
 void updateNodePositions( int layer )
 {
   Layerptr layerptr = layers[layer];
+  bool changed = false;
   int i = 0;
   for( ; i < layerptr->number_of_nodes; i++ )
     {
+      if ( layerptr->nodes[i]->position == i ) continue;
       layerptr->nodes[i]->position = i;
+      changed = true;
     }
+  // a sort that leaves the order as it was keeps crossings (and frozen
+  // layers) valid
+  if ( changed ) LAYER_CHANGED( layer );
 }
 
 void layerSort( int layer )
 {
   Layerptr layer_ptr = layers[ layer ];
+  if ( layer_ptr->pinned ) return;
 #ifdef DEBUG
   printf( "before layerSort: ");
   for ( int i = 0; i < layer_ptr->number_of_nodes; i++ ) {
@@ -166,8 +104,7 @@ void layerSort( int layer )
   }
   printf( "\n" );
 #endif
-  insertion_sort( layer_ptr->nodes, layer_ptr->number_of_nodes,
-                  sizeof( Nodeptr ), compare_weights );
+  sort_by_weight( layer_ptr->nodes, layer_ptr->number_of_nodes );
 #ifdef DEBUG
   printf( "after layerSort:  ");
   for ( int i = 0; i < layer_ptr->number_of_nodes; i++ ) {
@@ -181,8 +118,8 @@ void layerSort( int layer )
 void layerUnstableSort( int layer )
 {
   Layerptr layer_ptr = layers[ layer ];
-  unstable_insertion_sort( layer_ptr->nodes, layer_ptr->number_of_nodes,
-                           sizeof( Nodeptr ), compare_weights );
+  if ( layer_ptr->pinned ) return;
+  unstable_sort_by_weight( layer_ptr->nodes, layer_ptr->number_of_nodes );
   updateNodePositions( layer );
 }
 
@@ -191,8 +128,7 @@ void layerUnstableSort( int layer )
  */
 void sortByDownNodePosition( Edgeptr * edge_array, int num_edges )
 {
-  insertion_sort( edge_array, num_edges, sizeof(Edgeptr),
-                  compare_down_edges );
+  sort_by_down_position( edge_array, num_edges );
 }
 
 /**
@@ -200,13 +136,35 @@ void sortByDownNodePosition( Edgeptr * edge_array, int num_edges )
  */
 void sortByUpNodePosition( Edgeptr * edge_array, int num_edges )
 {
-  insertion_sort( edge_array, num_edges, sizeof(Edgeptr),
-                  compare_up_edges );
+  sort_by_up_position( edge_array, num_edges );
 }
 
 void sortByDegree( Nodeptr * node_array, int num_nodes )
 {
-  insertion_sort( node_array, num_nodes, sizeof(Nodeptr), compare_degrees );
+  sort_by_degree( node_array, num_nodes );
+}
+
+void sortByLayer( Nodeptr * node_array, int num_nodes, bool decreasing )
+{
+  // counting sort: first_index[k] is where the next node of the k-th layer
+  // in the chosen direction goes
+  int * first_index = calloc( number_of_layers + 1, sizeof(int) );
+  for ( int i = 0; i < num_nodes; i++ ) {
+    int layer = node_array[i]->layer;
+    int rank = decreasing ? number_of_layers - 1 - layer : layer;
+    first_index[rank + 1]++;
+  }
+  for ( int rank = 1; rank <= number_of_layers; rank++ )
+    first_index[rank] += first_index[rank - 1];
+  Nodeptr * sorted = malloc( num_nodes * sizeof(Nodeptr) );
+  for ( int i = 0; i < num_nodes; i++ ) {
+    int layer = node_array[i]->layer;
+    int rank = decreasing ? number_of_layers - 1 - layer : layer;
+    sorted[ first_index[rank]++ ] = node_array[i];
+  }
+  for ( int i = 0; i < num_nodes; i++ ) node_array[i] = sorted[i];
+  free( sorted );
+  free( first_index );
 }
 
-/*  [Last modified: 2014 07 21 at 18:21:49 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
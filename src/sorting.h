@@ -52,9 +52,16 @@ void sortByUpNodePosition( Edgeptr * edge_array, int num_edges );
  */
 void sortByDegree( Nodeptr * node_array, int num_nodes );
 
+/**
+ * Sorts the array of nodes by layer, increasing or decreasing; nodes on the
+ * same layer keep their relative order. Takes linear time.
+ */
+void sortByLayer( Nodeptr * node_array, int num_nodes, bool decreasing );
+
 /**
  * Updates the position field of each node on the layer to reflect the current
- * position in the nodes array.
+ * position in the nodes array. The layer counts as changed (see graph.h)
+ * only if some position field had to be updated.
  */
 void updateNodePositions( int layer );
 
@@ -65,4 +72,4 @@ void updateAllPositions( void );
 
 #endif
 
-/*  [Last modified: 2011 07 18 at 19:20:59 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -24,16 +24,116 @@
 #include"channel.h"
 #include"Statistics.h"
 #include"timing.h"
+#include"tasks.h"
+#include"evaluation.h"
+#include"verticality.h"
 
+/**
+ * The order of each point on the Pareto frontier is kept as a delta against
+ * a base order shared by all points (the order when the first point was
+ * inserted): the positions, numbered layer by layer, where the order of the
+ * point differs from the base, and the nodes at those positions. A point is
+ * deallocated, delta and all, as soon as another point dominates it, so the
+ * memory used never exceeds that of one full order per point on the current
+ * frontier, and is usually much less.
+ */
 typedef struct pareto_item {
   double objective_one;
   double objective_two;
   int iteration;
+  int delta_length;
+  int * delta_index;
+  Nodeptr * delta_node;
   struct pareto_item * rest;
 } * PARETO_LIST;
 
 static PARETO_LIST pareto_list = NULL;
 
+/** the base order, layer by layer; pareto_base_offset[i] is the index of
+ * the first node of layer i */
+static Nodeptr * pareto_base = NULL;
+static int * pareto_base_offset = NULL;
+
+/** the order to be captured by the current insertion, as an array of layer
+ * orders; NULL means the current order of the graph */
+static Nodeptr ** pareto_source = NULL;
+
+static Nodeptr pareto_source_node( int layer, int position )
+{
+  return pareto_source != NULL
+    ? pareto_source[layer][position] : layers[layer]->nodes[position];
+}
+
+static void init_pareto_base( void )
+{
+  pareto_base_offset = (int *) calloc( number_of_layers + 1, sizeof(int) );
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    pareto_base_offset[layer + 1]
+      = pareto_base_offset[layer] + layers[layer]->number_of_nodes;
+  pareto_base
+    = (Nodeptr *) calloc( pareto_base_offset[number_of_layers] + 1,
+                          sizeof(Nodeptr) );
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    for ( int position = 0; position < layers[layer]->number_of_nodes;
+          position++ )
+      pareto_base[ pareto_base_offset[layer] + position ]
+        = pareto_source_node( layer, position );
+}
+
+/**
+ * Records the order given by pareto_source as the delta of the item,
+ * replacing any previous one
+ */
+static void capture_pareto_order( PARETO_LIST item )
+{
+  if ( pareto_base == NULL ) init_pareto_base();
+  free( item->delta_index );
+  free( item->delta_node );
+  int length = 0;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    for ( int position = 0; position < layers[layer]->number_of_nodes;
+          position++ )
+      if ( pareto_source_node( layer, position )
+           != pareto_base[ pareto_base_offset[layer] + position ] )
+        length++;
+  item->delta_length = length;
+  item->delta_index = (int *) calloc( length + 1, sizeof(int) );
+  item->delta_node = (Nodeptr *) calloc( length + 1, sizeof(Nodeptr) );
+  int next = 0;
+  for ( int layer = 0; layer < number_of_layers; layer++ )
+    for ( int position = 0; position < layers[layer]->number_of_nodes;
+          position++ ) {
+      Nodeptr node = pareto_source_node( layer, position );
+      int index = pareto_base_offset[layer] + position;
+      if ( node != pareto_base[index] ) {
+        item->delta_index[next] = index;
+        item->delta_node[next] = node;
+        next++;
+      }
+    }
+}
+
+static PARETO_LIST new_pareto_item( double objective_one,
+                                    double objective_two,
+                                    int iteration,
+                                    PARETO_LIST rest )
+{
+  PARETO_LIST item = (PARETO_LIST) calloc(1, sizeof(struct pareto_item));
+  item->objective_one = objective_one;
+  item->objective_two = objective_two;
+  item->iteration = iteration;
+  item->rest = rest;
+  capture_pareto_order( item );
+  return item;
+}
+
+static void free_pareto_item( PARETO_LIST item )
+{
+  free( item->delta_index );
+  free( item->delta_node );
+  free( item );
+}
+
 static void init_pareto_list( void ) { pareto_list = NULL; }
 
 /**
@@ -91,11 +191,8 @@ static PARETO_LIST pareto_insert(double objective_one,
 #endif
   PARETO_LIST new_list = NULL;
   if ( list == NULL ) {
-    new_list = (PARETO_LIST) calloc(1, sizeof(struct pareto_item));
-    new_list->objective_one = objective_one;
-    new_list->objective_two = objective_two;
-    new_list->iteration = iteration;
-    new_list->rest = NULL;
+    new_list = new_pareto_item( objective_one, objective_two, iteration,
+                                NULL );
   }
   else {
     double first_objective_one = list->objective_one;
@@ -103,17 +200,15 @@ static PARETO_LIST pareto_insert(double objective_one,
     if ( objective_one < first_objective_one
          && objective_two > first_objective_two ) {
       // new pareto point
-      new_list = (PARETO_LIST) calloc(1, sizeof(struct pareto_item));
-      new_list->objective_one = objective_one;
-      new_list->objective_two = objective_two;
-      new_list->iteration = iteration;
-      new_list->rest = list;
+      new_list = new_pareto_item( objective_one, objective_two, iteration,
+                                  list );
     }
     else if ( objective_one < first_objective_one
               && objective_two == first_objective_two ) {
       // replace first point, found one with smaller objective_one value
       list->objective_one = objective_one;
       list->iteration = iteration;
+      capture_pareto_order( list );
       new_list = list;
     }
     else if ( objective_one <= first_objective_one
@@ -125,7 +220,7 @@ static PARETO_LIST pareto_insert(double objective_one,
                                objective_two,
                                iteration,
                                list->rest);
-      free(list);
+      free_pareto_item(list);
     }
     else if ( objective_one > first_objective_one
               && objective_two < first_objective_two ) {
@@ -157,11 +252,54 @@ static PARETO_LIST pareto_insert(double objective_one,
 static void deallocatePLhelper(PARETO_LIST list) {
     if ( list == NULL ) return;
     deallocatePLhelper(list->rest);
-    free(list);
+    free_pareto_item(list);
 }
 
 void deallocateParetoList(void) {
     deallocatePLhelper(pareto_list);
+    pareto_list = NULL;
+    free(pareto_base);
+    free(pareto_base_offset);
+    pareto_base = NULL;
+    pareto_base_offset = NULL;
+}
+
+int numberOfParetoPoints(void) {
+    int count = 0;
+    for ( PARETO_LIST item = pareto_list; item != NULL; item = item->rest )
+        count++;
+    return count;
+}
+
+void restoreParetoOrder(int index) {
+    PARETO_LIST item = pareto_list;
+    for ( int i = 0; i < index && item != NULL; i++ )
+        item = item->rest;
+    if ( item == NULL || pareto_base == NULL ) return;
+    for ( int layer = 0; layer < number_of_layers; layer++ )
+        for ( int position = 0; position < layers[layer]->number_of_nodes;
+              position++ )
+            layers[layer]->nodes[position]
+                = pareto_base[ pareto_base_offset[layer] + position ];
+    for ( int i = 0; i < item->delta_length; i++ ) {
+        int base_index = item->delta_index[i];
+        // find the layer by binary search on the offsets
+        int low = 0;
+        int high = number_of_layers - 1;
+        while ( low < high ) {
+            int middle = (low + high + 1) / 2;
+            if ( pareto_base_offset[middle] <= base_index ) low = middle;
+            else high = middle - 1;
+        }
+        layers[low]->nodes[ base_index - pareto_base_offset[low] ]
+            = item->delta_node[i];
+    }
+    for ( int layer = 0; layer < number_of_layers; layer++ ) {
+        for ( int position = 0; position < layers[layer]->number_of_nodes;
+              position++ )
+            layers[layer]->nodes[position]->position = position;
+        LAYER_CHANGED( layer );
+    }
 }
 
 CROSSING_STATS_INT total_crossings;
@@ -169,6 +307,7 @@ CROSSING_STATS_INT max_edge_crossings;
 CROSSING_STATS_INT favored_edge_crossings;
 CROSSING_STATS_DOUBLE total_stretch;
 CROSSING_STATS_DOUBLE bottleneck_stretch;
+CROSSING_STATS_DOUBLE total_nonverticality;
 Statistics overall_degree;
 
 static void init_specific_crossing_stats_int( CROSSING_STATS_INT * stats,
@@ -205,6 +344,7 @@ void init_crossing_stats( void )
   init_specific_crossing_stats_int( & max_edge_crossings, "BottleneckCrossings" );
   init_specific_crossing_stats_double( & total_stretch, "Stretch" );
   init_specific_crossing_stats_double( & bottleneck_stretch, "BottleneckStretch" );
+  init_specific_crossing_stats_double( & total_nonverticality, "Nonverticality" );
   if ( pareto_objective != NO_PARETO )
     init_pareto_list();
 }
@@ -215,6 +355,7 @@ void capture_beginning_stats( void )
   max_edge_crossings.at_beginning = maxEdgeCrossings();
   total_stretch.at_beginning = totalStretch();
   bottleneck_stretch.at_beginning = maxEdgeStretch();
+  total_nonverticality.at_beginning = totalNonverticality();
 }
 
 void capture_preprocessing_stats( void )
@@ -223,6 +364,7 @@ void capture_preprocessing_stats( void )
   max_edge_crossings.after_preprocessing = maxEdgeCrossings();
   total_stretch.after_preprocessing = totalStretch();
   bottleneck_stretch.after_preprocessing = maxEdgeStretch();
+  total_nonverticality.after_preprocessing = totalNonverticality();
 }
 
 void capture_heuristic_stats( void )
@@ -231,6 +373,7 @@ void capture_heuristic_stats( void )
   max_edge_crossings.after_heuristic = max_edge_crossings.best;
   total_stretch.after_heuristic = total_stretch.best;
   bottleneck_stretch.after_heuristic = bottleneck_stretch.best;
+  total_nonverticality.after_heuristic = total_nonverticality.best;
 }
 
 void capture_post_processing_stats( void )
@@ -243,6 +386,7 @@ void capture_post_processing_stats( void )
   max_edge_crossings.after_post_processing = max_edge_crossings.best;
   total_stretch.after_post_processing = total_stretch.best;
   bottleneck_stretch.after_post_processing = bottleneck_stretch.best;
+  total_nonverticality.after_post_processing = total_nonverticality.best;
 }
 
 void update_best_int( CROSSING_STATS_INT * stats, Orderptr order,
@@ -298,26 +442,44 @@ void update_best_double( CROSSING_STATS_DOUBLE * stats, Orderptr order,
  */
 void update_best_all( void )
 {
+  if ( asynchronousEvaluation() ) {
+    submitEvaluation();
+    return;
+  }
   update_best_int( & total_crossings, best_crossings_order, numberOfCrossings );
+  // without per-edge counts (-C) maxEdgeCrossings() computes those of the
+  // channels that changed since they were last needed
   update_best_int( & max_edge_crossings,
                    best_edge_crossings_order, maxEdgeCrossings );
   update_best_double( & total_stretch, best_total_stretch_order, totalStretch );
   update_best_double( & bottleneck_stretch,
                       best_bottleneck_stretch_order, maxEdgeStretch );
+  update_best_double( & total_nonverticality, best_nonverticality_order,
+                      totalNonverticality );
+  if ( pareto_objective != NO_PARETO )
+    update_pareto_list( numberOfCrossings(), maxEdgeCrossings(),
+                        totalStretch(), iteration, NULL );
+}
+
+void update_pareto_list( int crossings, int bottleneck_crossings,
+                         double stretch, int pareto_iteration,
+                         Nodeptr ** layer_orders )
+{
+  pareto_source = layer_orders;
   if ( pareto_objective == BOTTLENECK_TOTAL )
-    pareto_list = pareto_insert( maxEdgeCrossings(),
-                                 numberOfCrossings(),
-                                 iteration,
+    pareto_list = pareto_insert( bottleneck_crossings,
+                                 crossings,
+                                 pareto_iteration,
                                  pareto_list );
   else if ( pareto_objective == STRETCH_TOTAL )
-    pareto_list = pareto_insert( totalStretch(),
-                                 numberOfCrossings(),
-                                 iteration,
+    pareto_list = pareto_insert( stretch,
+                                 crossings,
+                                 pareto_iteration,
                                  pareto_list );
   else if ( pareto_objective == BOTTLENECK_STRETCH )
-    pareto_list = pareto_insert( maxEdgeCrossings(),
-                                 totalStretch(),
-                                 iteration,
+    pareto_list = pareto_insert( bottleneck_crossings,
+                                 stretch,
+                                 pareto_iteration,
                                  pareto_list );
 }
 
@@ -328,7 +490,8 @@ bool has_improved_int( CROSSING_STATS_INT * stats )
           stats->name, stats->best, stats->previous_best );
 #endif
   bool improved = false;
-  if ( stats->best < stats->previous_best ) {
+  if ( stats->best < stats->previous_best
+       - improvement_threshold * stats->previous_best ) {
     improved = true;
     stats->previous_best = stats->best;
   }
@@ -346,7 +509,8 @@ bool has_improved_double( CROSSING_STATS_DOUBLE * stats )
           stats->name, stats->best, stats->previous_best );
 #endif
   bool improved = false;
-  if ( stats->best < stats->previous_best ) {
+  if ( stats->best < stats->previous_best
+       - improvement_threshold * stats->previous_best ) {
     improved = true;
     stats->previous_best = stats->best;
   }
@@ -452,18 +616,70 @@ static void print_channel_edge_counts( FILE * output_stream ) {
   }
 }
 
-static void compute_degree_statistics( void )
+/**
+ * Collects the degrees of all nodes on layers first, ..., last - 1, one
+ * Statistics per layer
+ */
+static void collect_layer_degrees( int first, int last, void * context )
 {
-  for( int layer = 0; layer < number_of_layers; layer++ )
+  Statistics * layer_degree = (Statistics *) context;
+  for( int layer = first; layer < last; layer++ )
     {
+      layer_degree[ layer ]
+        = init_statistics( layers[ layer ]->number_of_nodes );
       for( int position = 0; position < layers[ layer ]->number_of_nodes; position++ )
         {
           Nodeptr node = layers[ layer ]->nodes[ position ];
-          add_data( overall_degree, DEGREE( node ) );
+          add_data( layer_degree[ layer ], DEGREE( node ) );
         }
     }
 }
 
+/**
+ * One round of merging per-layer statistics pairwise: the statistics for
+ * layer i + step are merged into those for layer i whenever i is a multiple
+ * of 2 * step
+ */
+struct merge_round {
+  Statistics * layer_degree;
+  int step;
+};
+
+static void merge_layer_degrees( int first, int last, void * context )
+{
+  struct merge_round * round = (struct merge_round *) context;
+  for ( int pair = first; pair < last; pair++ )
+    {
+      int layer = 2 * round->step * pair;
+      if ( layer + round->step >= number_of_layers ) continue;
+      merge_statistics( round->layer_degree[ layer ],
+                        round->layer_degree[ layer + round->step ] );
+      free_statistics( round->layer_degree[ layer + round->step ] );
+    }
+}
+
+/**
+ * Degrees are collected into per-layer Statistics in parallel, which are
+ * then merged in a balanced tree; insertion into one large sorted array
+ * would take quadratic time.
+ */
+static void compute_degree_statistics( void )
+{
+  if ( number_of_layers == 0 ) return;
+  Statistics * layer_degree
+    = (Statistics *) calloc( number_of_layers, sizeof(Statistics) );
+  parallelFor( 0, number_of_layers, 1, collect_layer_degrees, layer_degree );
+  for ( int step = 1; step < number_of_layers; step *= 2 )
+    {
+      struct merge_round round = { layer_degree, step };
+      int number_of_pairs = (number_of_layers + 2 * step - 1) / (2 * step);
+      parallelFor( 0, number_of_pairs, 1, merge_layer_degrees, &round );
+    }
+  merge_statistics( overall_degree, layer_degree[0] );
+  free_statistics( layer_degree[0] );
+  free( layer_degree );
+}
+
 static void print_degree_statistics( FILE * output_stream )
 {
   Statistics nodes_per_layer = init_statistics( number_of_layers );
@@ -565,11 +781,13 @@ void print_run_statistics( FILE * output_stream )
     fprintf( output_stream, "Heuristic,%s\n", heuristic );
     fprintf( output_stream, "Iterations,%d\n", iteration );
     fprintf( output_stream, "Runtime,%2.3f\n", RUNTIME );
+    fprintf( output_stream, "StoppingReason,%s\n", stopping_reason );
     
     print_crossing_stats_int( output_stream, total_crossings );
     print_crossing_stats_int( output_stream, max_edge_crossings );
     print_crossing_stats_double( output_stream, total_stretch );
     print_crossing_stats_double( output_stream, bottleneck_stretch );
+    print_crossing_stats_double( output_stream, total_nonverticality );
 
     if ( pareto_objective != NO_PARETO ) {
         char buffer[MAX_NAME_LENGTH];
@@ -578,4 +796,4 @@ void print_run_statistics( FILE * output_stream )
     }
 }
 
-/*  [Last modified: 2021 03 03 at 00:01:06 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -44,6 +44,7 @@ extern CROSSING_STATS_INT max_edge_crossings;
 extern CROSSING_STATS_INT favored_edge_crossings;
 extern CROSSING_STATS_DOUBLE total_stretch;
 extern CROSSING_STATS_DOUBLE bottleneck_stretch;
+extern CROSSING_STATS_DOUBLE total_nonverticality;
 
 /**
  * Initializes crossing stats structures
@@ -95,13 +96,25 @@ void update_best_double( CROSSING_STATS_DOUBLE * stats, Orderptr order,
 
 /**
  * Updates the best value of all stats if needed, i.e., calls update_best on
- * all stats 
+ * all stats; with asynchronous evaluation (-A) only the primary objective is
+ * updated here, the rest by the helper thread (see evaluation.h)
  */
 void update_best_all( void );
 
+/**
+ * Inserts the values of the two objectives given by pareto_objective into
+ * the Pareto list, if appropriate, together with the order that has them
+ * @param pareto_iteration the iteration at which the values were reached
+ * @param layer_orders the nodes of each layer in order, NULL for the
+ * current order of the graph
+ */
+void update_pareto_list( int crossings, int bottleneck_crossings,
+                         double stretch, int pareto_iteration,
+                         Nodeptr ** layer_orders );
+
 /**
  * @return true if stats.best has improved since the last time this function
- * was called
+ * returned true, by more than improvement_threshold times the value then
  *
  * <em>Side effect</e> stats.previous_best is updated
  */
@@ -109,7 +122,7 @@ bool has_improved_int( CROSSING_STATS_INT * stats );
 
 /**
  * @return true if stats.best has improved since the last time this function
- * was called
+ * returned true, by more than improvement_threshold times the value then
  *
  * <em>Side effect</e> stats.previous_best is updated
  */
@@ -137,6 +150,18 @@ void getParetoList(char * buffer);
  */
 void deallocateParetoList(void);
 
+/**
+ * @return the number of points currently on the Pareto list
+ */
+int numberOfParetoPoints(void);
+
+/**
+ * Changes the order of the graph to that of the point with the given index
+ * on the Pareto list (0 is the point with the smallest value of the first
+ * objective); node positions are updated, crossings are not
+ */
+void restoreParetoOrder(int index);
+
 #endif
 
-/*  [Last modified: 2021 02 15 at 17:59:28 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
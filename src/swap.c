@@ -58,6 +58,10 @@ int node_crossings( Nodeptr node_a, Nodeptr node_b )
 {
   assert( node_a->layer == node_b->layer );
   int layer = node_a->layer;
+  // when per-edge counts are maintained, the counts of the edges involved
+  // are changed as a side effect; otherwise only the total is computed
+  bool side_effect = crossingCounts() == EDGE_COUNTS;
+  if ( side_effect ) LAYER_CHANGED( layer );
 
   int total_crossings = 0;
 
@@ -68,9 +72,10 @@ int node_crossings( Nodeptr node_a, Nodeptr node_b )
         = (Edgeptr *) calloc( node_a->up_degree + node_b->up_degree,
                               sizeof(Edgeptr) );
       create_sorted_up_edge_array( edge_array, node_a, node_b );
-      total_crossings += count_inversions_up( edge_array,
-                                              node_a->up_degree
-                                              + node_b->up_degree, 1 );
+      int number_of_edges = node_a->up_degree + node_b->up_degree;
+      total_crossings += side_effect
+        ? count_inversions_up( edge_array, number_of_edges, 1 )
+        : count_inversions_up_total( edge_array, number_of_edges, 1 );
       free( edge_array );
     }
 
@@ -82,9 +87,10 @@ int node_crossings( Nodeptr node_a, Nodeptr node_b )
                               sizeof(Edgeptr) );
 
       create_sorted_down_edge_array( edge_array, node_a, node_b );
-      total_crossings += count_inversions_down( edge_array,
-                                                node_a->down_degree
-                                                + node_b->down_degree, 1 );
+      int number_of_edges = node_a->down_degree + node_b->down_degree;
+      total_crossings += side_effect
+        ? count_inversions_down( edge_array, number_of_edges, 1 )
+        : count_inversions_down_total( edge_array, number_of_edges, 1 );
       free( edge_array );
     }
   return total_crossings;
@@ -93,6 +99,7 @@ int node_crossings( Nodeptr node_a, Nodeptr node_b )
 void change_crossings( Nodeptr left_node, Nodeptr right_node, int diff )
 {
   int layer = left_node->layer;
+  LAYER_CHANGED( layer );
 
   // update crossings on upward edges (if any)
   if ( layer < number_of_layers - 1 )
@@ -159,4 +166,4 @@ void create_sorted_down_edge_array( Edgeptr * edge_array,
                       first_node->down_degree );
 }
 
-/*  [Last modified: 2011 05 24 at 15:59:47 GMT] */
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
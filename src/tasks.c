@@ -0,0 +1,263 @@
+/**
+ * @file tasks.c
+ * @brief Implementation of the work-stealing task scheduler.
+ *
+ * Each deque is a circular array protected by its own lock; the owner
+ * pushes and pops at the bottom, thieves take from the top. Contention is
+ * limited to a worker and an occasional thief, and tasks here are coarse
+ * (a channel, a layer, a block of nodes), so a lock per deque is adequate.
+ * Idle workers sleep on a condition variable until a task is queued.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#include"constants.h"
+#include"tasks.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdbool.h>
+#include<assert.h>
+#include<pthread.h>
+#include<sched.h>
+
+typedef struct task {
+  TaskFunction function;
+  void * argument;
+  struct task_group * group;
+} Task;
+
+typedef struct worker {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  Task * tasks;
+  int capacity;
+  /** index of the oldest task */
+  int top;
+  /** number of tasks in the deque */
+  int size;
+} * Workerptr;
+
+static struct worker * workers = NULL;
+static int number_of_workers = 1;
+
+/** index of the worker that is running on this thread */
+static __thread int current_worker = 0;
+
+/** total number of tasks in all deques; idle workers wait for this > 0 */
+static volatile int queued_tasks = 0;
+static volatile bool shutting_down = false;
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work_available = PTHREAD_COND_INITIALIZER;
+
+static void push_bottom( Workerptr worker, Task task )
+{
+  pthread_mutex_lock( &worker->lock );
+  if ( worker->size == worker->capacity ) {
+    int new_capacity = worker->capacity == 0
+      ? CAPACITY_INCREMENT : 2 * worker->capacity;
+    Task * new_tasks = (Task *) calloc( new_capacity, sizeof(Task) );
+    for ( int i = 0; i < worker->size; i++ )
+      new_tasks[i] = worker->tasks[ (worker->top + i) % worker->capacity ];
+    free( worker->tasks );
+    worker->tasks = new_tasks;
+    worker->capacity = new_capacity;
+    worker->top = 0;
+  }
+  worker->tasks[ (worker->top + worker->size) % worker->capacity ] = task;
+  worker->size++;
+  pthread_mutex_unlock( &worker->lock );
+}
+
+static bool pop_bottom( Workerptr worker, Task * task )
+{
+  bool found = false;
+  pthread_mutex_lock( &worker->lock );
+  if ( worker->size > 0 ) {
+    worker->size--;
+    *task = worker->tasks[ (worker->top + worker->size) % worker->capacity ];
+    found = true;
+  }
+  pthread_mutex_unlock( &worker->lock );
+  return found;
+}
+
+static bool steal_top( Workerptr worker, Task * task )
+{
+  bool found = false;
+  pthread_mutex_lock( &worker->lock );
+  if ( worker->size > 0 ) {
+    *task = worker->tasks[ worker->top ];
+    worker->top = (worker->top + 1) % worker->capacity;
+    worker->size--;
+    found = true;
+  }
+  pthread_mutex_unlock( &worker->lock );
+  return found;
+}
+
+/**
+ * Takes a task from the current worker's own deque or, failing that, steals
+ * one from another worker, trying them in round-robin order
+ * @return true if a task was found
+ */
+static bool find_task( Task * task )
+{
+  int me = current_worker;
+  bool found = pop_bottom( &workers[me], task );
+  for ( int i = 1; ! found && i < number_of_workers; i++ )
+    found = steal_top( &workers[ (me + i) % number_of_workers ], task );
+  if ( found ) __sync_fetch_and_sub( &queued_tasks, 1 );
+  return found;
+}
+
+static void run_task( Task * task )
+{
+  task->function( task->argument );
+  __sync_fetch_and_sub( &task->group->pending, 1 );
+}
+
+static void * worker_loop( void * arg )
+{
+  current_worker = (int) (long) arg;
+  while ( true ) {
+    pthread_mutex_lock( &idle_lock );
+    while ( queued_tasks == 0 && ! shutting_down )
+      pthread_cond_wait( &work_available, &idle_lock );
+    pthread_mutex_unlock( &idle_lock );
+    if ( shutting_down ) break;
+    Task task;
+    if ( find_task( &task ) ) run_task( &task );
+  }
+  return NULL;
+}
+
+void initializeTasks( int number_of_threads )
+{
+  assert( workers == NULL );
+  number_of_workers = number_of_threads > 1 ? number_of_threads : 1;
+  workers = (struct worker *) calloc( number_of_workers,
+                                      sizeof(struct worker) );
+  for ( int i = 0; i < number_of_workers; i++ )
+    pthread_mutex_init( &workers[i].lock, NULL );
+  current_worker = 0;
+  for ( int i = 1; i < number_of_workers; i++ ) {
+    if ( pthread_create( &workers[i].thread, NULL,
+                         worker_loop, (void *) (long) i ) != 0 ) {
+      fprintf( stderr, "*** FATAL ERROR: unable to create worker thread\n" );
+      exit( EXIT_FAILURE );
+    }
+  }
+}
+
+int numberOfWorkers( void )
+{
+  return number_of_workers;
+}
+
+void beginTasks( struct task_group * group )
+{
+  group->pending = 0;
+}
+
+void forkTask( struct task_group * group, TaskFunction function,
+               void * argument )
+{
+  if ( number_of_workers == 1 ) {
+    function( argument );
+    return;
+  }
+  Task task = { function, argument, group };
+  __sync_fetch_and_add( &group->pending, 1 );
+  push_bottom( &workers[ current_worker ], task );
+  __sync_fetch_and_add( &queued_tasks, 1 );
+  pthread_mutex_lock( &idle_lock );
+  pthread_cond_signal( &work_available );
+  pthread_mutex_unlock( &idle_lock );
+}
+
+void joinTasks( struct task_group * group )
+{
+  while ( __sync_fetch_and_add( &group->pending, 0 ) > 0 ) {
+    Task task;
+    if ( find_task( &task ) ) run_task( &task );
+    else sched_yield();
+  }
+}
+
+/**
+ * A piece of the index range of a parallelFor()
+ */
+typedef struct range {
+  int first;
+  int last;
+  int grain;
+  void (* body)( int first_index, int last_index, void * context );
+  void * context;
+  struct task_group * group;
+} * Rangeptr;
+
+/**
+ * Repeatedly splits off the upper half of the range as a new task until
+ * the range is no larger than the grain, then runs the body on what is left
+ */
+static void run_range( void * argument )
+{
+  Rangeptr range = (Rangeptr) argument;
+  while ( range->last - range->first > range->grain ) {
+    int middle = range->first + (range->last - range->first) / 2;
+    Rangeptr upper = (Rangeptr) malloc( sizeof(struct range) );
+    *upper = *range;
+    upper->first = middle;
+    range->last = middle;
+    forkTask( range->group, run_range, upper );
+  }
+  range->body( range->first, range->last, range->context );
+  free( range );
+}
+
+void parallelFor( int first, int last, int grain,
+                  void (* body)( int first_index, int last_index,
+                                 void * context ),
+                  void * context )
+{
+  if ( first >= last ) return;
+  if ( grain < 1 ) grain = 1;
+  if ( number_of_workers == 1 || last - first <= grain ) {
+    body( first, last, context );
+    return;
+  }
+  struct task_group group;
+  beginTasks( &group );
+  Rangeptr range = (Rangeptr) malloc( sizeof(struct range) );
+  range->first = first;
+  range->last = last;
+  range->grain = grain;
+  range->body = body;
+  range->context = context;
+  range->group = &group;
+  forkTask( &group, run_range, range );
+  joinTasks( &group );
+}
+
+void deallocateTasks( void )
+{
+  if ( workers == NULL ) return;
+  pthread_mutex_lock( &idle_lock );
+  shutting_down = true;
+  pthread_cond_broadcast( &work_available );
+  pthread_mutex_unlock( &idle_lock );
+  for ( int i = 1; i < number_of_workers; i++ )
+    pthread_join( workers[i].thread, NULL );
+  for ( int i = 0; i < number_of_workers; i++ ) {
+    pthread_mutex_destroy( &workers[i].lock );
+    free( workers[i].tasks );
+  }
+  free( workers );
+  workers = NULL;
+  number_of_workers = 1;
+  shutting_down = false;
+}
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
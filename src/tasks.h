@@ -0,0 +1,93 @@
+/**
+ * @file tasks.h
+ * @brief A small work-stealing task scheduler with a fork-join interface,
+ * shared by all parts of the program that do work in parallel.
+ *
+ * The worker threads are created once, by initializeTasks(); the thread
+ * that calls it acts as worker 0. Each worker has its own deque of tasks:
+ * tasks forked by a worker are pushed onto the bottom of its deque and taken
+ * from there by the worker itself (most recent first), while idle workers
+ * steal from the top of other workers' deques (oldest first).
+ *
+ * Usage:
+ * <pre>
+ *   struct task_group group;
+ *   beginTasks( &group );
+ *   for ( ... ) forkTask( &group, function, argument );
+ *   joinTasks( &group );    // returns when all forked tasks are done
+ * </pre>
+ * A worker waiting in joinTasks() runs other tasks in the meantime, so
+ * tasks may themselves fork and join. With a single thread every task is
+ * run immediately by forkTask(), so results never depend on scheduling when
+ * the tasks are independent.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+/**
+ * A task is a function applied to an argument
+ */
+typedef void (* TaskFunction)( void * argument );
+
+/**
+ * A set of tasks that are joined together; the caller owns the storage,
+ * typically a local variable
+ */
+struct task_group {
+  /** number of tasks forked in this group that have not finished */
+  volatile int pending;
+};
+
+/**
+ * Creates number_of_threads - 1 worker threads; the calling thread is the
+ * remaining one. Must be called once before any other function here.
+ */
+void initializeTasks( int number_of_threads );
+
+/**
+ * @return the number of workers, including the thread that called
+ * initializeTasks(); 1 if tasks were never initialized
+ */
+int numberOfWorkers( void );
+
+/**
+ * Prepares a group for forking tasks
+ */
+void beginTasks( struct task_group * group );
+
+/**
+ * Schedules function( argument ) as part of the group; runs it immediately
+ * if there is only one worker
+ */
+void forkTask( struct task_group * group, TaskFunction function,
+               void * argument );
+
+/**
+ * Waits until all tasks forked in the group have finished, running pending
+ * tasks (of any group) while waiting
+ */
+void joinTasks( struct task_group * group );
+
+/**
+ * Applies body( first_index, last_index, context ) to disjoint subranges
+ * covering [first, last), with at most grain indices per subrange; ranges
+ * are split recursively so that idle workers can steal large pieces.
+ * Returns when all subranges are done.
+ */
+void parallelFor( int first, int last, int grain,
+                  void (* body)( int first_index, int last_index,
+                                 void * context ),
+                  void * context );
+
+/**
+ * Stops and joins the worker threads and deallocates their deques
+ */
+void deallocateTasks( void );
+
+#endif
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
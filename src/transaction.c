@@ -0,0 +1,136 @@
+/**
+ * @file transaction.c
+ * @brief Implementation of the undo log for tentative changes to node
+ * positions and crossing counts.
+ *
+ * The log is a single growing array of entries; a checkpoint is simply an
+ * index into it. Rolling back to a checkpoint replays the entries after it
+ * in reverse order, applying the inverse of each change.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#include"graph.h"
+#include"transaction.h"
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<assert.h>
+
+typedef enum { POSITION_CHANGE, CROSSINGS_CHANGE } Change;
+
+typedef struct undo_entry {
+  Change kind;
+  /** for POSITION_CHANGE: the node and its position before the change */
+  Nodeptr node;
+  int position;
+  /** for CROSSINGS_CHANGE: the two edges involved and the amount added */
+  Edgeptr edge_one;
+  Edgeptr edge_two;
+  int diff;
+} * UndoEntryptr;
+
+int transaction_depth = 0;
+
+static struct undo_entry * undo_log = NULL;
+static int log_size = 0;
+static int log_capacity = 0;
+
+static UndoEntryptr next_entry( void )
+{
+  if ( log_size >= log_capacity ) {
+    log_capacity = log_capacity == 0 ? CAPACITY_INCREMENT : 2 * log_capacity;
+    undo_log = (struct undo_entry *)
+      realloc( undo_log, log_capacity * sizeof(struct undo_entry) );
+  }
+  return & undo_log[ log_size++ ];
+}
+
+int beginTransaction( void )
+{
+  transaction_depth++;
+  return log_size;
+}
+
+int checkpoint( void )
+{
+  return log_size;
+}
+
+/**
+ * applies the inverse of a crossings change, mirrors update_crossings() in
+ * crossing_utilities.c
+ */
+static void undo_crossings_change( UndoEntryptr entry )
+{
+  Edgeptr edge_one = entry->edge_one;
+  Edgeptr edge_two = entry->edge_two;
+  int diff = entry->diff;
+  edge_one->crossings -= diff;
+  edge_two->crossings -= diff;
+  edge_one->up_node->down_crossings -= diff;
+  edge_two->up_node->down_crossings -= diff;
+  edge_one->down_node->up_crossings -= diff;
+  edge_two->down_node->up_crossings -= diff;
+}
+
+static void undo_position_change( UndoEntryptr entry )
+{
+  Nodeptr node = entry->node;
+  layers[ node->layer ]->nodes[ entry->position ] = node;
+  node->position = entry->position;
+  LAYER_CHANGED( node->layer );
+}
+
+void rollbackTo( int checkpoint )
+{
+  assert( checkpoint >= 0 && checkpoint <= log_size );
+  while ( log_size > checkpoint ) {
+    UndoEntryptr entry = & undo_log[ --log_size ];
+    if ( entry->kind == CROSSINGS_CHANGE )
+      undo_crossings_change( entry );
+    else
+      undo_position_change( entry );
+  }
+}
+
+void commitTransaction( int start )
+{
+  assert( transaction_depth > 0 );
+  assert( start <= log_size );
+  transaction_depth--;
+  if ( transaction_depth == 0 ) log_size = 0;
+}
+
+void abortTransaction( int start )
+{
+  rollbackTo( start );
+  commitTransaction( start );
+}
+
+void logPositionChange( Nodeptr node )
+{
+  UndoEntryptr entry = next_entry();
+  entry->kind = POSITION_CHANGE;
+  entry->node = node;
+  entry->position = node->position;
+}
+
+void logCrossingsChange( Edgeptr edge_one, Edgeptr edge_two, int diff )
+{
+  UndoEntryptr entry = next_entry();
+  entry->kind = CROSSINGS_CHANGE;
+  entry->edge_one = edge_one;
+  entry->edge_two = edge_two;
+  entry->diff = diff;
+}
+
+void deallocateTransactions( void )
+{
+  free( undo_log );
+  undo_log = NULL;
+  log_size = log_capacity = 0;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
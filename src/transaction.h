@@ -0,0 +1,89 @@
+/**
+ * @file transaction.h
+ * @brief Undo log for tentative changes to node positions and crossing
+ * counts, so that an exploratory sequence of moves can be rolled back in
+ * time proportional to the number of changes rather than by physically
+ * sweeping the nodes back.
+ *
+ * Usage:
+ * <pre>
+ *   int start = beginTransaction();
+ *   ... tentative swaps / crossing updates ...
+ *   int mark = checkpoint();
+ *   ... more ...
+ *   rollbackTo( mark );           // undo everything after mark
+ *   rollbackTo( start );          // undo everything
+ *   commitTransaction( start );   // keep whatever has not been undone
+ * </pre>
+ * Transactions may be nested; only when the outermost transaction is
+ * committed is the log discarded.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/18
+ */
+
+#ifndef TRANSACTION_H
+#define TRANSACTION_H
+
+#include<stdbool.h>
+
+#include"graph.h"
+
+/**
+ * Number of transactions currently open; changes are logged only when this
+ * is positive. Exposed so that the logging hooks in the inner loops cost a
+ * single test when no transaction is open.
+ */
+extern int transaction_depth;
+
+/**
+ * Opens a (possibly nested) transaction.
+ * @return a checkpoint representing the state at the start of the transaction
+ */
+int beginTransaction( void );
+
+/**
+ * @return a checkpoint representing the current state; changes made after
+ * this point can be undone with rollbackTo()
+ */
+int checkpoint( void );
+
+/**
+ * Undoes, in reverse order, all changes logged since the given checkpoint
+ * was taken.
+ */
+void rollbackTo( int checkpoint );
+
+/**
+ * Closes the innermost transaction, keeping all changes that have not been
+ * rolled back. If this is the outermost transaction, the log is discarded.
+ * @param start the checkpoint returned by the matching beginTransaction()
+ */
+void commitTransaction( int start );
+
+/**
+ * Rolls back to the start of the innermost transaction and closes it.
+ */
+void abortTransaction( int start );
+
+/**
+ * Records the current position of the node so that it (and the
+ * corresponding slot in its layer) can be restored on rollback. Must be
+ * called <em>before</em> node->position is changed.
+ */
+void logPositionChange( Nodeptr node );
+
+/**
+ * Records that the crossing counts of edge_one, edge_two and their endpoints
+ * have been changed by diff; see update_crossings() in crossing_utilities.c
+ */
+void logCrossingsChange( Edgeptr edge_one, Edgeptr edge_two, int diff );
+
+/**
+ * Deallocates the undo log
+ */
+void deallocateTransactions( void );
+
+#endif
+
+/*  [Last modified: 2026 10 18 at 12:00:00 GMT] */
@@ -0,0 +1,100 @@
+/**
+ * @file verticality.c
+ * @brief Implementation of the non-verticality objective and its
+ * incremental per-channel maintenance.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include<stdio.h>
+#include<stdlib.h>
+#include<stdbool.h>
+
+#include"graph.h"
+#include"defs.h"
+#include"heuristics.h"
+#include"channel.h"
+#include"random.h"
+#include"verticality.h"
+
+typedef struct channel_verticality_struct {
+  /** true if total is valid for the versions recorded */
+  bool known;
+  double total;
+  unsigned int upper_version;
+  unsigned int lower_version;
+} * ChannelVerticalityptr;
+
+/**
+ * total non-verticality of each channel (indexed by its upper layer),
+ * allocated when first needed
+ */
+static ChannelVerticalityptr channel_verticality = NULL;
+
+double nonverticality( Edgeptr e )
+{
+  double offset = e->up_node->position - e->down_node->position;
+  return offset * offset;
+}
+
+/**
+ * @return the total non-verticality of the edges of channel i, i.e.,
+ * between layers i-1 and i, recomputed only if one of the layers changed
+ */
+static double channel_nonverticality( int i )
+{
+  ChannelVerticalityptr channel = & channel_verticality[i];
+  unsigned int upper_version = layers[i]->version;
+  unsigned int lower_version = layers[i - 1]->version;
+  if ( channel->known
+       && channel->upper_version == upper_version
+       && channel->lower_version == lower_version )
+    return channel->total;
+  double total = 0.0;
+  for ( int j = 0; j < channels[i]->number_of_edges; j++ )
+    total += nonverticality( channels[i]->edges[j] );
+  channel->total = total;
+  channel->upper_version = upper_version;
+  channel->lower_version = lower_version;
+  channel->known = true;
+  return total;
+}
+
+double totalNonverticality( void )
+{
+  if ( channel_verticality == NULL )
+    channel_verticality
+      = (ChannelVerticalityptr)
+      calloc( number_of_layers, sizeof(struct channel_verticality_struct) );
+  double total = 0.0;
+  for ( int i = 1; i < number_of_layers; i++ )
+    total += channel_nonverticality( i );
+  return total;
+}
+
+Edgeptr maxNonverticalityEdge( void )
+{
+  Edgeptr max_edge = NULL;
+  double max_nonverticality = -1.0;
+  if ( randomize_order ) {
+    genrand_permute( master_edge_list, number_of_edges, sizeof(Edgeptr) );
+  }
+  for ( int i = 0; i < number_of_edges; i++ ) {
+    Edgeptr edge = master_edge_list[i];
+    double current = nonverticality( edge );
+    if ( current > max_nonverticality && ! isFixedEdge( edge ) ) {
+      max_nonverticality = current;
+      max_edge = edge;
+    }
+  }
+  return max_edge;
+}
+
+void deallocateNonverticality( void )
+{
+  free( channel_verticality );
+  channel_verticality = NULL;
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
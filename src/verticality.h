@@ -0,0 +1,46 @@
+/**
+ * @file verticality.h
+ * @brief Non-verticality of edges, as in the vertical objective of
+ * ilp/sgf2ilp.py: the non-verticality of edge vw is
+ *      ( p(v) - p(w) )^2
+ * where p(x) is the position of x on its layer, and the total
+ * non-verticality is the sum over all edges.
+ *
+ * The total of each channel is kept together with the versions of its two
+ * layers (see graph.h), so that totalNonverticality() recomputes only the
+ * channels with a layer that changed since the last call.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef VERTICALITY_H
+#define VERTICALITY_H
+
+#include"graph.h"
+
+/**
+ * @return the non-verticality of edge e
+ */
+double nonverticality( Edgeptr e );
+
+/**
+ * @return the total non-verticality of all edges
+ */
+double totalNonverticality( void );
+
+/**
+ * @return the edge with maximum non-verticality among edges that have not
+ * been fixed, NULL if all are fixed
+ */
+Edgeptr maxNonverticalityEdge( void );
+
+/**
+ * Forgets the channel totals; must be called when the layers are replaced
+ * or renumbered
+ */
+void deallocateNonverticality( void );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
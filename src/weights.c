@@ -0,0 +1,78 @@
+/**
+ * @file weights.c
+ * @brief Implementation of the weight adjustments of the barycenter
+ * heuristic.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#include"weights.h"
+
+/**
+ * Gives each weight of -1 the weight of its left neighbor, or 0 if all
+ * weights to the left are -1.
+ * Note: If the weight to the left is -1 originally, it will have been
+ * changed by the time the current one is processed.
+ */
+static void adjust_weights_left( double * weights, int number_of_weights )
+{
+  for ( int i = 0; i < number_of_weights; i++ )
+    {
+      if ( weights[i] == -1 )
+        {
+          if ( i == 0 ) weights[i] = 0;
+          else weights[i] = weights[i-1];
+        }
+    }
+}
+
+/**
+ * Gives each weight of -1 the average of its two neighbors - or just the
+ * weight of one of the neighbors if the other is absent or also -1.
+ */
+static void adjust_weights_avg( double * weights, int number_of_weights )
+{
+  for ( int i = 0; i < number_of_weights; i++ ) {
+    // Do nothing if node already has a weight
+    if ( weights[i] != -1 ) continue;
+
+    double left_weight = -1;
+    double right_weight = -1;
+    if ( i > 0 ) {
+      left_weight = weights[i-1];
+    }
+    if ( i < number_of_weights - 1 ) {
+      right_weight = weights[i+1];
+    }
+
+    // if both neighbors are present and have weights, take the
+    // average of their weights
+    if ( left_weight != -1 && right_weight != -1 ) {
+      weights[i] = (left_weight + right_weight) / 2;
+    }
+    else if ( left_weight != -1 ) {
+      // only the left neighbor has a weight
+      weights[i] = left_weight;
+    }
+    else if ( right_weight != -1 ) {
+      // only the right neighbor has a weight
+      weights[i] = right_weight;
+    }
+    else {
+      // neither neighbor has a weight: can propagate from left
+      weights[i] = left_weight;
+    }
+  }
+}
+
+void adjustWeights( double * weights, int number_of_weights,
+                    enum adjust_weights_enum adjustment )
+{
+  if ( adjustment == LEFT )
+    adjust_weights_left( weights, number_of_weights );
+  else if ( adjustment == AVG )
+    adjust_weights_avg( weights, number_of_weights );
+}
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
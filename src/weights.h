@@ -0,0 +1,29 @@
+/**
+ * @file weights.h
+ * @brief Adjustment of the weights of nodes that have no neighbors on the
+ * side the weights are based on; shared by barycenter.c and compressed.c.
+ *
+ * @author Matt Stallmann
+ * @date 2026/10/19
+ */
+
+#ifndef WEIGHTS_H
+#define WEIGHTS_H
+
+#include"defs.h"
+
+/**
+ * Gives each weight of -1 (a node with no edges in the desired direction)
+ * a value based on its neighbors in the array, as selected by the
+ * adjustment: LEFT, the weight of the left neighbor, 0 for the first one;
+ * AVG, the average of the weights of the two neighbors, or just one of them
+ * if the other is absent or also -1; NONE leaves the weights unchanged.
+ *
+ * @param weights the weights of the nodes of a layer, in order of position
+ */
+void adjustWeights( double * weights, int number_of_weights,
+                    enum adjust_weights_enum adjustment );
+
+#endif
+
+/*  [Last modified: 2026 10 19 at 12:00:00 GMT] */
@@ -77,6 +77,22 @@ for dot_file in TestData/*.dot; do
         >> $output_file 2>&1
     echo "" >> $output_file
 
+    # scoring the graph's own order (-S) must give its starting values
+    echo "### $executable -S $ord_file $dot_file $ord_file"
+    echo "### $executable -S $ord_file $dot_file $ord_file, $date" >> $output_file
+    scored=`$executable -S $ord_file $dot_file $ord_file 2> /dev/null \
+        | grep "^1,"`
+    start=`$executable $dot_file $ord_file 2> /dev/null \
+        | grep -E "^Start(Crossings|BottleneckCrossings|Stretch|BottleneckStretch)," \
+        | cut -d, -f2 | paste -s -d, -`
+    if [ "$scored" = "1,$start" ]; then
+        echo "ScoreOwnOrder,ok" >> $output_file
+    else
+        echo "*** -S on $ord_file gives $scored, expected 1,$start"
+        echo "ScoreOwnOrder,MISMATCH,$scored,1,$start" >> $output_file
+    fi
+    echo "" >> $output_file
+
     echo "===================================================" \
         >> $output_file
     echo "" >> $output_file
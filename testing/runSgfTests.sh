@@ -5,6 +5,8 @@
 #   @date 2016/03/31
 
 executable=../src/minimization
+count_crossings=../src/count_crossings
+apply_delta=../src/apply_delta
 date=`date -u +"%F-%H%M"`
 if ! [ -d History ]; then
     mkdir History
@@ -22,12 +24,16 @@ tmp_next=/tmp/$$_next_sol
 # embedded in a comment at the start of execution, so beginning with ### is not an option
 tmp_last_nd=/tmp/$$_last_sol_nd
 tmp_next_nd=/tmp/$$_next_sol_nd
+# directory for the files written by the -w and -D checks
+work_dir=/tmp/$$_work
 
 if [ ! -e $executable ] || [ ! -x $executable ]; then
     echo "$executable not found or not executable"
     exit
 fi
 
+testing_dir=`pwd`
+
 echo "########## Testing minimization with sgf input, `date -u` ##########" >> $output_file
 for sgf_file in TestData/*.sgf; do
     echo "### running experiments with $sgf_file, $date"
@@ -68,6 +74,56 @@ for sgf_file in TestData/*.sgf; do
     $executable -p dfs -h mse -i 10000 -P s_t -z -R 81453 $sgf_file >> $output_file 2>&1
     echo "" >> $output_file
 
+    # count_crossings must agree with the starting values of minimization
+    echo "### $count_crossings $sgf_file"
+    echo "### $count_crossings $sgf_file, $date" >> $output_file
+    counted=`$count_crossings $sgf_file 2> /dev/null \
+        | grep -E "^(Crossings|BottleneckCrossings|Stretch|BottleneckStretch),"`
+    start=`$executable $sgf_file 2> /dev/null \
+        | grep -E "^Start(Crossings|BottleneckCrossings|Stretch|BottleneckStretch)," \
+        | sed 's/^Start//'`
+    if [ -n "$counted" ] && [ "$counted" = "$start" ]; then
+        echo "CountCrossings,ok" >> $output_file
+    else
+        echo "*** count_crossings on $sgf_file disagrees with minimization"
+        echo "CountCrossings,MISMATCH" >> $output_file
+    fi
+
+    # applying each delta written with -D to the input must give the sgf
+    # file written with -w for the same objective (up to comments and the
+    # order of the lines)
+    echo "### $executable -p dfs -h sifting -i 1000 -w _ [-D] $sgf_file"
+    echo "### $executable -p dfs -h sifting -i 1000 -w _ [-D] $sgf_file, $date" >> $output_file
+    rm -rf $work_dir
+    mkdir $work_dir
+    cp $sgf_file $work_dir
+    sgf_base=`basename $sgf_file`
+    (cd $work_dir \
+        && $testing_dir/$executable -p dfs -h sifting -i 1000 -w _ $sgf_base \
+        && $testing_dir/$executable -p dfs -h sifting -i 1000 -w _ -D $sgf_base) \
+        > /dev/null 2>&1
+    deltas=0
+    mismatches=0
+    for delta_file in $work_dir/*.delta; do
+        [ -e $delta_file ] || continue
+        deltas=$((deltas + 1))
+        $apply_delta $sgf_file $delta_file 2> /dev/null | grep -v "^c" | sort \
+            > $work_dir/applied
+        grep -v "^c" ${delta_file%.delta}.sgf | sort > $work_dir/written
+        if ! cmp -s $work_dir/applied $work_dir/written; then
+            echo "*** $delta_file does not give ${delta_file%.delta}.sgf"
+            mismatches=$((mismatches + 1))
+        fi
+    done
+    if [ $deltas -gt 0 ] && [ $mismatches -eq 0 ]; then
+        echo "DeltaRoundTrip,ok,$deltas" >> $output_file
+    else
+        echo "*** -D round trip failed for $sgf_file"
+        echo "DeltaRoundTrip,MISMATCH,$mismatches,$deltas" >> $output_file
+    fi
+    rm -rf $work_dir
+    echo "" >> $output_file
+
     echo "===================================================" \
         >> $output_file
     echo "" >> $output_file